@@ -0,0 +1,63 @@
+#include "blokady.h"
+#include "histogram.h"
+
+#include <cerrno>
+
+void blokada_init(Blokada* b) {
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&b->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    b->wejscia.store(0);
+    b->spory.store(0);
+    b->przejecia.store(0);
+}
+
+// Właściciel zginął z blokadą: przejmujemy ją jako spójną
+static void po_wejsciu(Blokada* b, int wynik) {
+    if (wynik != EOWNERDEAD) return;
+    pthread_mutex_consistent(&b->mutex);
+    b->przejecia.fetch_add(1, std::memory_order_relaxed);
+}
+
+void blokada_wez(Blokada* b) {
+    b->wejscia.fetch_add(1, std::memory_order_relaxed);
+    int wynik = pthread_mutex_trylock(&b->mutex);
+    if (wynik != EBUSY) {
+        po_wejsciu(b, wynik);
+        b->t_wejscia_ns = hist_teraz_ns();
+        return;
+    }
+    b->spory.fetch_add(1, std::memory_order_relaxed);
+    uint64_t t0 = hist_teraz_ns();
+    po_wejsciu(b, pthread_mutex_lock(&b->mutex));
+    b->t_wejscia_ns = hist_teraz_ns();
+    hist_zapisz(HIST_BLOKADA_CZEKANIE, b->t_wejscia_ns - t0);
+}
+
+void blokada_oddaj(Blokada* b) {
+    hist_zapisz(HIST_BLOKADA_TRZYMANIE, hist_teraz_ns() - b->t_wejscia_ns);
+    pthread_mutex_unlock(&b->mutex);
+}
+
+void sekwencja_zapis_poczatek(Sekwencja* s) {
+    s->licznik.store(s->licznik.load(std::memory_order_relaxed) | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+}
+
+void sekwencja_zapis_koniec(Sekwencja* s) {
+    s->licznik.store(s->licznik.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+uint32_t sekwencja_odczyt_poczatek(const Sekwencja* s) {
+    uint32_t v;
+    while ((v = s->licznik.load(std::memory_order_acquire)) & 1) {}
+    return v;
+}
+
+bool sekwencja_odczyt_ok(const Sekwencja* s, uint32_t poczatek) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s->licznik.load(std::memory_order_relaxed) == poczatek;
+}
@@ -0,0 +1,53 @@
+#ifndef BLOKADY_H
+#define BLOKADY_H
+
+#include <atomic>
+#include <cstdint>
+#include <pthread.h>
+
+// =============================================================
+// =======  BLOKADY WSPÓŁDZIELONE Z LICZNIKIEM RYWALIZACJI  ====
+// =============================================================
+//
+// Mutex między procesami (PTHREAD_PROCESS_SHARED) we własnej linii
+// cache. Bez rywalizacji wejście nie robi wywołania systemowego.
+// Licznik "spory" mówi, ile razy trzeba było czekać na innego;
+// czasy czekania i trzymania trafiają do histogramów (histogram.h).
+//
+// Mutex jest odporny na śmierć właściciela (PTHREAD_MUTEX_ROBUST):
+// blokadę zabitego procesu dostaje następny chętny, zamiast czekać
+// w nieskończoność. Chronione dane mogą zostać w połowie zmiany -
+// zasoby zabitego samolotu oddaje nadzorca (ODZYSK, main.cpp).
+
+struct alignas(64) Blokada {
+    pthread_mutex_t mutex;
+    std::atomic<long long> wejscia;
+    std::atomic<long long> spory;
+    std::atomic<long long> przejecia; // Wejścia po zmarłym właścicielu
+    uint64_t t_wejscia_ns;          // Pisze tylko właściciel blokady
+};
+
+void blokada_init(Blokada* b);
+void blokada_wez(Blokada* b);
+void blokada_oddaj(Blokada* b);
+
+// =============================================================
+// =======  SEKWENCJA (seqlock)  ===============================
+// =============================================================
+//
+// Dla danych z jednym piszącym naraz (właściciel slotu albo ten, kto
+// trzyma blokadę). Nieparzysty licznik = zapis w toku; czytelnik nie
+// blokuje piszącego, tylko ponawia odczyt, gdy licznik się zmienił.
+// Zapis zaczęty przez zabity proces (licznik został nieparzysty)
+// domyka następny zapis.
+
+struct Sekwencja {
+    std::atomic<uint32_t> licznik;
+};
+
+void sekwencja_zapis_poczatek(Sekwencja* s);
+void sekwencja_zapis_koniec(Sekwencja* s);
+uint32_t sekwencja_odczyt_poczatek(const Sekwencja* s);
+bool sekwencja_odczyt_ok(const Sekwencja* s, uint32_t poczatek);
+
+#endif
@@ -0,0 +1,132 @@
+#include "dziennik.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+const char* const NAZWY_KOLUMN[LICZBA_KOLUMN] = {
+    "id", "kierunek", "pas_ladowania", "pas_startu", "bramka", "cysterna", "pasazerowie", "paliwo",
+    "t_przylot", "t_ladowanie", "t_bramka", "t_cysterna", "t_start", "t_odlot",
+};
+
+const uint32_t SZEROKOSCI_KOLUMN[LICZBA_KOLUMN] = {
+    4, 2, 2, 2, 2, 2, 4, 4,
+    8, 8, 8, 8, 8, 8,
+};
+
+// Mapa całej rezerwacji (DZIENNIK_MAX_BLOKOW), dziedziczona przez fork
+static void* baza = nullptr;
+static int fd_dziennika = -1;
+
+bool dziennik_otworz(const char* plik, const char* scenariusz, unsigned ziarno, int pojemnosc, int kierunki,
+                     const char* const* nazwy_kierunkow) {
+    fd_dziennika = open(plik, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd_dziennika == -1) { perror(plik); return false; }
+
+    // Kolumny w bloku po kolei, każda od granicy linii pamięci podręcznej
+    uint64_t rozmiar_bloku = 0;
+    uint64_t przesuniecia[LICZBA_KOLUMN];
+    for (int k = 0; k < LICZBA_KOLUMN; k++) {
+        przesuniecia[k] = rozmiar_bloku;
+        rozmiar_bloku += ((uint64_t)SZEROKOSCI_KOLUMN[k] * DZIENNIK_BLOK + 63) & ~63ULL;
+    }
+
+    size_t mapa = DZIENNIK_NAGLOWEK + rozmiar_bloku * DZIENNIK_MAX_BLOKOW;
+    int blad = posix_fallocate(fd_dziennika, 0, DZIENNIK_NAGLOWEK + 2 * rozmiar_bloku);
+    if (blad != 0) { fprintf(stderr, "%s: %s\n", plik, strerror(blad)); return false; }
+    baza = mmap(nullptr, mapa, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_NORESERVE, fd_dziennika, 0);
+    if (baza == MAP_FAILED) { perror("mmap"); baza = nullptr; return false; }
+
+    NaglowekDziennika* n = (NaglowekDziennika*)baza;
+    memcpy(n->magia, DZIENNIK_MAGIA, sizeof(DZIENNIK_MAGIA));
+    n->wersja = DZIENNIK_WERSJA;
+    n->rekordy_w_bloku = DZIENNIK_BLOK;
+    n->rozmiar_bloku = rozmiar_bloku;
+    n->liczba_kolumn = LICZBA_KOLUMN;
+    for (int k = 0; k < LICZBA_KOLUMN; k++) {
+        strncpy(n->kolumny[k].nazwa, NAZWY_KOLUMN[k], sizeof(n->kolumny[k].nazwa) - 1);
+        n->kolumny[k].szerokosc = SZEROKOSCI_KOLUMN[k];
+        n->kolumny[k].przesuniecie = przesuniecia[k];
+    }
+    strncpy(n->scenariusz, scenariusz, sizeof(n->scenariusz) - 1);
+    n->ziarno = ziarno;
+    n->pojemnosc = pojemnosc;
+    n->kierunki = kierunki;
+    for (int i = 0; i < kierunki && i < 256; i++) {
+        strncpy(n->nazwy_kierunkow[i], nazwy_kierunkow[i], sizeof(n->nazwy_kierunkow[i]) - 1);
+    }
+    n->zarezerwowane.store(0, std::memory_order_relaxed);
+    n->bloki.store(2, std::memory_order_release);
+    return true;
+}
+
+template<typename T>
+static void zapisz(int blok, int k, uint64_t i, T wartosc) {
+    ((T*)dziennik_kolumna(baza, blok, k))[i] = wartosc;
+}
+
+void dziennik_dopisz(const RekordLotu& r) {
+    if (baza == nullptr) return;
+    NaglowekDziennika* n = (NaglowekDziennika*)baza;
+    uint64_t numer = n->zarezerwowane.fetch_add(1, std::memory_order_relaxed);
+    uint64_t blok = numer / DZIENNIK_BLOK;
+    uint64_t i = numer % DZIENNIK_BLOK;
+    if (blok >= DZIENNIK_MAX_BLOKOW) {
+        n->utracone.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Pierwszy rekord bloku dokłada następny (fallocate nie skraca pliku,
+    // gdy spóźniony piszący przyjdzie po następnym); reszta czeka na swój blok
+    if (i == 0 && blok + 2 <= DZIENNIK_MAX_BLOKOW) {
+        uint64_t chce = blok + 2;
+        int blad = posix_fallocate(fd_dziennika, 0, DZIENNIK_NAGLOWEK + chce * n->rozmiar_bloku);
+        if (blad != 0) {
+            fprintf(stderr, "Dziennik: posix_fallocate: %s\n", strerror(blad));
+            n->pelny.store(1, std::memory_order_relaxed);
+        } else {
+            uint64_t jest = n->bloki.load(std::memory_order_relaxed);
+            while (jest < chce && !n->bloki.compare_exchange_weak(jest, chce, std::memory_order_release)) {}
+        }
+    }
+    while (n->bloki.load(std::memory_order_acquire) <= blok) {
+        if (n->pelny.load(std::memory_order_relaxed)) {
+            n->utracone.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        sched_yield();
+    }
+
+    int b = (int)blok;
+    zapisz<int16_t>(b, KOL_KIERUNEK, i, r.kierunek);
+    zapisz<int16_t>(b, KOL_PAS_LADOWANIA, i, r.pas_ladowania);
+    zapisz<int16_t>(b, KOL_PAS_STARTU, i, r.pas_startu);
+    zapisz<int16_t>(b, KOL_BRAMKA, i, r.bramka);
+    zapisz<int16_t>(b, KOL_CYSTERNA, i, r.cysterna);
+    zapisz<int32_t>(b, KOL_PASAZEROWIE, i, r.pasazerowie);
+    zapisz<int32_t>(b, KOL_PALIWO, i, r.paliwo);
+    zapisz<int64_t>(b, KOL_T_PRZYLOT, i, r.t_przylot);
+    zapisz<int64_t>(b, KOL_T_LADOWANIE, i, r.t_ladowanie);
+    zapisz<int64_t>(b, KOL_T_BRAMKA, i, r.t_bramka);
+    zapisz<int64_t>(b, KOL_T_CYSTERNA, i, r.t_cysterna);
+    zapisz<int64_t>(b, KOL_T_START, i, r.t_start);
+    zapisz<int64_t>(b, KOL_T_ODLOT, i, r.t_odlot);
+    // id na końcu: czytający w trakcie przebiegu pomija rekordy z id == 0
+    std::atomic_thread_fence(std::memory_order_release);
+    zapisz<int32_t>(b, KOL_ID, i, r.id);
+}
+
+void dziennik_zamknij(int64_t koniec_us) {
+    if (baza == nullptr) return;
+    NaglowekDziennika* n = (NaglowekDziennika*)baza;
+    n->koniec_us = koniec_us;
+    uint64_t utracone = n->utracone.load();
+    if (utracone > 0) fprintf(stderr, "Dziennik: pominieto %llu lotow (brak miejsca)\n", (unsigned long long)utracone);
+    munmap(baza, DZIENNIK_NAGLOWEK + n->rozmiar_bloku * DZIENNIK_MAX_BLOKOW);
+    close(fd_dziennika);
+    baza = nullptr;
+    fd_dziennika = -1;
+}
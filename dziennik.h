@@ -0,0 +1,111 @@
+#ifndef DZIENNIK_H
+#define DZIENNIK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// =============================================================
+// =======  DZIENNIK LOTÓW (--flight-log=PLIK)  ================
+// =============================================================
+//
+// Plik tylko do dopisywania, zmapowany MAP_SHARED przed fork: każdy
+// odlot to jeden rekord o stałej szerokości, zapisany wprost do mapy
+// (bez bufora; jedyne wywołanie systemowe to posix_fallocate raz na
+// blok). Rekordy leżą w blokach kolumnowych: blok to DZIENNIK_BLOK wartości każdej
+// kolumny po kolei, więc zapytanie czyta tylko potrzebne kolumny,
+// ciągłymi tablicami. Nagłówek opisuje kolumny (nazwa, szerokość,
+// przesunięcie w bloku) i przebieg.
+//
+// Rezerwacja rekordu to fetch_add na liczniku w nagłówku; id (różne
+// od 0) zapisywane na końcu oznacza rekord kompletny. Plik rośnie
+// blokami z wyprzedzeniem jednego bloku.
+
+#define DZIENNIK_MAGIA "SO2DZLT"
+#define DZIENNIK_WERSJA 1
+#define DZIENNIK_BLOK 65536                 // Rekordy w bloku
+#define DZIENNIK_NAGLOWEK 8192              // Bajty przed pierwszym blokiem
+#define DZIENNIK_MAX_BLOKOW 16384           // ~10^9 lotów, tyle rezerwuje mapa
+
+enum KolumnaDziennika {
+    KOL_ID = 0,             // int32
+    KOL_KIERUNEK,           // int16
+    KOL_PAS_LADOWANIA,      // int16
+    KOL_PAS_STARTU,         // int16
+    KOL_BRAMKA,             // int16
+    KOL_CYSTERNA,           // int16
+    KOL_PASAZEROWIE,        // int32
+    KOL_PALIWO,             // int32, litry
+    KOL_T_PRZYLOT,          // int64, us symulacji
+    KOL_T_LADOWANIE,
+    KOL_T_BRAMKA,
+    KOL_T_CYSTERNA,
+    KOL_T_START,
+    KOL_T_ODLOT,
+    LICZBA_KOLUMN
+};
+
+extern const char* const NAZWY_KOLUMN[LICZBA_KOLUMN];
+extern const uint32_t SZEROKOSCI_KOLUMN[LICZBA_KOLUMN];
+
+struct RekordLotu {
+    int32_t id;
+    int16_t kierunek;
+    int16_t pas_ladowania;
+    int16_t pas_startu;
+    int16_t bramka;
+    int16_t cysterna;
+    int32_t pasazerowie;
+    int32_t paliwo;
+    int64_t t_przylot;
+    int64_t t_ladowanie;
+    int64_t t_bramka;
+    int64_t t_cysterna;
+    int64_t t_start;
+    int64_t t_odlot;
+};
+
+struct OpisKolumny {
+    char nazwa[20];
+    uint32_t szerokosc;
+    uint64_t przesuniecie;          // Od początku bloku
+};
+
+struct NaglowekDziennika {
+    char magia[8];
+    uint32_t wersja;
+    uint32_t rekordy_w_bloku;
+    uint64_t rozmiar_bloku;
+    uint32_t liczba_kolumn;
+    OpisKolumny kolumny[LICZBA_KOLUMN];
+
+    // Przebieg (do raportu zapytań)
+    char scenariusz[52];
+    uint32_t ziarno;
+    int32_t pojemnosc;              // Miejsca w samolocie
+    int32_t kierunki;
+    char nazwy_kierunkow[256][8];
+    int64_t koniec_us;              // Czas symulacji przy zamknięciu (0 = trwa)
+
+    alignas(64) std::atomic<uint64_t> zarezerwowane;    // Rekordy przydzielone piszącym
+    alignas(64) std::atomic<uint64_t> bloki;            // Bloki z miejscem w pliku
+    std::atomic<uint64_t> utracone;                     // Ponad DZIENNIK_MAX_BLOKOW albo brak miejsca
+    std::atomic<int> pelny;                             // Plik nie urósł (np. pełny dysk)
+};
+
+static_assert(sizeof(NaglowekDziennika) <= DZIENNIK_NAGLOWEK, "nagłówek dziennika za duży");
+
+// Kolumna k bloku b zmapowanego dziennika
+inline void* dziennik_kolumna(void* baza, int blok, int k) {
+    const NaglowekDziennika* n = (const NaglowekDziennika*)baza;
+    return (char*)baza + DZIENNIK_NAGLOWEK + (uint64_t)blok * n->rozmiar_bloku + n->kolumny[k].przesuniecie;
+}
+
+// --- ZAPIS (symulacja) ---
+// Nowy plik z nagłówkiem przebiegu; false = błąd (komunikat na stderr)
+bool dziennik_otworz(const char* plik, const char* scenariusz, unsigned ziarno, int pojemnosc, int kierunki,
+                     const char* const* nazwy_kierunkow);
+void dziennik_dopisz(const RekordLotu& r);           // Bez otwartego dziennika nic nie robi
+void dziennik_zamknij(int64_t koniec_us);
+
+#endif
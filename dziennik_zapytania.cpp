@@ -0,0 +1,236 @@
+// Zapytania do dziennika lotów (--flight-log=PLIK): przepustowość na
+// godzinę, załadunek na kierunek, percentyle czasu obsługi i średnie
+// czasy faz. Czyta tylko potrzebne kolumny, blok po bloku.
+//
+// Uzycie: dziennik_zapytania PLIK [--from=S] [--to=S] [--per-hour]
+
+#include "dziennik.h"
+#include "histogram.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#define GODZINA_US 3600000000LL
+
+enum FazaLotu {
+    FAZA_KRAZENIE = 0,      // Przylot -> lądowanie
+    FAZA_DO_BRAMKI,         // Lądowanie -> bramka
+    FAZA_DO_CYSTERNY,       // Bramka -> cysterna (obsługa przed tankowaniem)
+    FAZA_DO_STARTU,         // Cysterna -> pas do startu
+    FAZA_START,             // Pas do startu -> odlot
+    LICZBA_FAZ
+};
+
+static const char* const NAZWY_FAZ[LICZBA_FAZ] = {
+    "krazenie", "ladowanie -> bramka", "bramka -> cysterna", "cysterna -> start", "start",
+};
+
+// Kolumny faz: czas początku i końca
+static const int GRANICE_FAZ[LICZBA_FAZ][2] = {
+    { KOL_T_PRZYLOT, KOL_T_LADOWANIE },
+    { KOL_T_LADOWANIE, KOL_T_BRAMKA },
+    { KOL_T_BRAMKA, KOL_T_CYSTERNA },
+    { KOL_T_CYSTERNA, KOL_T_START },
+    { KOL_T_START, KOL_T_ODLOT },
+};
+
+struct Zestawienie {
+    uint64_t loty = 0;
+    int64_t suma_obslugi = 0;
+    int64_t max_obslugi = 0;
+    int64_t suma_faz[LICZBA_FAZ] = {};
+    std::vector<uint64_t> na_godzine;
+    std::vector<uint64_t> loty_kierunku;
+    std::vector<uint64_t> pasazerowie_kierunku;
+    uint64_t kubelki[HIST_KUBELKI] = {};
+};
+
+static bool sprawdz_naglowek(const NaglowekDziennika* n, size_t rozmiar, const char* plik) {
+    if (rozmiar < DZIENNIK_NAGLOWEK || memcmp(n->magia, DZIENNIK_MAGIA, sizeof(DZIENNIK_MAGIA)) != 0) {
+        fprintf(stderr, "%s: to nie jest dziennik lotow\n", plik);
+        return false;
+    }
+    if (n->wersja != DZIENNIK_WERSJA || n->liczba_kolumn != LICZBA_KOLUMN || n->rekordy_w_bloku == 0) {
+        fprintf(stderr, "%s: dziennik w wersji %u, obslugiwana %d\n", plik, n->wersja, DZIENNIK_WERSJA);
+        return false;
+    }
+    for (int k = 0; k < LICZBA_KOLUMN; k++) {
+        if (n->kolumny[k].szerokosc != SZEROKOSCI_KOLUMN[k] || strcmp(n->kolumny[k].nazwa, NAZWY_KOLUMN[k]) != 0) {
+            fprintf(stderr, "%s: nieznany uklad kolumny %d (%s)\n", plik, k, n->kolumny[k].nazwa);
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T>
+static const T* kolumna(void* baza, int blok, int k) {
+    return (const T*)dziennik_kolumna(baza, blok, k);
+}
+
+// Jeden blok: pętle po maskach bez rozgałęzień (wektoryzowane przez
+// kompilator), potem jedna pętla rozrzucająca do godzin, kierunków
+// i kubełków histogramu
+static void skanuj_blok(void* baza, int blok, int m, int64_t od_us, int64_t do_us, Zestawienie& z,
+                        std::vector<int64_t>& maska, std::vector<int64_t>& obsluga) {
+    const int32_t* id = kolumna<int32_t>(baza, blok, KOL_ID);
+    const int64_t* przylot = kolumna<int64_t>(baza, blok, KOL_T_PRZYLOT);
+    const int64_t* odlot = kolumna<int64_t>(baza, blok, KOL_T_ODLOT);
+
+    // Maska: -1 dla kompletnego lotu z odlotem w zakresie, inaczej 0
+    int64_t* w = maska.data();
+    int64_t* o = obsluga.data();
+    int64_t liczba = 0, suma = 0, max = 0;
+    for (int j = 0; j < m; j++) {
+        w[j] = -(int64_t)((id[j] != 0) & (odlot[j] >= od_us) & (odlot[j] < do_us));
+        o[j] = (odlot[j] - przylot[j]) & w[j];
+        liczba -= w[j];
+        suma += o[j];
+        max = o[j] > max ? o[j] : max;
+    }
+    if (liczba == 0) return;
+    z.loty += liczba;
+    z.suma_obslugi += suma;
+    if (max > z.max_obslugi) z.max_obslugi = max;
+
+    for (int f = 0; f < LICZBA_FAZ; f++) {
+        const int64_t* poczatek = kolumna<int64_t>(baza, blok, GRANICE_FAZ[f][0]);
+        const int64_t* koniec = kolumna<int64_t>(baza, blok, GRANICE_FAZ[f][1]);
+        int64_t s = 0;
+        for (int j = 0; j < m; j++) s += (koniec[j] - poczatek[j]) & w[j];
+        z.suma_faz[f] += s;
+    }
+
+    const int16_t* kierunek = kolumna<int16_t>(baza, blok, KOL_KIERUNEK);
+    const int32_t* pasazerowie = kolumna<int32_t>(baza, blok, KOL_PASAZEROWIE);
+    for (int j = 0; j < m; j++) {
+        if (w[j] == 0) continue;
+        size_t h = (size_t)(odlot[j] / GODZINA_US);
+        if (h >= z.na_godzine.size()) z.na_godzine.resize(h + 1, 0);
+        z.na_godzine[h]++;
+        size_t k = (size_t)kierunek[j];
+        if (k < z.loty_kierunku.size()) {
+            z.loty_kierunku[k]++;
+            z.pasazerowie_kierunku[k] += pasazerowie[j];
+        }
+        z.kubelki[hist_kubelek((uint64_t)o[j])]++;
+    }
+}
+
+static double percentyl_s(const Zestawienie& z, double p) {
+    uint64_t prog = (uint64_t)(z.loty * p / 100.0 + 0.999999);
+    if (prog == 0) prog = 1;
+    uint64_t narastajaco = 0;
+    for (int k = 0; k < HIST_KUBELKI; k++) {
+        narastajaco += z.kubelki[k];
+        if (narastajaco >= prog) {
+            uint64_t v = hist_granica_kubelka(k);
+            return (v > (uint64_t)z.max_obslugi ? z.max_obslugi : v) / 1e6;
+        }
+    }
+    return z.max_obslugi / 1e6;
+}
+
+int main(int argc, char** argv) {
+    const char* plik = nullptr;
+    int64_t od_us = 0, do_us = INT64_MAX;
+    bool na_godzine = false;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (strncmp(a, "--from=", 7) == 0) od_us = atoll(a + 7) * 1000000LL;
+        else if (strncmp(a, "--to=", 5) == 0) do_us = atoll(a + 5) * 1000000LL;
+        else if (strcmp(a, "--per-hour") == 0) na_godzine = true;
+        else if (a[0] != '-' && plik == nullptr) plik = a;
+        else { plik = nullptr; break; }
+    }
+    if (plik == nullptr) {
+        fprintf(stderr, "Uzycie: %s PLIK [--from=S] [--to=S] [--per-hour]\n", argv[0]);
+        fprintf(stderr, "  PLIK         dziennik z SO2 --flight-log=PLIK\n");
+        fprintf(stderr, "  --from/--to  tylko odloty z [S1, S2) sekund symulacji\n");
+        fprintf(stderr, "  --per-hour   odloty w kazdej godzinie\n");
+        return 1;
+    }
+
+    int fd = open(plik, O_RDONLY);
+    if (fd == -1) { perror(plik); return 1; }
+    struct stat st;
+    if (fstat(fd, &st) == -1) { perror(plik); return 1; }
+    size_t rozmiar = (size_t)st.st_size;
+    void* baza = mmap(nullptr, rozmiar, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (baza == MAP_FAILED) { perror("mmap"); return 1; }
+    const NaglowekDziennika* n = (const NaglowekDziennika*)baza;
+    if (!sprawdz_naglowek(n, rozmiar, plik)) return 1;
+
+    // W trakcie przebiegu plik może być krótszy niż rezerwacje
+    uint64_t bloki_w_pliku = (rozmiar - DZIENNIK_NAGLOWEK) / n->rozmiar_bloku;
+    uint64_t rekordy = n->zarezerwowane.load();
+    if (rekordy > bloki_w_pliku * n->rekordy_w_bloku) rekordy = bloki_w_pliku * n->rekordy_w_bloku;
+    int kierunki = n->kierunki > 0 && n->kierunki <= 256 ? n->kierunki : 0;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    Zestawienie z;
+    z.loty_kierunku.assign(kierunki, 0);
+    z.pasazerowie_kierunku.assign(kierunki, 0);
+    std::vector<int64_t> maska(n->rekordy_w_bloku), obsluga(n->rekordy_w_bloku);
+    for (uint64_t b = 0; b * n->rekordy_w_bloku < rekordy; b++) {
+        uint64_t m = rekordy - b * n->rekordy_w_bloku;
+        if (m > n->rekordy_w_bloku) m = n->rekordy_w_bloku;
+        skanuj_blok(baza, (int)b, (int)m, od_us, do_us, z, maska, obsluga);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double skan_s = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+
+    printf("Dziennik:        %s (%s, ziarno %u)\n", plik, n->scenariusz, n->ziarno);
+    printf("Loty:            %llu z %llu zapisanych%s\n", (unsigned long long)z.loty, (unsigned long long)rekordy,
+           n->koniec_us == 0 ? " (przebieg trwa)" : "");
+    if (z.loty == 0) return 0;
+
+    // Pełne godziny: całe w zakresie i przed końcem przebiegu
+    size_t h_od = (size_t)((od_us + GODZINA_US - 1) / GODZINA_US);
+    size_t h_do = z.na_godzine.size();
+    if (do_us != INT64_MAX && (size_t)(do_us / GODZINA_US) < h_do) h_do = (size_t)(do_us / GODZINA_US);
+    if (n->koniec_us > 0 && (size_t)(n->koniec_us / GODZINA_US) < h_do) h_do = (size_t)(n->koniec_us / GODZINA_US);
+    if (h_do > h_od) {
+        uint64_t min = UINT64_MAX, max = 0, suma = 0;
+        for (size_t h = h_od; h < h_do; h++) {
+            suma += z.na_godzine[h];
+            if (z.na_godzine[h] < min) min = z.na_godzine[h];
+            if (z.na_godzine[h] > max) max = z.na_godzine[h];
+        }
+        printf("Przepustowosc:   srednio %.1f / h, min %llu, max %llu (%zu pelnych godzin)\n",
+               (double)suma / (h_do - h_od), (unsigned long long)min, (unsigned long long)max, h_do - h_od);
+    }
+    printf("Czas obslugi:    srednio %.1f s, p50 %.1f s, p90 %.1f s, p99 %.1f s, max %.1f s\n",
+           z.suma_obslugi / 1e6 / z.loty, percentyl_s(z, 50), percentyl_s(z, 90), percentyl_s(z, 99),
+           z.max_obslugi / 1e6);
+    printf("Fazy (srednio):\n");
+    for (int f = 0; f < LICZBA_FAZ; f++) printf("  %-22s %10.1f s\n", NAZWY_FAZ[f], z.suma_faz[f] / 1e6 / z.loty);
+
+    printf("Zaladunek wg kierunku (pojemnosc %d):\n", n->pojemnosc);
+    printf("  %-8s %12s %14s %10s\n", "kierunek", "loty", "pasazerowie", "zaladunek");
+    for (int k = 0; k < kierunki; k++) {
+        if (z.loty_kierunku[k] == 0) continue;
+        printf("  %-8s %12llu %14llu %9.1f%%\n", n->nazwy_kierunkow[k], (unsigned long long)z.loty_kierunku[k],
+               (unsigned long long)z.pasazerowie_kierunku[k],
+               n->pojemnosc > 0 ? 100.0 * z.pasazerowie_kierunku[k] / ((double)z.loty_kierunku[k] * n->pojemnosc) : 0.0);
+    }
+
+    if (na_godzine) {
+        printf("Odloty na godzine:\n");
+        for (size_t h = 0; h < z.na_godzine.size(); h++) {
+            printf("  %6zu %10llu\n", h, (unsigned long long)z.na_godzine[h]);
+        }
+    }
+    printf("Skanowanie:      %.3f s (%.1f mln lotow / s)\n", skan_s, skan_s > 0 ? rekordy / skan_s / 1e6 : 0.0);
+    munmap(baza, rozmiar);
+    return 0;
+}
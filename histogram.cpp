@@ -0,0 +1,145 @@
+#include "histogram.h"
+
+#include <ctime>
+
+const char* const NAZWY_METRYK[LICZBA_METRYK] = {
+    "ladowanie - czekanie",
+    "start - czekanie",
+    "pas - zajecie",
+    "bramka - czekanie",
+    "bramka - zajecie",
+    "cysterna - czekanie",
+    "cysterna - zajecie",
+    "krazenie",
+    "pasazer - czekanie",
+    "paliwo - czekanie",
+    "obsluga (przylot-odlot)",
+    "blokady - czekanie",
+    "blokady - trzymanie",
+};
+
+static TabelaHistogramow* tabela = nullptr;
+static int moj_shard = 0;
+
+int hist_kubelek(uint64_t v) {
+    if (v < HIST_PODKUBELKI) return (int)v;
+    int e = 63 - __builtin_clzll(v);                     // >= 4
+    int k = (e - 3) * HIST_PODKUBELKI + (int)((v >> (e - 4)) & (HIST_PODKUBELKI - 1));
+    return k < HIST_KUBELKI ? k : HIST_KUBELKI - 1;
+}
+
+uint64_t hist_granica_kubelka(int k) {
+    if (k < HIST_PODKUBELKI) return (uint64_t)k;
+    int e = k / HIST_PODKUBELKI + 3;
+    uint64_t sub = (uint64_t)(k % HIST_PODKUBELKI);
+    return ((HIST_PODKUBELKI + sub + 1) << (e - 4)) - 1;
+}
+
+void hist_podlacz(TabelaHistogramow* t) {
+    tabela = t;
+}
+
+void hist_wybierz_shard(int numer) {
+    moj_shard = (numer < 0 ? -numer : numer) % HIST_SHARDY;
+}
+
+void hist_zapisz_w(Histogram* h, uint64_t wartosc) {
+    h->liczba.fetch_add(1, std::memory_order_relaxed);
+    h->suma.fetch_add(wartosc, std::memory_order_relaxed);
+    h->kubelki[hist_kubelek(wartosc)].fetch_add(1, std::memory_order_relaxed);
+    uint64_t m = h->max.load(std::memory_order_relaxed);
+    while (wartosc > m && !h->max.compare_exchange_weak(m, wartosc, std::memory_order_relaxed)) {}
+}
+
+void hist_zapisz(int metryka, uint64_t wartosc) {
+    if (tabela == nullptr) return;
+    hist_zapisz_w(&tabela->shardy[moj_shard][metryka], wartosc);
+}
+
+// Zsumowanie histogramów (szard jednej metryki albo jednego samodzielnego)
+static PodsumowanieHistogramu podsumuj(const Histogram* const* histogramy, int ile) {
+    PodsumowanieHistogramu p = {};
+    uint64_t suma_kubelkow[HIST_KUBELKI] = {};
+    uint64_t suma = 0;
+    for (int s = 0; s < ile; s++) {
+        const Histogram& h = *histogramy[s];
+        uint64_t n = h.liczba.load(std::memory_order_relaxed);
+        if (n == 0) continue;
+        p.liczba += n;
+        suma += h.suma.load(std::memory_order_relaxed);
+        uint64_t m = h.max.load(std::memory_order_relaxed);
+        if (m > p.max) p.max = m;
+        for (int k = 0; k < HIST_KUBELKI; k++) suma_kubelkow[k] += h.kubelki[k].load(std::memory_order_relaxed);
+    }
+    if (p.liczba == 0) return p;
+    p.srednia = (double)suma / p.liczba;
+
+    // Kubełki mogą być o kilka zapisów przed licznikiem - liczymy od ich sumy
+    uint64_t wszystkie = 0;
+    for (int k = 0; k < HIST_KUBELKI; k++) wszystkie += suma_kubelkow[k];
+    uint64_t prog50 = (wszystkie * 50 + 99) / 100;
+    uint64_t prog99 = (wszystkie * 99 + 99) / 100;
+    uint64_t narastajaco = 0;
+    bool jest50 = false;
+    for (int k = 0; k < HIST_KUBELKI; k++) {
+        narastajaco += suma_kubelkow[k];
+        if (!jest50 && narastajaco >= prog50) { p.p50 = hist_granica_kubelka(k); jest50 = true; }
+        if (narastajaco >= prog99) { p.p99 = hist_granica_kubelka(k); break; }
+    }
+    if (p.p50 > p.max) p.p50 = p.max;
+    if (p.p99 > p.max) p.p99 = p.max;
+    return p;
+}
+
+PodsumowanieHistogramu hist_podsumuj(int metryka) {
+    if (tabela == nullptr) return PodsumowanieHistogramu{};
+    const Histogram* szardy[HIST_SHARDY];
+    for (int s = 0; s < HIST_SHARDY; s++) szardy[s] = &tabela->shardy[s][metryka];
+    return podsumuj(szardy, HIST_SHARDY);
+}
+
+PodsumowanieHistogramu hist_podsumuj_w(const Histogram* h) {
+    return podsumuj(&h, 1);
+}
+
+uint64_t hist_liczba(int metryka) {
+    if (tabela == nullptr) return 0;
+    uint64_t n = 0;
+    for (int s = 0; s < HIST_SHARDY; s++) n += tabela->shardy[s][metryka].liczba.load(std::memory_order_relaxed);
+    return n;
+}
+
+static uint64_t dopisz_do_skrotu(uint64_t skrot, uint64_t v) {
+    for (int b = 0; b < 8; b++) {
+        skrot ^= (v >> (8 * b)) & 0xFF;
+        skrot *= 0x100000001B3ULL;
+    }
+    return skrot;
+}
+
+uint64_t hist_skrot(int metryka, uint64_t skrot) {
+    if (tabela == nullptr) return skrot;
+    uint64_t liczba = 0, suma = 0, max = 0;
+    for (int s = 0; s < HIST_SHARDY; s++) {
+        const Histogram& h = tabela->shardy[s][metryka];
+        liczba += h.liczba.load(std::memory_order_relaxed);
+        suma += h.suma.load(std::memory_order_relaxed);
+        uint64_t m = h.max.load(std::memory_order_relaxed);
+        if (m > max) max = m;
+    }
+    skrot = dopisz_do_skrotu(skrot, liczba);
+    skrot = dopisz_do_skrotu(skrot, suma);
+    skrot = dopisz_do_skrotu(skrot, max);
+    for (int k = 0; k < HIST_KUBELKI; k++) {
+        uint64_t n = 0;
+        for (int s = 0; s < HIST_SHARDY; s++) n += tabela->shardy[s][metryka].kubelki[k].load(std::memory_order_relaxed);
+        skrot = dopisz_do_skrotu(skrot, n);
+    }
+    return skrot;
+}
+
+uint64_t hist_teraz_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
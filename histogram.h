@@ -0,0 +1,81 @@
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <atomic>
+#include <cstdint>
+
+// =============================================================
+// =======  HISTOGRAMY CZASÓW OCZEKIWANIA I ZAJĘCIA  ===========
+// =============================================================
+//
+// Kubełki logarytmiczno-liniowe (jak HDR): 16 podkubełków na każdą
+// potęgę dwójki, błąd względny ~6%. Zapis to kilka atomowych dodawań
+// bez blokad i bez wywołań systemowych. Każdy proces pisze do swojej
+// "szardy" (wybieranej po pid), odczyt sumuje wszystkie szardy.
+
+#define HIST_SHARDY 32
+#define HIST_PODKUBELKI 16
+#define HIST_KUBELKI 720          // Do 2^47 jednostek
+
+enum MetrykaHistogramu {
+    HIST_LADOWANIE_CZEKANIE = 0,  // Kolejka wieży do lądowania  [us symulacji]
+    HIST_START_CZEKANIE,          // Kolejka wieży do startu     [us symulacji]
+    HIST_PAS_ZAJETY,              // Zajęcie pasa                [us symulacji]
+    HIST_BRAMKA_CZEKANIE,         // sem_p(SEM_GATE)             [us symulacji]
+    HIST_BRAMKA_ZAJETA,           // Zajęcie bramki              [us symulacji]
+    HIST_CYSTERNA_CZEKANIE,       // sem_p(SEM_CYSTERNA)         [us symulacji]
+    HIST_CYSTERNA_ZAJETA,         // Zajęcie cysterny            [us symulacji]
+    HIST_KRAZENIE,                // Przylot -> lądowanie        [us symulacji]
+    HIST_PASAZER_CZEKANIE,        // Terminal -> boarding (--pax-records) [us symulacji]
+    HIST_PALIWO_CZEKANIE,         // Pusty magazyn, do dostawy   [us symulacji]
+    HIST_OBSLUGA,                 // Przylot -> odlot            [us symulacji]
+    HIST_BLOKADA_CZEKANIE,        // Czekanie na blokadę (spór)  [ns rzeczywiste]
+    HIST_BLOKADA_TRZYMANIE,       // Trzymanie blokady           [ns rzeczywiste]
+    LICZBA_METRYK
+};
+
+struct alignas(64) Histogram {
+    std::atomic<uint64_t> liczba;
+    std::atomic<uint64_t> suma;
+    std::atomic<uint64_t> max;
+    std::atomic<uint64_t> kubelki[HIST_KUBELKI];
+};
+
+struct TabelaHistogramow {
+    Histogram shardy[HIST_SHARDY][LICZBA_METRYK];
+};
+
+struct PodsumowanieHistogramu {
+    uint64_t liczba;
+    double srednia;
+    uint64_t p50;
+    uint64_t p99;
+    uint64_t max;
+};
+
+extern const char* const NAZWY_METRYK[LICZBA_METRYK];
+
+void hist_podlacz(TabelaHistogramow* t);
+void hist_wybierz_shard(int numer);       // Po fork(), np. numer = getpid()
+
+void hist_zapisz(int metryka, uint64_t wartosc);
+PodsumowanieHistogramu hist_podsumuj(int metryka);
+
+// Samodzielny histogram poza tabelą (np. w kolejce kierunku), bez szard
+void hist_zapisz_w(Histogram* h, uint64_t wartosc);
+PodsumowanieHistogramu hist_podsumuj_w(const Histogram* h);
+uint64_t hist_liczba(int metryka);        // Tanie: same liczniki szard
+
+// Kubełek wartości i jego górna granica (wartość raportowana jako
+// percentyl) - dla zliczeń poza Histogram, np. w dziennik_zapytania
+int hist_kubelek(uint64_t v);
+uint64_t hist_granica_kubelka(int k);
+
+// Skrót FNV-1a zawartości metryki (suma szard), dopisany do skrot;
+// nie zależy od podziału zapisów między szardy
+uint64_t hist_skrot(int metryka, uint64_t skrot);
+
+// Czas rzeczywisty do pomiaru blokad (vDSO, bez wywołania systemowego)
+uint64_t hist_teraz_ns();
+
+#endif
@@ -0,0 +1,24 @@
+#include "losowanie.h"
+
+#define ZLOTY_PODZIAL 0x9E3779B97F4A7C15ULL
+
+// Finalizator SplitMix64: bijekcja o dobrym rozproszeniu bitów
+static uint64_t wymieszaj(uint64_t x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+void los_init(Losowanie* l, uint64_t ziarno, int strumien, uint64_t encja) {
+    l->klucz = wymieszaj(ziarno * ZLOTY_PODZIAL ^ wymieszaj(((uint64_t)strumien << 48) ^ encja));
+    l->licznik = 0;
+}
+
+uint64_t los_64(Losowanie* l) {
+    return wymieszaj(l->klucz + ++l->licznik * ZLOTY_PODZIAL);
+}
+
+// Mnożenie zamiast modulo (Lemire); obciążenie < n / 2^32 pomijalne
+int los_ponizej(Losowanie* l, int n) {
+    return (int)(((los_64(l) >> 32) * (uint64_t)n) >> 32);
+}
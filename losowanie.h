@@ -0,0 +1,33 @@
+#ifndef LOSOWANIE_H
+#define LOSOWANIE_H
+
+#include <cstdint>
+
+// =============================================================
+// =======  LOSOWANIE LICZNIKOWE (ziarno, strumień, encja)  ====
+// =============================================================
+//
+// Zamiast wspólnego stanu rand(): każda losowana wartość to funkcja
+// (ziarno przebiegu, strumień, numer encji, numer losowania), liczona
+// mieszaniem SplitMix64. Wynik nie zależy od pid, kolejności procesów
+// ani od tego, kto losował wcześniej; stan to dwa słowa na stosie,
+// więc nie trzeba go dzielić między procesami ani wątkami.
+
+enum StrumienLosowania {
+    LOS_SAMOLOT = 1,        // Encja: numer samolotu
+    LOS_TERMINAL,           // Encja: numer taktu pętli głównej
+    LOS_AWARIE,             // Encja: numer taktu pętli głównej
+};
+
+struct Losowanie {
+    uint64_t klucz;
+    uint64_t licznik;       // Numer następnego losowania
+};
+
+void los_init(Losowanie* l, uint64_t ziarno, int strumien, uint64_t encja);
+
+uint64_t los_64(Losowanie* l);
+// Równomiernie z [0, n), n > 0
+int los_ponizej(Losowanie* l, int n);
+
+#endif
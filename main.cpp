@@ -1,5 +1,8 @@
 #include <iostream>
+#include <deque>
+#include <unordered_map>
 #include <vector>
+#include <cerrno>
 #include <cstring>
 #include <csignal>
 #include <unistd.h>
@@ -8,104 +11,487 @@
 #include <sys/sem.h>
 #include <sys/types.h>
 #include <sys/wait.h>
+#include <sys/prctl.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
+#include <sys/ioctl.h>
+#include <linux/futex.h>
 #include <ncurses.h>
 #include <ctime>
 #include <cstdlib>
 #include <algorithm>
 #include <clocale>
+#include <climits>
+#include <sched.h>
+
+#include "blokady.h"
+#include "histogram.h"
+#include "losowanie.h"
+#include "paliwo.h"
+#include "pasazerowie.h"
+#include "przydzial.h"
+#include "segment.h"
+#include "slad.h"
+#include "sloty.h"
+#include "symulacja.h"
+#include "wieza.h"
+#include "dziennik.h"
+#include "siec.h"
+#include "zdarzenia.h"
+#include "zegar.h"
 
 // =============================================================
 // =======   STAŁE MAKSYMALNE (Limity tablic)  =================
 // =============================================================
 
-#define MAX_RUNWAYS 5
-#define MAX_GATES 10
-#define MAX_TANKERS 5
+// Pasy, bramki i cysterny są rozmiarowane na starcie (do SLOTY_MAX każde)
+#define DOMYSLNE_CYSTERNY 5
+#define DOMYSLNE_KIERUNKI 4
+#define DOMYSLNE_KOLOWANIE 4
 
 #define FUEL_MAX 20000
-#define FUEL_NEEDED 600
 #define FUEL_DELIVERY 6000
 #define DELIVERY_TIME 12
 
-#define LOG_HISTORY_SIZE 22
-
-// Klucze IPC
-#define SHM_KEY 77793
-#define SEM_KEY 88903
-
-#define SEM_PAS 0
-#define SEM_GATE 1
-#define SEM_CYSTERNA 2
-#define MUTEX_ZASOBY 3
+// Ile pozycji mieści ekran; reszta jest zliczana w wierszu "+N"
+#define EKRAN_MAX_PASOW 5
+#define EKRAN_MAX_CYSTERN 5
+#define EKRAN_MAX_BRAMEK 10
+#define EKRAN_MAX_KIERUNKOW 8
 
+// Pierwsze cztery kierunki mają nazwy stron świata, kolejne D05, D06, ...
 const char KIERUNKI_NAZWY[] = {'N', 'E', 'S', 'W'};
 
 // =============================================================
 // =======  PAMIĘĆ WSPÓŁDZIELONA Z KONFIGURACJĄ  ===============
 // =============================================================
 
-struct SharedData {
-    // --- KONFIGURACJA (Ustawiana na starcie) ---
-    int cfg_runways;        // Aktywne pasy
-    int cfg_gates;          // Aktywne bramki
-    int cfg_spawn_rate;     // Co ile cykli nowy samolot
-    int cfg_pax_rate;       // Szansa na pasażera %
-    int cfg_boarding_time;  // Czas postoju
-    int cfg_plane_capacity; // Pojemność samolotu
-    int cfg_landing_time;   // Czas na pasie (mikrosekundy)
-    char scenariusz_nazwa[50]; // Nazwa do wyświetlania
-
-    // --- STAN SYMULACJI ---
-    int paliwo_w_magazynie;
-    time_t nastepna_dostawa;
-    int aktywne_samoloty;   // Licznik samolotów w systemie
-
-    // Tablice o stałym rozmiarze MAX
-    int pasy_startowe[MAX_RUNWAYS];
-    int stanowiska_gate[MAX_GATES];
-    int cysterny_status[MAX_TANKERS];
-
-    int pasazerowie_w_terminalu[4]; // N, E, S, W
-
-    // Informacje o samolotach w bramkach
-    int gate_kierunek[MAX_GATES];
-    int gate_liczba_pasazerow[MAX_GATES];
-
-    // Logi
-    char historia_logow[LOG_HISTORY_SIZE][60];
-    int log_index;
+// Parametry nadpisywalne z linii poleceń (kolejność jak w ParametrId).
+// Kolumna w_biegu: zmiana w trakcie przebiegu (zmien_w_biegu); pozostałe
+// wyznaczają układ segmentu albo rachunek, który musi się domknąć
+const ParametrKonfiguracji PARAMETRY[LICZBA_PARAMETROW] = {
+    { "runways",       &Konfiguracja::cfg_runways,        1, SLOTY_MAX, true },
+    { "gates",         &Konfiguracja::cfg_gates,          1, SLOTY_MAX, true },
+    { "tankers",       &Konfiguracja::cfg_tankers,        1, SLOTY_MAX, true },
+    { "directions",    &Konfiguracja::cfg_kierunki,       1, MAX_KIERUNKOW, false },
+    { "spawn-rate",    &Konfiguracja::cfg_spawn_rate,     1, 100000, true },
+    { "pax-rate",      &Konfiguracja::cfg_pax_rate,       0, 100, true },
+    { "boarding-time", &Konfiguracja::cfg_boarding_time,  0, 3600, true },
+    { "capacity",      &Konfiguracja::cfg_plane_capacity, 1, 100000, false },
+    { "landing-time",  &Konfiguracja::cfg_landing_time,   0, 600000000, true },
+    { "taxiway",       &Konfiguracja::cfg_kolowanie,      0, SLOTY_MAX, false },
+    { "divert-after",  &Konfiguracja::cfg_przekierowanie, 0, 86400, true },
+    { "ground-ops",    &Konfiguracja::cfg_obsluga_rownolegla, 0, 1, false },
+    { "cleaning-time", &Konfiguracja::cfg_sprzatanie,     0, 3600, true },
+    { "catering-time", &Konfiguracja::cfg_catering,       0, 3600, true },
+    { "runway-policy", &Konfiguracja::cfg_polityka_pasow, 0, LICZBA_POLITYK - 1, false },
+    { "runway-batch",  &Konfiguracja::cfg_paczka_pasow,   1, 1000, false },
+    { "takeoff-time",  &Konfiguracja::cfg_czas_startu,    0, 600000000, true },
+    { "pax-records",   &Konfiguracja::cfg_rekordy_pasazerow, 0, 1, false },
+    { "direction-policy", &Konfiguracja::cfg_przydzial_kierunkow, 0, LICZBA_POLITYK_PRZYDZIALU - 1, true },
+    { "fuel-delivery", &Konfiguracja::cfg_dostawa_paliwa, 1, FUEL_MAX, true },
+    { "delivery-time", &Konfiguracja::cfg_czas_dostawy,   1, 86400, true },
+    { "engine",        &Konfiguracja::cfg_silnik,         0, LICZBA_SILNIKOW - 1, false },
+    { "max-runways",   &Konfiguracja::cfg_max_pasow,      0, SLOTY_MAX, false },
+    { "max-gates",     &Konfiguracja::cfg_max_bramek,     0, SLOTY_MAX, false },
+    { "max-tankers",   &Konfiguracja::cfg_max_cystern,    0, SLOTY_MAX, false },
+    { "kill-every",    &Konfiguracja::cfg_zabijanie,      0, 86400, true },
 };
 
+int znajdz_parametr(const char* nazwa, size_t dlugosc) {
+    for (int i = 0; i < LICZBA_PARAMETROW; i++) {
+        if (strlen(PARAMETRY[i].nazwa) == dlugosc && strncmp(PARAMETRY[i].nazwa, nazwa, dlugosc) == 0) return i;
+    }
+    return -1;
+}
+
 int shmid = -1;
+pid_t pid_zapisu_sladu = -1;
 int semid = -1;
 SharedData* shared_memory = nullptr;
 
+// Wpis bieżącego procesu w rejestrze (segment.h); bez wpisu atrapa
+RejestrProcesu atrapa_wpisu;
+RejestrProcesu* moj_wpis = &atrapa_wpisu;
+
+// SEM_UNDO w procesach obsługi (po_fork_w_dziecku): jednostki bramek,
+// cystern i kołowania zabitego procesu oddaje jądro, także tę, którą
+// semop przekazał mu, zanim zdążył wrócić i wpisać ją do rejestru.
+// Nadzorca zmienia liczbę jednostek na stałe (zmiany w biegu).
+short flaga_jednostek = 0;
+
+// =============================================================
+// =======  UKŁAD SEGMENTU (rozmiar zależny od konfiguracji)  ==
+// =============================================================
+
+size_t wyrownaj_do_linii(size_t x) {
+    return (x + 63) & ~(size_t)63;
+}
+
+// Wylicza offsety tablic rekordów i całkowity rozmiar segmentu
+// (pasy, bramki i cysterny: zainstalowane, ustal_zainstalowane;
+// procesy obsługi: ustal_pojemnosc).
+// Z d == nullptr tylko rozmiar (przed utworzeniem segmentu - SharedData
+// z histogramami jest za duży, żeby budować go na stosie).
+// Pierścienie śladu (kilka MB) są w segmencie tylko z --trace.
+size_t oblicz_uklad(const Konfiguracja& cfg, bool slad, int procesy, SharedData* d) {
+    size_t off_pasy = wyrownaj_do_linii(sizeof(SharedData));
+    size_t off_bramki = wyrownaj_do_linii(off_pasy + sizeof(RekordPasa) * cfg.cfg_max_pasow);
+    size_t off_cysterny = wyrownaj_do_linii(off_bramki + sizeof(RekordBramki) * cfg.cfg_max_bramek);
+    size_t off_kierunki = wyrownaj_do_linii(off_cysterny + sizeof(RekordCysterny) * cfg.cfg_max_cystern);
+    size_t off_rejestr = wyrownaj_do_linii(off_kierunki + sizeof(KierunekTerminalu) * cfg.cfg_kierunki);
+    size_t off_zgloszenia = wyrownaj_do_linii(off_rejestr + sizeof(RejestrProcesu) * procesy);
+    size_t off_zegar = wyrownaj_do_linii(off_zgloszenia + sizeof(ZgloszeniePasa) * procesy);
+    size_t off_kolejki = wyrownaj_do_linii(off_zegar + zegar_rozmiar_tablic(procesy + UCZESTNICY_NADZORU));
+    size_t off_arena = off_kolejki;
+    size_t off_slad = off_kolejki;
+    if (cfg.cfg_rekordy_pasazerow) {
+        off_arena = wyrownaj_do_linii(off_kolejki + sizeof(KolejkaPasazerow) * cfg.cfg_kierunki);
+        off_slad = wyrownaj_do_linii(off_arena + sizeof(Pasazer) * pasazerowie_pojemnosc(cfg.cfg_kierunki) * cfg.cfg_kierunki);
+    }
+    size_t rozmiar = slad ? wyrownaj_do_linii(off_slad + sizeof(BuforSladu)) : off_slad;
+    if (d != nullptr) {
+        d->off_pasy = off_pasy;
+        d->off_bramki = off_bramki;
+        d->off_cysterny = off_cysterny;
+        d->off_kierunki = off_kierunki;
+        d->off_rejestr = off_rejestr;
+        d->off_zgloszenia = off_zgloszenia;
+        d->off_zegar = off_zegar;
+        d->max_procesow = procesy;
+        d->off_kolejki = cfg.cfg_rekordy_pasazerow ? off_kolejki : 0;
+        d->off_arena = cfg.cfg_rekordy_pasazerow ? off_arena : 0;
+        d->off_slad = slad ? off_slad : 0;
+        d->rozmiar_segmentu = rozmiar;
+    }
+    return rozmiar;
+}
+
+RekordPasa& rekord_pasa(int i) {
+    return rekordy_segmentu<RekordPasa>(shared_memory, shared_memory->off_pasy)[i];
+}
+
+RekordBramki& rekord_bramki(int i) {
+    return rekordy_segmentu<RekordBramki>(shared_memory, shared_memory->off_bramki)[i];
+}
+
+RekordCysterny& rekord_cysterny(int i) {
+    return rekordy_segmentu<RekordCysterny>(shared_memory, shared_memory->off_cysterny)[i];
+}
+
+KierunekTerminalu& kierunek_terminalu(int i) {
+    return rekordy_segmentu<KierunekTerminalu>(shared_memory, shared_memory->off_kierunki)[i];
+}
+
+// Tylko z --pax-records
+KolejkaPasazerow& kolejka_pasazerow(int i) {
+    return rekordy_segmentu<KolejkaPasazerow>(shared_memory, shared_memory->off_kolejki)[i];
+}
+
+Pasazer* miejsca_pasazerow(int i) {
+    return (Pasazer*)((char*)shared_memory + shared_memory->off_arena) + pasazerowie_pojemnosc(shared_memory->cfg_kierunki) * i;
+}
+
+RejestrProcesu& rejestr_procesu(int i) {
+    return rekordy_segmentu<RejestrProcesu>(shared_memory, shared_memory->off_rejestr)[i];
+}
+
+BuforSladu* bufor_sladu() {
+    if (shared_memory->off_slad == 0) return nullptr;
+    return (BuforSladu*)((char*)shared_memory + shared_memory->off_slad);
+}
+
 // =============================================================
 // =======  NARZĘDZIA (Semafore, Logi, Cleanup)  ===============
 // =============================================================
 
+// Zlecenia puli (SEM_ZADANIA) nie są jednostkami procesu - bez SEM_UNDO
+static short flagi_semafora(int sem_num) {
+    return (sem_num == SEM_ZADANIA) ? 0 : flaga_jednostek;
+}
+
+// W trybie wirtualnym semafory obsługuje zegar (musi wiedzieć, kto czeka).
 void sem_p(int sem_num) {
-    struct sembuf s = { (unsigned short)sem_num, -1, 0 };
+    if (zegar_wirtualny()) { zegar_sem_p(sem_num); return; }
+    struct sembuf s = { (unsigned short)sem_num, -1, flagi_semafora(sem_num) };
     semop(semid, &s, 1);
 }
 
+// Czekanie najdłużej do terminu (czas symulacji); false = termin minął.
+// termin_us < 0: bez terminu, jak sem_p.
+bool sem_p_do(int sem_num, int64_t termin_us) {
+    if (termin_us < 0) { sem_p(sem_num); return true; }
+    if (zegar_wirtualny()) return zegar_sem_p_do(sem_num, termin_us);
+
+    struct sembuf s = { (unsigned short)sem_num, -1, flagi_semafora(sem_num) };
+    while (true) {
+        int64_t zostalo = zegar_realne_us(termin_us - zegar_teraz_us());
+        int wynik;
+        if (zostalo <= 0) {
+            s.sem_flg = IPC_NOWAIT | flagi_semafora(sem_num);
+            wynik = semop(semid, &s, 1);
+        } else {
+            struct timespec ts = { (time_t)(zostalo / 1000000), (long)(zostalo % 1000000) * 1000 };
+            wynik = semtimedop(semid, &s, 1, &ts);
+        }
+        if (wynik == 0) return true;
+        if (errno != EINTR) return false;
+    }
+}
+
 void sem_v(int sem_num) {
-    struct sembuf s = { (unsigned short)sem_num, 1, 0 };
+    if (zegar_wirtualny()) { zegar_sem_v(sem_num); return; }
+    struct sembuf s = { (unsigned short)sem_num, 1, flagi_semafora(sem_num) };
     semop(semid, &s, 1);
 }
 
-void dodaj_log(const char* format, int id, char kierunek, int pasazerowie, const char* status) {
-    sem_p(MUTEX_ZASOBY);
-    char bufor[60];
-    snprintf(bufor, 60, format, id, kierunek, pasazerowie, shared_memory->cfg_plane_capacity, status);
+// Jednostka bez czekania; false = brak wolnej
+bool sem_sprobuj(int sem_num) {
+    if (zegar_wirtualny()) return zegar_sem_sprobuj(sem_num);
+    struct sembuf s = { (unsigned short)sem_num, -1, (short)(IPC_NOWAIT | flagi_semafora(sem_num)) };
+    return semop(semid, &s, 1) == 0;
+}
+
+// Wzięta jednostka zostaje zajęta także po śmierci procesu (zamykana
+// bramka albo cysterna): +1 z SEM_UNDO i -1 bez niego w jednym semop
+// zeruje tylko poprawkę jądra, wartość semafora się nie zmienia
+void sem_zatrzymaj(int sem_num) {
+    if (zegar_wirtualny() || flagi_semafora(sem_num) == 0) return;
+    struct sembuf s[2] = { { (unsigned short)sem_num, 1, SEM_UNDO }, { (unsigned short)sem_num, -1, 0 } };
+    semop(semid, s, 2);
+}
+
+// Kopiec bramek czekających na cysternę (pod blokada_cystern)
+static bool cysterna_przed(int a, int b) {
+    const RekordBramki& ga = rekord_bramki(a);
+    const RekordBramki& gb = rekord_bramki(b);
+    return ga.cysterna_klucz < gb.cysterna_klucz ||
+           (ga.cysterna_klucz == gb.cysterna_klucz && ga.cysterna_numer < gb.cysterna_numer);
+}
+
+static void cysterna_na(int poz, int bramka) {
+    shared_memory->kolejka_cystern[poz] = bramka;
+    rekord_bramki(bramka).cysterna_poz = poz;
+}
+
+static void cysterna_w_gore(int poz) {
+    int* kolejka = shared_memory->kolejka_cystern;
+    int bramka = kolejka[poz];
+    while (poz > 0 && cysterna_przed(bramka, kolejka[(poz - 1) / 2])) {
+        cysterna_na(poz, kolejka[(poz - 1) / 2]);
+        poz = (poz - 1) / 2;
+    }
+    cysterna_na(poz, bramka);
+}
+
+static void cysterna_w_dol(int poz) {
+    int* kolejka = shared_memory->kolejka_cystern;
+    int n = shared_memory->czeka_cystern;
+    int bramka = kolejka[poz];
+    while (2 * poz + 1 < n) {
+        int dziecko = 2 * poz + 1;
+        if (dziecko + 1 < n && cysterna_przed(kolejka[dziecko + 1], kolejka[dziecko])) dziecko++;
+        if (!cysterna_przed(kolejka[dziecko], bramka)) break;
+        cysterna_na(poz, kolejka[dziecko]);
+        poz = dziecko;
+    }
+    cysterna_na(poz, bramka);
+}
+
+static void kolejka_cystern_usun(int bramka) {
+    int poz = rekord_bramki(bramka).cysterna_poz;
+    rekord_bramki(bramka).cysterna_poz = -1;
+    int ostatnia = shared_memory->kolejka_cystern[--shared_memory->czeka_cystern];
+    if (ostatnia == bramka) return;
+    cysterna_na(poz, ostatnia);
+    cysterna_w_gore(poz);
+    cysterna_w_dol(rekord_bramki(ostatnia).cysterna_poz);
+}
+
+// Cysterna dla samolotu przy bramce w --ground-ops: przy kolejce pierwsza
+// dostaje bramka najbliższa końca boardingu (cysterna jest wtedy na
+// ścieżce krytycznej), przy remisie wcześniej zgłoszona. Zwalniający
+// przekazuje cysternę wprost czekającemu.
+void cysterna_wez(int bramka, int64_t koniec_boardingu) {
+    if (zegar_wirtualny()) { zegar_sem_p_prio(SEM_CYSTERNA, koniec_boardingu); return; }
+
+    // Jednostka wzięta od razu albo przekazana (futex) - widać to w
+    // rejestrze i rekordzie bramki, gdyby samolot zginął w trakcie
+    RekordBramki& g = rekord_bramki(bramka);
+    g.cysterna_futex.store(0, std::memory_order_relaxed);
+    blokada_wez(&shared_memory->blokada_cystern);
+    if (shared_memory->cysterny_wolne > 0) {
+        shared_memory->cysterny_wolne--;
+        moj_wpis->jednostki |= JEDN_CYSTERNA;
+        blokada_oddaj(&shared_memory->blokada_cystern);
+        return;
+    }
+    g.cysterna_klucz = koniec_boardingu;
+    g.cysterna_numer = shared_memory->cysterny_bilety++;
+    cysterna_na(shared_memory->czeka_cystern, bramka);
+    cysterna_w_gore(shared_memory->czeka_cystern++);
+    blokada_oddaj(&shared_memory->blokada_cystern);
+
+    while (g.cysterna_futex.load(std::memory_order_acquire) == 0) {
+        syscall(SYS_futex, &g.cysterna_futex, FUTEX_WAIT, 0, nullptr, nullptr, 0);
+    }
+}
+
+void cysterna_oddaj() {
+    if (zegar_wirtualny()) { zegar_sem_v(SEM_CYSTERNA); return; }
+
+    blokada_wez(&shared_memory->blokada_cystern);
+    if (shared_memory->czeka_cystern == 0) {
+        shared_memory->cysterny_wolne++;
+    } else {
+        int najlepsza = shared_memory->kolejka_cystern[0];
+        RekordBramki& g = rekord_bramki(najlepsza);
+        kolejka_cystern_usun(najlepsza);
+        g.cysterna_futex.store(1, std::memory_order_release);
+        syscall(SYS_futex, &g.cysterna_futex, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+    blokada_oddaj(&shared_memory->blokada_cystern);
+}
+
+// Jednostka cysterny bez czekania, tą drogą, którą bierze ją samolot
+// (cysterna_wez w --ground-ops, inaczej semafor)
+bool cysterna_sprobuj() {
+    if (!shared_memory->cfg_obsluga_rownolegla || zegar_wirtualny()) return sem_sprobuj(SEM_CYSTERNA);
+    blokada_wez(&shared_memory->blokada_cystern);
+    bool jest = shared_memory->cysterny_wolne > 0;
+    if (jest) shared_memory->cysterny_wolne--;
+    blokada_oddaj(&shared_memory->blokada_cystern);
+    return jest;
+}
+
+void cysterna_jednostka_oddaj() {
+    if (shared_memory->cfg_obsluga_rownolegla) cysterna_oddaj();
+    else sem_v(SEM_CYSTERNA);
+}
+
+void zmien_panel(int panel) {
+    shared_memory->wersje_paneli[panel].wersja.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Zapisy stanu widocznego na ekranie (idx == -1: slot nie został zajęty)
+void ustaw_pas(int idx, int samolot) {
+    if (idx == -1) return;
+    rekord_pasa(idx).samolot.store(samolot, std::memory_order_relaxed);
+    zmien_panel(PANEL_PASY);
+}
+
+void ustaw_cysterne(int idx, int samolot) {
+    if (idx == -1) return;
+    rekord_cysterny(idx).samolot.store(samolot, std::memory_order_relaxed);
+    zmien_panel(PANEL_CYSTERNY);
+}
+
+void ustaw_bramke(int idx, int samolot, int kierunek, int pasazerowie) {
+    if (idx == -1) return;
+    RekordBramki& g = rekord_bramki(idx);
+    sekwencja_zapis_poczatek(&g.sekwencja);
+    g.samolot = samolot;
+    g.kierunek = kierunek;
+    g.pasazerowie = pasazerowie;
+    sekwencja_zapis_koniec(&g.sekwencja);
+    zmien_panel(PANEL_BRAMKI);
+}
+
+// Spójna kopia rekordu bramki dla ekranu
+struct StanBramki {
+    int samolot;
+    int kierunek;
+    int pasazerowie;
+};
+
+StanBramki odczytaj_bramke(int idx) {
+    const RekordBramki& g = rekord_bramki(idx);
+    StanBramki kopia;
+    uint32_t v;
+    do {
+        v = sekwencja_odczyt_poczatek(&g.sekwencja);
+        kopia.samolot = g.samolot;
+        kopia.kierunek = g.kierunek;
+        kopia.pasazerowie = g.pasazerowie;
+    } while (!sekwencja_odczyt_ok(&g.sekwencja, v));
+    return kopia;
+}
+
+void zapisz_log(const char* bufor) {
+    blokada_wez(&shared_memory->blokada_logow);
+    sekwencja_zapis_poczatek(&shared_memory->sekwencja_logow);
     int idx = shared_memory->log_index;
     strncpy(shared_memory->historia_logow[idx], bufor, 60);
     shared_memory->log_index = (idx + 1) % LOG_HISTORY_SIZE;
-    sem_v(MUTEX_ZASOBY);
+    sekwencja_zapis_koniec(&shared_memory->sekwencja_logow);
+    blokada_oddaj(&shared_memory->blokada_logow);
+    zmien_panel(PANEL_LOGI);
+}
+
+void dodaj_log(const char* format, int id, const char* kierunek, int pasazerowie, const char* status) {
+    char bufor[60];
+    snprintf(bufor, 60, format, id, kierunek, pasazerowie, shared_memory->cfg_plane_capacity, status);
+    zapisz_log(bufor);
+}
+
+// Maksimum atomowe (CAS, bez blokady)
+void atomic_max(std::atomic<long long>& cel, long long wartosc) {
+    long long stara = cel.load(std::memory_order_relaxed);
+    while (wartosc > stara && !cel.compare_exchange_weak(stara, wartosc)) {}
+}
+
+// Zamknięcie czekające na zwolnienie slotu (zmniejszona pojemność w biegu)
+static bool wez_zamkniecie(std::atomic<int>& do_zamkniecia) {
+    int n = do_zamkniecia.load(std::memory_order_relaxed);
+    while (n > 0 && !do_zamkniecia.compare_exchange_weak(n, n - 1)) {}
+    return n > 0;
+}
+
+// Zwalniana bramka/cysterna zostaje zamknięta zamiast wrócić do puli
+// (wtedy bez jednostki semafora); false = zwolnić zwyczajnie
+bool zamknij_zwalniana_bramke(int idx) {
+    if (!wez_zamkniecie(shared_memory->bramki_do_zamkniecia)) return false;
+    ustaw_bramke(idx, -1, -1, 0);
+    sloty_zwolnij(&shared_memory->zamkniete_bramki, idx);
+    return true;
+}
+
+bool zamknij_zwalniana_cysterne(int idx) {
+    if (!wez_zamkniecie(shared_memory->cysterny_do_zamkniecia)) return false;
+    ustaw_cysterne(idx, -1);
+    sloty_zwolnij(&shared_memory->zamkniete_cysterny, idx);
+    return true;
+}
+
+// Pobranie paliwa z magazynu (paliwo.h); przy braku czeka na dostawę.
+// Zwraca czas czekania [us symulacji].
+int64_t pobierz_paliwo(int ilosc) {
+    int64_t czekanie = magazyn_pobierz(&shared_memory->magazyn, ilosc);
+    zmien_panel(PANEL_PALIWO);
+    return czekanie;
+}
+
+// Zwraca stan magazynu po dostawie
+int dostarcz_paliwo(int ilosc) {
+    int stan = magazyn_dostarcz(&shared_memory->magazyn, ilosc);
+    zmien_panel(PANEL_PALIWO);
+    return stan;
+}
+
+// Koniec śladu: proces zapisu dopisuje to, co zostało w pierścieniach
+void zakoncz_slad() {
+    if (pid_zapisu_sladu == -1) return;
+    bufor_sladu()->koniec.store(1);
+    waitpid(pid_zapisu_sladu, nullptr, 0);
+    pid_zapisu_sladu = -1;
 }
 
 void cleanup(int signum) {
     endwin();
+    if (shared_memory != nullptr) zakoncz_slad();
+    if (shared_memory != nullptr) dziennik_zamknij(zegar_teraz_us());
     if (shared_memory != nullptr) shmdt(shared_memory);
     if (shmid != -1) shmctl(shmid, IPC_RMID, nullptr);
     if (semid != -1) semctl(semid, 0, IPC_RMID);
@@ -119,261 +505,699 @@ void cleanup(int signum) {
 
 void proces_dostawcy_paliwa() {
     while(true) {
-        shared_memory->nastepna_dostawa = time(NULL) + DELIVERY_TIME;
-        sleep(DELIVERY_TIME);
-        sem_p(MUTEX_ZASOBY);
-        shared_memory->paliwo_w_magazynie += FUEL_DELIVERY;
-        if (shared_memory->paliwo_w_magazynie > FUEL_MAX) shared_memory->paliwo_w_magazynie = FUEL_MAX;
-        sem_v(MUTEX_ZASOBY);
+        shared_memory->nastepna_dostawa = zegar_teraz_us() / 1000000 + shared_memory->cfg_czas_dostawy;
+        zegar_spij_us(shared_memory->cfg_czas_dostawy * 1000000LL);
+        int stan = dostarcz_paliwo(shared_memory->cfg_dostawa_paliwa);
+        slad_zapisz(zegar_teraz_us(), ZD_DOSTAWA_PALIWA, 0, -1, stan);
+    }
+}
+
+int64_t czas_startu_us() {
+    int start = shared_memory->cfg_czas_startu;
+    return (start > 0) ? start : shared_memory->cfg_landing_time;
+}
+
+// Kierunek samolotu ustalany na bramce z czekających i już obiecanych
+// miejsc (przydzial.h); obietnica wraca przy boardingu (oddaj_kierunek)
+int przydziel_kierunek(int wylosowany) {
+    SharedData* d = shared_memory;
+    int kierunki = d->cfg_kierunki;
+    int czekajacy[MAX_KIERUNKOW];
+    int obiecane[MAX_KIERUNKOW];
+    blokada_wez(&d->blokada_przydzialu);
+    for (int i = 0; i < kierunki; i++) {
+        czekajacy[i] = kierunek_terminalu(i).pasazerowie.load(std::memory_order_relaxed);
+        obiecane[i] = kierunek_terminalu(i).obiecane;
+    }
+    int k = przydzial_wybierz(d->cfg_przydzial_kierunkow, czekajacy, obiecane, kierunki, d->cfg_plane_capacity,
+                              wylosowany);
+    kierunek_terminalu(k).obiecane += d->cfg_plane_capacity;
+    blokada_oddaj(&d->blokada_przydzialu);
+    return k;
+}
+
+void oddaj_kierunek(int k) {
+    blokada_wez(&shared_memory->blokada_przydzialu);
+    kierunek_terminalu(k).obiecane -= shared_memory->cfg_plane_capacity;
+    blokada_oddaj(&shared_memory->blokada_przydzialu);
+}
+
+// Slot dla wziętej jednostki bramki albo cysterny. Poza zegarem
+// wirtualnym jednostkę zabitego procesu oddaje jądro (SEM_UNDO) przy jego
+// śmierci, a slot nadzorca dopiero przy odzysku - slot przychodzi wtedy
+// chwilę po jednostce.
+static int zajmij_slot(PulaSlotow* pula, int start) {
+    int idx = sloty_zajmij(pula, start);
+    while (idx == -1 && !zegar_wirtualny()) {
+        sched_yield();
+        idx = sloty_zajmij(pula, start);
     }
+    return idx;
 }
 
-void proces_samolotu(int id) {
-    srand(getpid() + id);
+// Pełna obsługa jednego samolotu: od lądowania do startu.
+// Wywoływana w osobnym procesie (proces_samolotu) albo przez proces puli.
+void obsluz_samolot(int id, int64_t t_przylot) {
+    // Losowania samolotu zależą tylko od ziarna i id (losowanie.h)
+    Losowanie los;
+    los_init(&los, shared_memory->ziarno, LOS_SAMOLOT, id);
 
     // Rejestracja samolotu
-    sem_p(MUTEX_ZASOBY);
     shared_memory->aktywne_samoloty++;
-    sem_v(MUTEX_ZASOBY);
-
-    sem_p(MUTEX_ZASOBY);
-    int moj_kierunek = rand() % 4;
-    sem_v(MUTEX_ZASOBY);
+    int moj_kierunek = los_ponizej(&los, shared_memory->cfg_kierunki);
+    slad_zapisz(t_przylot, ZD_PRZYLOT, id, -1, moj_kierunek);
     // ---------------------
 
-    // 1. LĄDOWANIE
-    sem_p(SEM_PAS);
-    int moj_pas = -1;
-    int ilosc_pasow = shared_memory->cfg_runways;
-    int start_node = rand() % ilosc_pasow;
-
-    for(int i=0; i<ilosc_pasow; i++) {
-        int idx = (start_node + i) % ilosc_pasow;
-        if (shared_memory->pasy_startowe[idx] == 0) {
-            shared_memory->pasy_startowe[idx] = id;
-            moj_pas = idx;
-            break;
-        }
+    // 1. KRĄŻENIE I LĄDOWANIE
+    // Czasy czekania i zajęcia zasobów idą do histogramów (histogram.h);
+    // zegar_teraz_us() to odczyt pamięci albo vDSO, bez wywołań systemowych.
+    // Z drogą kołowania miejsce na niej rezerwowane jest przed lądowaniem:
+    // samolot na pasie nigdy nie czeka wtedy na bramkę, więc pas wraca
+    // zaraz po przyziemieniu, a krąg pas -> bramka -> pas się nie zamyka.
+    bool kolowanie = shared_memory->cfg_kolowanie > 0;
+    int64_t termin = (shared_memory->cfg_przekierowanie > 0)
+                         ? t_przylot + shared_memory->cfg_przekierowanie * 1000000LL
+                         : -1;
+    shared_memory->w_powietrzu++;
+    shared_memory->czeka_na_pas++;
+    // Rejestr (segment.h) nadąża za licznikami i zasobami: z niego
+    // nadzorca oddaje wszystko, gdyby proces zginął w dowolnym miejscu
+    RejestrProcesu& wpis = *moj_wpis;
+    wpis.pas = wpis.bramka = wpis.cysterna = wpis.kierunek = -1;
+    wpis.jednostki = 0;
+    wpis.etap = ETAP_KRAZY;
+    wpis.samolot = id;
+    bool zgoda = !kolowanie || sem_p_do(SEM_KOLOWANIE, termin);
+    if (zgoda && kolowanie) wpis.jednostki |= JEDN_KOLOWANIE;
+    int64_t t_czeka = zegar_teraz_us();
+    int moj_pas = zgoda ? wieza_wez_pas(&shared_memory->wieza, OP_LADOWANIE, termin) : -1;
+    wpis.pas = moj_pas;
+    if (zgoda && moj_pas == -1) {
+        if (kolowanie) sem_v(SEM_KOLOWANIE);
+        wpis.jednostki = 0;
+        zgoda = false;
     }
-    if (moj_pas == -1) {
-        for(int i=0; i<ilosc_pasow; i++) if(shared_memory->pasy_startowe[i]==0) { shared_memory->pasy_startowe[i]=id; moj_pas=i; break; }
+    shared_memory->czeka_na_pas--;
+    shared_memory->w_powietrzu--;
+    wpis.etap = ETAP_LADUJE;
+    int64_t t_pas = zegar_teraz_us();
+    hist_zapisz(HIST_KRAZENIE, t_pas - t_przylot);
+    zmien_panel(PANEL_RUCH);
+
+    if (!zgoda) {
+        shared_memory->aktywne_samoloty--;
+        wpis.samolot = 0;
+        shared_memory->stat_przekierowane++;
+        slad_zapisz(t_pas, ZD_PRZEKIEROWANY, id, -1, 0);
+        dodaj_log("ID:%03d [%s] Za dlugo w powietrzu: ZAPASOWE", id, kierunek_terminalu(moj_kierunek).nazwa, 0, "");
+        return;
     }
 
-    usleep(shared_memory->cfg_landing_time);
+    hist_zapisz(HIST_LADOWANIE_CZEKANIE, t_pas - t_czeka);
+    ustaw_pas(moj_pas, id);
+    slad_zapisz(t_pas, ZD_LADOWANIE, id, moj_pas, 0);
+    RekordLotu lot = {};
+    lot.t_przylot = t_przylot;
+    lot.t_ladowanie = t_pas;
+    lot.pas_ladowania = (int16_t)moj_pas;
+
+    zegar_spij_us(shared_memory->cfg_landing_time);
 
     // 2. PARKOWANIE
-    sem_p(SEM_GATE);
-    if(moj_pas != -1) shared_memory->pasy_startowe[moj_pas] = 0;
-    sem_v(SEM_PAS);
+    int64_t pas_zajety;
+    int zwolniony_pas = -1;
+    if (kolowanie) {
+        // Zjazd z pasa na zarezerwowane miejsce, tam czekanie na bramkę
+        ustaw_pas(moj_pas, 0);
+        wieza_zwolnij_pas(&shared_memory->wieza, moj_pas);
+        wpis.pas = -1;
+        t_czeka = zegar_teraz_us();
+        pas_zajety = t_czeka - t_pas;
+        hist_zapisz(HIST_PAS_ZAJETY, pas_zajety);
+        slad_zapisz(t_czeka, ZD_ZJAZD_Z_PASA, id, moj_pas, 0);
+
+        shared_memory->na_kolowaniu++;
+        zmien_panel(PANEL_RUCH);
+        shared_memory->czeka_na_bramke++;
+        wpis.etap = ETAP_KOLUJE;
+        sem_p(SEM_GATE);
+        wpis.jednostki |= JEDN_BRAMKA;
+        shared_memory->czeka_na_bramke--;
+        shared_memory->na_kolowaniu--;
+        wpis.etap = ETAP_OBSLUGA;
+        sem_v(SEM_KOLOWANIE);
+        wpis.jednostki &= ~JEDN_KOLOWANIE;
+        zmien_panel(PANEL_RUCH);
+    } else {
+        // Bez drogi kołowania bramka brana jeszcze na pasie
+        t_czeka = zegar_teraz_us();
+        slad_zapisz(t_czeka, ZD_WYLADOWAL, id, moj_pas, 0);
+        shared_memory->czeka_na_bramke++;
+        wpis.etap = ETAP_CZEKA_BRAMKA;
+        sem_p(SEM_GATE);
+        wpis.jednostki |= JEDN_BRAMKA;
+        shared_memory->czeka_na_bramke--;
+        wpis.etap = ETAP_OBSLUGA;
+        ustaw_pas(moj_pas, 0);
+        wieza_zwolnij_pas(&shared_memory->wieza, moj_pas);
+        wpis.pas = -1;
+        pas_zajety = zegar_teraz_us() - t_pas;
+        hist_zapisz(HIST_PAS_ZAJETY, pas_zajety);
+        zwolniony_pas = moj_pas;
+    }
+    int64_t t_gate = zegar_teraz_us();
+    hist_zapisz(HIST_BRAMKA_CZEKANIE, t_gate - t_czeka);
+    moj_kierunek = przydziel_kierunek(moj_kierunek);
+    wpis.kierunek = moj_kierunek;
 
-    int my_gate_index = -1;
     int ilosc_bramek = shared_memory->cfg_gates;
-    start_node = rand() % ilosc_bramek;
-
-    for(int i=0; i<ilosc_bramek; i++) {
-        int idx = (start_node + i) % ilosc_bramek;
-        if(shared_memory->stanowiska_gate[idx] == 0) {
-            shared_memory->stanowiska_gate[idx] = id;
-            shared_memory->gate_kierunek[idx] = moj_kierunek;
-            shared_memory->gate_liczba_pasazerow[idx] = 0;
-            my_gate_index = idx;
-            break;
-        }
-    }
+    int my_gate_index = zajmij_slot(&shared_memory->wolne_bramki, los_ponizej(&los, ilosc_bramek));
+    wpis.bramka = my_gate_index;
+    ustaw_bramke(my_gate_index, id, moj_kierunek, 0);
+    slad_zapisz(t_gate, ZD_BRAMKA, id, my_gate_index, zwolniony_pas);
 
     if (my_gate_index == -1) {
-        sem_p(MUTEX_ZASOBY);
-        shared_memory->aktywne_samoloty--;
-        sem_v(MUTEX_ZASOBY);
+        oddaj_kierunek(moj_kierunek);
         sem_v(SEM_GATE);
-        exit(1);
+        shared_memory->aktywne_samoloty--;
+        wpis.samolot = 0;
+        slad_zapisz(zegar_teraz_us(), ZD_ODLOT, id, -1, 0);
+        return;
     }
 
-    // 3. TANKOWANIE
-    sem_p(SEM_CYSTERNA);
-    int my_tanker_index = -1;
-    start_node = rand() % MAX_TANKERS;
-
-    for(int i=0; i<MAX_TANKERS; i++) {
-        int idx = (start_node + i) % MAX_TANKERS;
-        if(shared_memory->cysterny_status[idx] == 0) {
-            shared_memory->cysterny_status[idx] = id;
-            my_tanker_index = idx;
-            break;
-        }
+    // 3. OBSŁUGA NAZIEMNA
+    // Kolejno: sprzątanie, catering, tankowanie, boarding. Z --ground-ops
+    // graf zależności: sprzątanie -> boarding, a catering i tankowanie
+    // równolegle z nimi; bramka wolna po najdłuższej ścieżce. Zadania bez
+    // zasobów to tylko upływ czasu, więc samolot czeka na cysternę, a
+    // potem śpi do końca ścieżki krytycznej.
+    bool rownolegle = shared_memory->cfg_obsluga_rownolegla != 0;
+    int64_t sprzatanie = shared_memory->cfg_sprzatanie * 1000000LL;
+    int64_t catering = shared_memory->cfg_catering * 1000000LL;
+    int64_t boarding = shared_memory->cfg_boarding_time * 1000000LL;
+    int64_t koniec_boardingu = t_gate + sprzatanie + boarding;
+    int64_t koniec_obslugi = std::max(koniec_boardingu, t_gate + catering);
+    if (!rownolegle) zegar_spij_us(sprzatanie + catering);
+
+    t_czeka = zegar_teraz_us();
+    shared_memory->czeka_na_cysterne++;
+    wpis.etap = ETAP_CZEKA_CYSTERNA;
+    if (rownolegle) cysterna_wez(my_gate_index, koniec_boardingu);
+    else sem_p(SEM_CYSTERNA);
+    wpis.jednostki |= JEDN_CYSTERNA;
+    shared_memory->czeka_na_cysterne--;
+    wpis.etap = ETAP_OBSLUGA;
+    int64_t t_cysterna = zegar_teraz_us();
+    hist_zapisz(HIST_CYSTERNA_CZEKANIE, t_cysterna - t_czeka);
+    int my_tanker_index = zajmij_slot(&shared_memory->wolne_cysterny, los_ponizej(&los, shared_memory->cfg_tankers));
+    wpis.cysterna = my_tanker_index;
+    ustaw_cysterne(my_tanker_index, id);
+    slad_zapisz(t_cysterna, ZD_CYSTERNA, id, my_tanker_index, 0);
+    lot.t_bramka = t_gate;
+    lot.bramka = (int16_t)my_gate_index;
+    lot.t_cysterna = t_cysterna;
+    lot.cysterna = (int16_t)my_tanker_index;
+
+    // Przy pustym magazynie samolot czeka z cysterną (i bramką) na dostawę
+    int64_t czekanie_paliwo = pobierz_paliwo(FUEL_NEEDED);
+    hist_zapisz(HIST_PALIWO_CZEKANIE, czekanie_paliwo);
+    if (czekanie_paliwo > 0) {
+        shared_memory->stat_bez_paliwa++;
+        shared_memory->stat_paliwo_czekanie_us += czekanie_paliwo;
+        slad_zapisz(t_cysterna, ZD_BRAK_PALIWA, id, my_tanker_index, 0);
+        slad_zapisz(t_cysterna + czekanie_paliwo, ZD_PALIWO, id, my_tanker_index, 0);
     }
 
-    sem_p(MUTEX_ZASOBY);
-    if (shared_memory->paliwo_w_magazynie >= FUEL_NEEDED) {
-        shared_memory->paliwo_w_magazynie -= FUEL_NEEDED;
+    zegar_spij_us(CZAS_TANKOWANIA_US);
+    if (!zamknij_zwalniana_cysterne(my_tanker_index)) {
+        ustaw_cysterne(my_tanker_index, 0);
+        sloty_zwolnij(&shared_memory->wolne_cysterny, my_tanker_index);
+        if (rownolegle) cysterna_oddaj();
+        else sem_v(SEM_CYSTERNA);
+    } else if (!rownolegle) {
+        sem_zatrzymaj(SEM_CYSTERNA);
     }
-    sem_v(MUTEX_ZASOBY);
-
-    sleep(2);
-    if (my_tanker_index != -1) shared_memory->cysterny_status[my_tanker_index] = 0;
-    sem_v(SEM_CYSTERNA);
-
-    // 4. BOARDING
-    sleep(shared_memory->cfg_boarding_time);
-
-    sem_p(MUTEX_ZASOBY);
+    wpis.cysterna = -1;
+    wpis.jednostki &= ~JEDN_CYSTERNA;
+    int64_t t_boarding = zegar_teraz_us();
+    hist_zapisz(HIST_CYSTERNA_ZAJETA, t_boarding - t_cysterna);
+    slad_zapisz(t_boarding, ZD_BOARDING, id, my_tanker_index, 0);
+
+    // 4. BOARDING (z --ground-ops trwał już w tle - zostaje reszta)
+    if (rownolegle) zegar_spij_us(koniec_obslugi - zegar_teraz_us());
+    else zegar_spij_us(boarding);
+
+    KierunekTerminalu& kierunek = kierunek_terminalu(moj_kierunek);
+    blokada_wez(&kierunek.blokada);
     int capacity = shared_memory->cfg_plane_capacity;
-    int ludzie_w_terminalu = shared_memory->pasazerowie_w_terminalu[moj_kierunek];
+    int ludzie_w_terminalu = kierunek.pasazerowie;
 
     int do_zabrania = (ludzie_w_terminalu < capacity) ? ludzie_w_terminalu : capacity;
+    if (shared_memory->off_kolejki != 0) {
+        do_zabrania = kolejka_zabierz(&kolejka_pasazerow(moj_kierunek), miejsca_pasazerow(moj_kierunek),
+                                      capacity, zegar_teraz_us());
+    }
 
-    if (do_zabrania > 0) {
-        shared_memory->pasazerowie_w_terminalu[moj_kierunek] -= do_zabrania;
-        shared_memory->gate_liczba_pasazerow[my_gate_index] = do_zabrania;
+    if (do_zabrania > 0) kierunek.pasazerowie -= do_zabrania;
+    blokada_oddaj(&kierunek.blokada);
+    oddaj_kierunek(moj_kierunek);
+    wpis.kierunek = -1;
+    int final_pax = do_zabrania;
+    if (final_pax > 0) {
+        ustaw_bramke(my_gate_index, id, moj_kierunek, final_pax);
+        zmien_panel(PANEL_TERMINAL);
     }
-    int final_pax = shared_memory->gate_liczba_pasazerow[my_gate_index];
-    sem_v(MUTEX_ZASOBY);
 
     const char* status = (final_pax >= capacity) ? "PELNY" : "ODLOT";
-    dodaj_log("ID:%03d [%c] Pax: %d/%d (%s)", id, KIERUNKI_NAZWY[moj_kierunek], final_pax, status);
+    dodaj_log("ID:%03d [%s] Pax: %d/%d (%s)", id, kierunek.nazwa, final_pax, status);
 
     // 5. ODLOT
-    if (my_gate_index != -1) {
-        shared_memory->stanowiska_gate[my_gate_index] = 0;
-        shared_memory->gate_kierunek[my_gate_index] = -1;
-        shared_memory->gate_liczba_pasazerow[my_gate_index] = 0;
-    }
-    sem_v(SEM_GATE);
-
-    sem_p(SEM_PAS);
-    moj_pas = -1;
-    start_node = rand() % ilosc_pasow;
-
-    for(int i=0; i<ilosc_pasow; i++) {
-        int idx = (start_node + i) % ilosc_pasow;
-        if (shared_memory->pasy_startowe[idx] == 0) {
-            shared_memory->pasy_startowe[idx] = -id;
-            moj_pas = idx;
-            break;
-        }
+    if (!zamknij_zwalniana_bramke(my_gate_index)) {
+        ustaw_bramke(my_gate_index, 0, -1, 0);
+        sloty_zwolnij(&shared_memory->wolne_bramki, my_gate_index);
+        sem_v(SEM_GATE);
+    } else {
+        sem_zatrzymaj(SEM_GATE);
     }
-    if (moj_pas == -1) {
-        for(int i=0; i<ilosc_pasow; i++) if(shared_memory->pasy_startowe[i]==0) { shared_memory->pasy_startowe[i] = -id; moj_pas=i; break; }
+    wpis.bramka = -1;
+    wpis.jednostki &= ~JEDN_BRAMKA;
+    t_czeka = zegar_teraz_us();
+    int64_t gate_zajety = t_czeka - t_gate;
+    hist_zapisz(HIST_BRAMKA_ZAJETA, gate_zajety);
+    slad_zapisz(t_czeka, ZD_BRAMKA_ZWOLNIONA, id, my_gate_index, final_pax);
+
+    shared_memory->czeka_na_pas++;
+    wpis.etap = ETAP_CZEKA_START;
+    moj_pas = wieza_wez_pas(&shared_memory->wieza, OP_START, -1);
+    wpis.pas = moj_pas;
+    shared_memory->czeka_na_pas--;
+    wpis.etap = ETAP_STARTUJE;
+    t_pas = zegar_teraz_us();
+    hist_zapisz(HIST_START_CZEKANIE, t_pas - t_czeka);
+    ustaw_pas(moj_pas, -id);
+    slad_zapisz(t_pas, ZD_START, id, moj_pas, 0);
+
+    zegar_spij_us(czas_startu_us());
+
+    ustaw_pas(moj_pas, 0);
+    wieza_zwolnij_pas(&shared_memory->wieza, moj_pas);
+    wpis.pas = -1;
+    int64_t t_odlot = zegar_teraz_us();
+    pas_zajety += t_odlot - t_pas;
+    hist_zapisz(HIST_PAS_ZAJETY, t_odlot - t_pas);
+    slad_zapisz(t_odlot, ZD_ODLOT, id, moj_pas, final_pax);
+
+    shared_memory->aktywne_samoloty--;
+    wpis.samolot = 0;
+    shared_memory->stat_odloty++;
+    if (final_pax >= capacity) shared_memory->stat_pelne++;
+    shared_memory->stat_pasazerowie_zabrani += final_pax;
+    shared_memory->stat_obsluga_suma_us += t_odlot - t_przylot;
+    hist_zapisz(HIST_OBSLUGA, t_odlot - t_przylot);
+    atomic_max(shared_memory->stat_obsluga_max_us, t_odlot - t_przylot);
+    shared_memory->stat_pas_zajety_us += pas_zajety;
+    shared_memory->stat_gate_zajety_us += gate_zajety;
+
+    lot.id = id;
+    lot.kierunek = (int16_t)moj_kierunek;
+    lot.pas_startu = (int16_t)moj_pas;
+    lot.pasazerowie = final_pax;
+    lot.paliwo = FUEL_NEEDED;
+    lot.t_start = t_pas;
+    lot.t_odlot = t_odlot;
+    dziennik_dopisz(lot);
+}
+
+// Proces zapisu śladu: poza zegarem symulacji (nie wstrzymuje przeskoków),
+// odpytuje pierścienie co 1 ms czasu rzeczywistego
+void proces_zapisu_sladu(FILE* plik) {
+    while (true) {
+        bool koniec = bufor_sladu()->koniec.load();
+        long ile = slad_oproznij(plik);
+        if (koniec && ile == 0) break;
+        if (ile == 0) usleep(1000);
     }
+    long long utracone = slad_utracone();
+    if (utracone > 0) fprintf(stderr, "Slad: utracono %lld zdarzen (pelne pierscienie)\n", utracone);
+    fclose(plik);
+    exit(0);
+}
 
-    usleep(shared_memory->cfg_landing_time);
+// Koniec procesu - zwolnienie slotu zegara, żeby nie blokował przeskoku czasu
+void zakoncz_proces(int kod) {
+    zegar_wyrejestruj(zegar_slot);
+    exit(kod);
+}
 
-    if(moj_pas != -1) shared_memory->pasy_startowe[moj_pas] = 0;
-    sem_v(SEM_PAS);
+void proces_samolotu(int id, int64_t t_przylotu) {
+    obsluz_samolot(id, t_przylotu);
+    zakoncz_proces(0);
+}
 
-    sem_p(MUTEX_ZASOBY);
-    shared_memory->aktywne_samoloty--;
-    sem_v(MUTEX_ZASOBY);
+// Stały proces puli: pobiera kolejne samoloty z kolejki zleceń
+void proces_obslugi() {
+    while (true) {
+        sem_p(SEM_ZADANIA);
+        blokada_wez(&shared_memory->blokada_zadan);
+        int idx = shared_memory->zadania_glowa;
+        int id = shared_memory->zadania[idx].id;
+        int64_t t_zgloszenia = shared_memory->zadania[idx].t_zgloszenia;
+        shared_memory->zadania_glowa = (idx + 1) % MAX_ZADAN;
+        shared_memory->zadania_ile--;
+        blokada_oddaj(&shared_memory->blokada_zadan);
+
+        obsluz_samolot(id, t_zgloszenia);
+    }
+}
 
-    exit(0);
+// Zlecenie obsługi samolotu dla puli; false gdy kolejka pełna
+bool zlec_samolot(int id) {
+    blokada_wez(&shared_memory->blokada_zadan);
+    if (shared_memory->zadania_ile == MAX_ZADAN) {
+        blokada_oddaj(&shared_memory->blokada_zadan);
+        return false;
+    }
+    int idx = shared_memory->zadania_ogon;
+    shared_memory->zadania[idx].id = id;
+    shared_memory->zadania[idx].t_zgloszenia = zegar_teraz_us();
+    shared_memory->zadania_ogon = (idx + 1) % MAX_ZADAN;
+    shared_memory->zadania_ile++;
+    blokada_oddaj(&shared_memory->blokada_zadan);
+    sem_v(SEM_ZADANIA);
+    return true;
 }
 
 // =============================================================
-// =======  WIZUALIZACJA  ======================================
+// =======  ODZYSK ZASOBÓW ZABITYCH PROCESÓW  ==================
 // =============================================================
+//
+// Samolot (albo proces puli) zabity sygnałem niczego nie odda sam.
+// Nadzorca zbiera go przez waitpid i oddaje z rejestru (segment.h):
+// slot zegara z jego kolejkami (zegar_usun), zgłoszenia w wieży i w
+// magazynie, pas, bramkę, cysternę, miejsce kołowania i obietnicę
+// kierunku; liczniki kolejek cofa według etapu. Blokady przeżywają
+// śmierć właściciela (blokady.h). W zegarze wirtualnym ofiara zawsze
+// śpi albo czeka, więc odzysk jest dokładny i powtarzalny. W pozostałych
+// wraca też to, co przekazano śpiącemu, zanim zdążył to wpisać: jednostki
+// semaforów SysV oddaje jądro (SEM_UNDO), a pas i cysternę w --ground-ops
+// nadzorca znajduje w zgłoszeniu w wieży i w rekordzie bramki.
+
+void po_fork_w_dziecku(int slot, int wpis = -1);
+
+// Wpisy rejestru rozdziela tylko nadzorca: wolne na stosie, zajęte
+// według pid
+static std::vector<int> wolne_wpisy;
+static std::unordered_map<pid_t, int> wpisy_procesow;
+
+void rejestr_init(int procesy) {
+    wolne_wpisy.clear();
+    wpisy_procesow.clear();
+    for (int i = procesy - 1; i >= 0; i--) wolne_wpisy.push_back(i);
+}
 
-void draw_interface(int loop_counter, int plane_id_counter, bool paused) {
-    erase();
-    int height = LINES;
-    int width = 85;
+// Wolny wpis rejestru zajmowany przed fork(); -1 = brak (proces bez wpisu)
+static int zajmij_wpis(int slot, bool pula) {
+    if (wolne_wpisy.empty()) return -1;
+    int i = wolne_wpisy.back();
+    wolne_wpisy.pop_back();
+    RejestrProcesu& r = rejestr_procesu(i);
+    r.pid = -1;
+    r.slot_zegara = slot;
+    r.pula = pula;
+    r.samolot = 0;
+    return i;
+}
 
-    // --- TYTUŁ ---
-    attron(A_BOLD | COLOR_PAIR(3));
-    mvprintw(1, 2, " SYMULACJA LOTNISKA - %s", shared_memory->scenariusz_nazwa);
-    attroff(A_BOLD | COLOR_PAIR(3));
-    mvhline(2, 1, ACS_HLINE, width-1);
+// fork() procesu obsługi z wpisem w rejestrze; w dziecku zwraca 0
+static pid_t fork_z_wpisem(int slot, bool pula) {
+    int wpis = zajmij_wpis(slot, pula);
+    pid_t pid = fork();
+    if (pid == 0) {
+        po_fork_w_dziecku(slot, wpis);
+        return 0;
+    }
+    if (wpis >= 0) {
+        rejestr_procesu(wpis).pid = (pid > 0) ? pid : 0;
+        if (pid > 0) wpisy_procesow[pid] = wpis;
+        else wolne_wpisy.push_back(wpis);
+    }
+    return pid;
+}
 
-    // --- PALIWO ---
-    mvprintw(3, 2, "PALIWO:");
-    int bar_width = 30;
-    float fuel_ratio = (float)shared_memory->paliwo_w_magazynie / FUEL_MAX;
-    int filled_len = (int)(fuel_ratio * bar_width);
-    mvprintw(3, 10, "[");
-    if (fuel_ratio < 0.2) attron(COLOR_PAIR(2)); else attron(COLOR_PAIR(1));
-    for (int i = 0; i < bar_width; i++) addch(i < filled_len ? ACS_CKBOARD : ' ');
-    attroff(COLOR_PAIR(1) | COLOR_PAIR(2));
-    printw("] %d L", shared_memory->paliwo_w_magazynie);
+// Przyloty czekające na proces: kolejny samolot dostaje wpis rejestru
+// (a z nim slot zegara i zgłoszenie w wieży), gdy zwolni go poprzedni.
+// Bez zmian w biegu wpisów starcza na cały przebieg (ustal_pojemnosc).
+static std::deque<std::pair<int, int64_t>> czekajace_przyloty;
+
+// Procesy dla czekających przylotów, dopóki są wolne wpisy
+static void wpusc_przyloty(std::vector<pid_t>* nowe) {
+    while (!czekajace_przyloty.empty() && !wolne_wpisy.empty()) {
+        std::pair<int, int64_t> przylot = czekajace_przyloty.front();
+        czekajace_przyloty.pop_front();
+        int slot = zegar_zarejestruj();
+        pid_t pid = fork_z_wpisem(slot, false);
+        if (pid == 0) proces_samolotu(przylot.first, przylot.second);
+        if (pid > 0 && nowe != nullptr) nowe->push_back(pid);
+    }
+    shared_memory->przyloty_czekajace = (int)czekajace_przyloty.size();
+}
 
-    // --- PASY ---
-    int aktywne_pasy = shared_memory->cfg_runways;
-    for(int i=0; i<aktywne_pasy; i++) {
-        int pid = shared_memory->pasy_startowe[i];
-        mvprintw(5 + i, 2, "PAS %d: ", i + 1);
-        if (pid == 0) {
-            attron(COLOR_PAIR(1)); printw("[ WOLNY ]"); attroff(COLOR_PAIR(1));
-        } else if (pid > 0) {
-            attron(COLOR_PAIR(2) | A_BLINK); printw("[ LADOWANIE ID:%d ]", pid); attroff(COLOR_PAIR(2) | A_BLINK);
-        } else {
-            attron(COLOR_PAIR(4) | A_BOLD); printw("[ STARTUJE ID:%d ]", abs(pid)); attroff(COLOR_PAIR(4) | A_BOLD);
+void uruchom_proces_obslugi() {
+    int slot = zegar_zarejestruj();
+    if (fork_z_wpisem(slot, true) == 0) proces_obslugi();
+}
+
+// Samolot czekał na cysternę w --ground-ops (zegar niewirtualny): wyjęcie
+// z kolejki; true = cysterna zdążyła mu zostać przekazana
+static bool porzuc_czekanie_na_cysterne(int bramka) {
+    RekordBramki& g = rekord_bramki(bramka);
+    blokada_wez(&shared_memory->blokada_cystern);
+    bool czeka = g.cysterna_poz >= 0;
+    if (czeka) kolejka_cystern_usun(bramka);
+    blokada_oddaj(&shared_memory->blokada_cystern);
+    return !czeka && g.cysterna_futex.load(std::memory_order_acquire) != 0;
+}
+
+// Zwraca liczbę odebranych zasobów (pasy, bramki, cysterny, miejsca kołowania)
+static int odzyskaj_zasoby(const RejestrProcesu& r) {
+    SharedData* d = shared_memory;
+    switch (r.etap) {
+        case ETAP_KRAZY:          d->w_powietrzu--; d->czeka_na_pas--; break;
+        case ETAP_KOLUJE:         d->na_kolowaniu--; d->czeka_na_bramke--; break;
+        case ETAP_CZEKA_BRAMKA:   d->czeka_na_bramke--; break;
+        case ETAP_CZEKA_CYSTERNA: d->czeka_na_cysterne--; break;
+        case ETAP_CZEKA_START:    d->czeka_na_pas--; break;
+    }
+    d->aktywne_samoloty--;
+    zmien_panel(PANEL_RUCH);
+
+    int odzyskane = wieza_porzuc(&d->wieza, r.pid);
+    magazyn_porzuc(&d->magazyn, r.pid);
+    zmien_panel(PANEL_PALIWO);
+    if (r.pas >= 0) {
+        ustaw_pas(r.pas, 0);
+        wieza_zwolnij_pas(&d->wieza, r.pas);
+        odzyskane++;
+    }
+    // Jednostki semaforów SysV zabitego procesu oddało już jądro (SEM_UNDO);
+    // zamknięcie w toku czeka wtedy na następne zwolnienie
+    bool jadro = !zegar_wirtualny();
+    if (r.jednostki & JEDN_KOLOWANIE) {
+        if (!jadro) sem_v(SEM_KOLOWANIE);
+        odzyskane++;
+    }
+    if (r.kierunek >= 0) oddaj_kierunek(r.kierunek);
+
+    bool cysterna = (r.jednostki & JEDN_CYSTERNA) != 0;
+    if (r.etap == ETAP_CZEKA_CYSTERNA && d->cfg_obsluga_rownolegla && jadro) {
+        cysterna = porzuc_czekanie_na_cysterne(r.bramka) || cysterna;
+    }
+    if (cysterna) {
+        // Jak zwolnienie w obsluz_samolot (zamknięcie w toku albo powrót do puli)
+        bool cysterna_z_jadra = jadro && !d->cfg_obsluga_rownolegla;
+        if (r.cysterna < 0 || cysterna_z_jadra || !zamknij_zwalniana_cysterne(r.cysterna)) {
+            ustaw_cysterne(r.cysterna, 0);
+            sloty_zwolnij(&d->wolne_cysterny, r.cysterna);
+            if (!cysterna_z_jadra) cysterna_jednostka_oddaj();
         }
+        odzyskane++;
     }
-    // Awaria pasa
-    if (aktywne_pasy < 2 && shared_memory->cfg_runways == 1) {
-        mvprintw(6, 2, "PAS 2: ");
-        attron(COLOR_PAIR(5) | A_BOLD | A_BLINK);
-        printw("[ !!! REMONT !!! ]");
-        attroff(COLOR_PAIR(5) | A_BOLD | A_BLINK);
+    if (r.jednostki & JEDN_BRAMKA) {
+        if (r.bramka < 0 || jadro || !zamknij_zwalniana_bramke(r.bramka)) {
+            ustaw_bramke(r.bramka, 0, -1, 0);
+            sloty_zwolnij(&d->wolne_bramki, r.bramka);
+            if (!jadro) sem_v(SEM_GATE);
+        }
+        odzyskane++;
     }
+    return odzyskane;
+}
 
-    // --- CYSTERNY ---
-    mvprintw(5, 45, "CYSTERNY:");
-    for (int i = 0; i < MAX_TANKERS; ++i) {
-        int pid = shared_memory->cysterny_status[i];
-        mvprintw(6 + i, 45, "C%d: ", i + 1);
-        if (pid == 0) { attron(COLOR_PAIR(1)); printw("[ WOLNA ]"); attroff(COLOR_PAIR(1)); }
-        else { attron(COLOR_PAIR(4)); printw("[ ID:%d ]", pid); attroff(COLOR_PAIR(4)); }
+// Koniec procesu zebrany przez waitpid: wpis wraca do rejestru, a po
+// śmierci od sygnału nadzorca odbiera zasoby i zastępuje proces puli
+void odbierz_proces(pid_t pid, bool zabity) {
+    SharedData* d = shared_memory;
+    auto wpis = wpisy_procesow.find(pid);
+    if (wpis == wpisy_procesow.end()) return;
+    int i = wpis->second;
+    wpisy_procesow.erase(wpis);
+    RejestrProcesu& r = rejestr_procesu(i);
+
+    if (zabity) {
+        zegar_usun(r.slot_zegara);
+        if (r.samolot != 0) {
+            int odzyskane = odzyskaj_zasoby(r);
+            d->stat_zabite++;
+            d->stat_odzyskane += odzyskane;
+            char log[60];
+            snprintf(log, sizeof(log), "ID:%03d AWARIA: odzyskane zasoby %d", r.samolot, odzyskane);
+            zapisz_log(log);
+        }
     }
+    bool pula = r.pula;
+    r.pid = 0;
+    wolne_wpisy.push_back(i);
+    if (zabity && pula) uruchom_proces_obslugi();
+}
 
-    // --- BRAMKI ---
-    mvprintw(10, 2, "BRAMKI (%d czynnych):", shared_memory->cfg_gates);
-    int aktywne_bramki = shared_memory->cfg_gates;
-    for (int i = 0; i < aktywne_bramki; ++i) {
-        int pid = shared_memory->stanowiska_gate[i];
-        int kier = shared_memory->gate_kierunek[i];
-        int pas = shared_memory->gate_liczba_pasazerow[i];
-        int max_cap = shared_memory->cfg_plane_capacity;
+// Zakończone procesy potomne, bez czekania
+void zbierz_procesy() {
+    int status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0) odbierz_proces(pid, WIFSIGNALED(status));
+}
 
-        mvprintw(11 + i, 2, "G%-2d: ", i + 1);
-        if (pid == 0) {
-            attron(COLOR_PAIR(1)); printw("[ .................... ]"); attroff(COLOR_PAIR(1));
-        } else {
-            if (pas >= max_cap) attron(COLOR_PAIR(1)); else attron(COLOR_PAIR(4));
-            printw("[ ID:%-3d ", pid);
-            attron(A_BOLD); printw("%c", KIERUNKI_NAZWY[kier]); attroff(A_BOLD);
-            printw(" %2d/%-2d ]", pas, max_cap);
-            if (pas >= max_cap) attroff(COLOR_PAIR(1)); else attroff(COLOR_PAIR(4));
-        }
+// Awaria co cfg_zabijanie s (--kill-every): SIGKILL dla losowego samolotu
+// w obsłudze i odzysk jego zasobów. Losowanie po numerach samolotów -
+// wpisy rejestru zależą od tego, kiedy nadzorca zebrał zakończone procesy.
+void wstrzyknij_awarie(int loop_counter) {
+    SharedData* d = shared_memory;
+    long long co = d->cfg_zabijanie * (1000000LL / TAKT_US);
+    if (co <= 0 || loop_counter == 0 || loop_counter % co != 0) return;
+
+    std::vector<std::pair<int, pid_t>> ofiary;
+    for (const auto& wpis : wpisy_procesow) {
+        const RejestrProcesu& r = rejestr_procesu(wpis.second);
+        if (r.samolot != 0) ofiary.push_back(std::make_pair(r.samolot, r.pid));
     }
+    if (ofiary.empty()) return;
+    std::sort(ofiary.begin(), ofiary.end());
+    Losowanie los;
+    los_init(&los, d->ziarno, LOS_AWARIE, loop_counter);
+    pid_t pid = ofiary[los_ponizej(&los, (int)ofiary.size())].second;
+
+    int status = 0;
+    kill(pid, SIGKILL);
+    if (waitpid(pid, &status, 0) == pid) odbierz_proces(pid, WIFSIGNALED(status));
+}
+
+// =============================================================
+// =======  WIZUALIZACJA  ======================================
+// =============================================================
+
+// Czas z histogramu w czytelnej jednostce; zasoby liczone są w us
+// symulacji, blokady w ns rzeczywistych
+void formatuj_czas(char* bufor, size_t n, int metryka, uint64_t wartosc) {
+    double ns = (metryka >= HIST_BLOKADA_CZEKANIE) ? (double)wartosc : wartosc * 1000.0;
+    if (ns < 1e3) snprintf(bufor, n, "%.0fns", ns);
+    else if (ns < 1e6) snprintf(bufor, n, "%.1fus", ns / 1e3);
+    else if (ns < 1e9) snprintf(bufor, n, "%.1fms", ns / 1e6);
+    else snprintf(bufor, n, "%.2fs", ns / 1e9);
+}
+
+// =============================================================
+// =======  WĄTEK EKRANU  ======================================
+// =============================================================
+//
+// Ekran rysuje osobny wątek nadzorcy z zadaną liczbą klatek (--fps).
+// Tło (ramki, wieża, opisy) rysowane jest raz; w kolejnych klatkach
+// tylko panele, których wersja (WersjaPanelu) się zmieniła. Gdy na
+// lotnisku nic się nie dzieje, klatka to kilka odczytów liczników.
+
+// Stan pętli głównej potrzebny ekranowi
+struct StanEkranu {
+    std::atomic<int> loty;              // Liczba wpuszczonych samolotów
+    std::atomic<bool> pauza;
+    std::atomic<bool> koniec;
+    std::atomic<bool> zmiana_rozmiaru;  // SIGWINCH
+    std::atomic<bool> przerysuj;        // Zmiana w biegu zmieniła tło (liczby, parametry)
+    int fps;
+};
+
+StanEkranu stan_ekranu;
+
+// Położenie paneli; zależy tylko od konfiguracji i rozmiaru terminala
+struct UkladEkranu {
+    int height;
+    int width;
+    int widoczne_pasy;
+    int widoczne_cysterny;
+    int widoczne_bramki;
+    int wiersze_bramek;
+    int term_y;
+    int widoczne_kierunki;
+    int wiersze_kierunkow;
+    int art_y;
+    int art_x;
+    int log_x;
+    int hist_y;
+    int info_y;
+};
+
+void oblicz_uklad_ekranu(UkladEkranu& u) {
+    u.height = LINES;
+    u.width = 85;
+
+    // Miejsce na wszystkie zainstalowane; zamknięte pokazują stan
+    int pasy = shared_memory->cfg_max_pasow;
+    u.widoczne_pasy = (pasy > EKRAN_MAX_PASOW) ? EKRAN_MAX_PASOW - 1 : pasy;
+    int cysterny = shared_memory->cfg_max_cystern;
+    u.widoczne_cysterny = (cysterny > EKRAN_MAX_CYSTERN) ? EKRAN_MAX_CYSTERN - 1 : cysterny;
+    int bramki = shared_memory->cfg_max_bramek;
+    u.widoczne_bramki = (bramki > EKRAN_MAX_BRAMEK) ? EKRAN_MAX_BRAMEK - 1 : bramki;
+    u.wiersze_bramek = u.widoczne_bramki + (u.widoczne_bramki < bramki ? 1 : 0);
 
-    // --- TERMINAL ---
-    int term_y = 11 + aktywne_bramki + 1;
     // Jeśli bramki zachodzą nisko, przesuń terminal niżej
-    if (term_y < 19) term_y = 19;
+    u.term_y = 11 + u.wiersze_bramek + 1;
+    if (u.term_y < 19) u.term_y = 19;
+    int kierunki = shared_memory->cfg_kierunki;
+    u.widoczne_kierunki = (kierunki > EKRAN_MAX_KIERUNKOW) ? EKRAN_MAX_KIERUNKOW : kierunki;
+    u.wiersze_kierunkow = (u.widoczne_kierunki + 3) / 4 + (u.widoczne_kierunki < kierunki ? 1 : 0);
+
+    u.art_y = u.term_y + 4 + u.wiersze_kierunkow;
+    u.art_x = 5;
+    u.log_x = u.width + 2;
+    u.hist_y = 4 + LOG_HISTORY_SIZE;
+    u.info_y = u.height - 7;
+}
+
+static void wyczysc(int y, int x, int wiersze, int szerokosc) {
+    for (int i = 0; i < wiersze; i++) mvhline(y + i, x, ' ', szerokosc);
+}
 
-    mvhline(term_y - 1, 1, ACS_HLINE, width-1);
-    mvprintw(term_y, 2, "TERMINAL (OCZEKUJACY):");
-    int x_pos = 2;
-    for(int i=0; i<4; i++) {
-        mvprintw(term_y + 1, x_pos, "BRAMA %c: ", KIERUNKI_NAZWY[i]);
-        int count = shared_memory->pasazerowie_w_terminalu[i];
+// Wszystko, co nie zmienia się w trakcie symulacji
+void rysuj_tlo(const UkladEkranu& u) {
+    int width = u.width;
 
+    // --- TYTUŁ ---
+    attron(A_BOLD | COLOR_PAIR(3));
+    mvprintw(1, 2, " SYMULACJA LOTNISKA - %s", shared_memory->scenariusz_nazwa);
+    attroff(A_BOLD | COLOR_PAIR(3));
+    mvhline(2, 1, ACS_HLINE, width-1);
 
-        if (count >= shared_memory->cfg_plane_capacity)
-            attron(COLOR_PAIR(2) | A_BOLD); // Czerwony
-        else
-            attron(COLOR_PAIR(1)); // Zielony
+    mvprintw(3, 2, "PALIWO:");
+    mvprintw(5, 45, "CYSTERNY:");
+    mvprintw(10, 2, "BRAMKI (%d czynnych):", shared_memory->cfg_gates);
 
-        printw("%-3d os.", count);
-        attroff(COLOR_PAIR(1) | COLOR_PAIR(2) | A_BOLD);
-        x_pos += 18;
-    }
+    mvhline(u.term_y - 1, 1, ACS_HLINE, width-1);
+    mvprintw(u.term_y, 2, "TERMINAL (OCZEKUJACY):");
 
     // =========================================================
     // === RYSUNEK WIEŻY I SAMOLOTU (POD TERMINALEM) ===========
     // =========================================================
 
-    int art_y = term_y + 5;
-    int art_x = 5;
+    int art_y = u.art_y;
+    int art_x = u.art_x;
 
     // --- WIEŻA KONTROLNA ---
     attron(A_BOLD | COLOR_PAIR(3));
@@ -403,24 +1227,15 @@ void draw_interface(int loop_counter, int plane_id_counter, bool paused) {
 
     // =========================================================
 
-
-    // =========================================================
-
-    // --- ODLOTY (LOGI) ---
-    int log_x = width + 2;
-    attron(A_BOLD | COLOR_PAIR(3)); mvprintw(1, log_x, "HISTORIA ODLOTOW:"); attroff(A_BOLD | COLOR_PAIR(3));
-    for(int i=0; i<LOG_HISTORY_SIZE; i++) {
-        int idx = (shared_memory->log_index - 1 - i + LOG_HISTORY_SIZE) % LOG_HISTORY_SIZE;
-        char* l = shared_memory->historia_logow[idx];
-        if (strlen(l) > 0) {
-            if (strstr(l, "PELNY")) attron(COLOR_PAIR(1)); else attron(COLOR_PAIR(4));
-            mvprintw(3 + i, log_x, "%s", l);
-            attroff(COLOR_PAIR(1) | COLOR_PAIR(4));
-        }
+    attron(A_BOLD | COLOR_PAIR(3)); mvprintw(1, u.log_x, "HISTORIA ODLOTOW:"); attroff(A_BOLD | COLOR_PAIR(3));
+    if (u.hist_y + 1 + LICZBA_METRYK < u.height - 1) {
+        attron(A_BOLD | COLOR_PAIR(3));
+        mvprintw(u.hist_y, u.log_x, "CZASY:                    p50      p99      max");
+        attroff(A_BOLD | COLOR_PAIR(3));
     }
 
     // --- LEGENDA PARAMETRÓW I STATUSU ---
-    int info_y = height - 7;
+    int info_y = u.info_y;
 
     mvhline(info_y, 1, ACS_HLINE, width-1);
 
@@ -434,207 +1249,2048 @@ void draw_interface(int loop_counter, int plane_id_counter, bool paused) {
              shared_memory->cfg_pax_rate,
              shared_memory->cfg_plane_capacity);
 
-    mvprintw(info_y + 3, 2, "Boarding: %ds | Ladowanie: %.1fs",
+    mvprintw(info_y + 3, 2, "Boarding: %ds | Ladowanie: %.1fs | Obsluga: %s | Pasy: %s",
              shared_memory->cfg_boarding_time,
-             (float)shared_memory->cfg_landing_time / 1000000.0);
+             (float)shared_memory->cfg_landing_time / 1000000.0,
+             shared_memory->cfg_obsluga_rownolegla ? "rownolegla" : "kolejna",
+             NAZWY_POLITYK[shared_memory->cfg_polityka_pasow]);
 
     // Status
     mvhline(info_y + 4, 1, ACS_HLINE, width-1);
 
-    attron(COLOR_PAIR(3));
-    mvprintw(info_y + 5, 2, " Calkowita liczba lotow: %d", plane_id_counter - 1);
-    attroff(COLOR_PAIR(3));
-
-
-
     attron(A_BOLD);
     mvprintw(info_y + 6, 2, "[ SPACJA ] = PAUZA / WZNOWIENIE   [ Q ] = WYJSCIE");
     attroff(A_BOLD);
 
-    // --- PAUZA (WIELKI NAPIS) ---
-    if (paused) {
-        attron(COLOR_PAIR(5) | A_BOLD);
-        int py = height / 2 - 2;
-        int px = width / 2 - 22;
-        mvprintw(py, px,     "                                             ");
-        mvprintw(py+1, px,   "   !!! PAUZA - WCISNIJ SPACJE ABY WZNOWIC !!!   ");
-        mvprintw(py+2, px,   "                                             ");
-        attroff(COLOR_PAIR(5) | A_BOLD);
-    }
-
     // RAMKI DOOKOŁA
-    mvvline(0, width, ACS_VLINE, height);
-    for(int i=0; i<width; i++) { mvaddch(0, i, ACS_HLINE); mvaddch(height-1, i, ACS_HLINE); }
-    for(int i=0; i<height; i++) mvaddch(i, 0, ACS_VLINE);
+    mvvline(0, width, ACS_VLINE, u.height);
+    for(int i=0; i<width; i++) { mvaddch(0, i, ACS_HLINE); mvaddch(u.height-1, i, ACS_HLINE); }
+    for(int i=0; i<u.height; i++) mvaddch(i, 0, ACS_VLINE);
+}
 
-    refresh();
+void ustaw_kolory() {
+    start_color();
+    init_pair(1, COLOR_GREEN, COLOR_BLACK);
+    init_pair(2, COLOR_RED, COLOR_BLACK);
+    init_pair(3, COLOR_CYAN, COLOR_BLACK);
+    init_pair(4, COLOR_YELLOW, COLOR_BLACK);
+    init_pair(5, COLOR_YELLOW, COLOR_RED);
+}
+
+void rysuj_paliwo(const UkladEkranu& u) {
+    wyczysc(3, 10, 1, u.width - 10);
+    int paliwo = shared_memory->magazyn.stan.load(std::memory_order_relaxed);
+    int bar_width = 30;
+    float fuel_ratio = (float)paliwo / FUEL_MAX;
+    int filled_len = (int)(fuel_ratio * bar_width);
+    mvprintw(3, 10, "[");
+    if (fuel_ratio < 0.2) attron(COLOR_PAIR(2)); else attron(COLOR_PAIR(1));
+    for (int i = 0; i < bar_width; i++) addch(i < filled_len ? ACS_CKBOARD : ' ');
+    attroff(COLOR_PAIR(1) | COLOR_PAIR(2));
+    printw("] %d L", paliwo);
+}
+
+// Ruch nad lotniskiem i na drodze kołowania
+void rysuj_ruch(const UkladEkranu& u) {
+    wyczysc(4, 2, 1, u.width - 3);
+    mvprintw(4, 2, "KRAZY: %d", shared_memory->w_powietrzu.load());
+    if (shared_memory->cfg_kolowanie > 0) {
+        printw("   KOLOWANIE: %d/%d", shared_memory->na_kolowaniu.load(), shared_memory->cfg_kolowanie);
+    }
+    long long przekierowane = shared_memory->stat_przekierowane.load();
+    if (przekierowane > 0) {
+        attron(COLOR_PAIR(2)); printw("   NA ZAPASOWE: %lld", przekierowane); attroff(COLOR_PAIR(2));
+    }
+}
+
+void rysuj_pasy(const UkladEkranu& u) {
+    wyczysc(5, 2, EKRAN_MAX_PASOW, 42);
+    int pasy = shared_memory->cfg_max_pasow;
+    for(int i=0; i<u.widoczne_pasy; i++) {
+        int pid = rekord_pasa(i).samolot.load(std::memory_order_relaxed);
+        mvprintw(5 + i, 2, "PAS %d: ", i + 1);
+        if (pid == 0 && shared_memory->wieza.pas_zamkniety[i]) {
+            attron(COLOR_PAIR(5) | A_BOLD); printw("[ !!! REMONT !!! ]"); attroff(COLOR_PAIR(5) | A_BOLD);
+        } else if (pid == 0) {
+            attron(COLOR_PAIR(1)); printw("[ WOLNY ]"); attroff(COLOR_PAIR(1));
+        } else if (pid > 0) {
+            attron(COLOR_PAIR(2) | A_BLINK); printw("[ LADOWANIE ID:%d ]", pid); attroff(COLOR_PAIR(2) | A_BLINK);
+        } else {
+            attron(COLOR_PAIR(4) | A_BOLD); printw("[ STARTUJE ID:%d ]", abs(pid)); attroff(COLOR_PAIR(4) | A_BOLD);
+        }
+    }
+    if (u.widoczne_pasy < pasy) mvprintw(5 + u.widoczne_pasy, 2, "... +%d pasow", pasy - u.widoczne_pasy);
+    // Awaria pasa
+    if (pasy == 1) {
+        mvprintw(6, 2, "PAS 2: ");
+        attron(COLOR_PAIR(5) | A_BOLD | A_BLINK);
+        printw("[ !!! REMONT !!! ]");
+        attroff(COLOR_PAIR(5) | A_BOLD | A_BLINK);
+    }
+}
+
+void rysuj_cysterny(const UkladEkranu& u) {
+    wyczysc(6, 45, EKRAN_MAX_CYSTERN, u.width - 45);
+    int cysterny = shared_memory->cfg_max_cystern;
+    for (int i = 0; i < u.widoczne_cysterny; ++i) {
+        int pid = rekord_cysterny(i).samolot.load(std::memory_order_relaxed);
+        mvprintw(6 + i, 45, "C%d: ", i + 1);
+        if (pid == 0) { attron(COLOR_PAIR(1)); printw("[ WOLNA ]"); attroff(COLOR_PAIR(1)); }
+        else if (pid < 0) { attron(COLOR_PAIR(2)); printw("[ ZAMKNIETA ]"); attroff(COLOR_PAIR(2)); }
+        else { attron(COLOR_PAIR(4)); printw("[ ID:%d ]", pid); attroff(COLOR_PAIR(4)); }
+    }
+    if (u.widoczne_cysterny < cysterny) mvprintw(6 + u.widoczne_cysterny, 45, "... +%d cystern", cysterny - u.widoczne_cysterny);
+}
+
+void rysuj_bramki(const UkladEkranu& u) {
+    wyczysc(11, 2, u.wiersze_bramek, 42);
+    int bramki = shared_memory->cfg_max_bramek;
+    int max_cap = shared_memory->cfg_plane_capacity;
+    for (int i = 0; i < u.widoczne_bramki; ++i) {
+        StanBramki g = odczytaj_bramke(i);
+        int pid = g.samolot;
+        int kier = g.kierunek;
+        int pas = g.pasazerowie;
+
+        mvprintw(11 + i, 2, "G%-2d: ", i + 1);
+        if (pid == 0) {
+            attron(COLOR_PAIR(1)); printw("[ .................... ]"); attroff(COLOR_PAIR(1));
+        } else if (pid < 0) {
+            attron(COLOR_PAIR(2)); printw("[ ZAMKNIETA ]"); attroff(COLOR_PAIR(2));
+        } else {
+            if (pas >= max_cap) attron(COLOR_PAIR(1)); else attron(COLOR_PAIR(4));
+            printw("[ ID:%-3d ", pid);
+            attron(A_BOLD); printw("%s", kier >= 0 ? kierunek_terminalu(kier).nazwa : "?"); attroff(A_BOLD);
+            printw(" %2d/%-2d ]", pas, max_cap);
+            if (pas >= max_cap) attroff(COLOR_PAIR(1)); else attroff(COLOR_PAIR(4));
+        }
+    }
+    if (u.widoczne_bramki < bramki) {
+        mvprintw(11 + u.widoczne_bramki, 2, "... +%d bramek", bramki - u.widoczne_bramki);
+    }
+}
+
+void rysuj_terminal(const UkladEkranu& u) {
+    wyczysc(u.term_y + 1, 2, u.wiersze_kierunkow, u.width - 3);
+    int kierunki = shared_memory->cfg_kierunki;
+    for(int i=0; i<u.widoczne_kierunki; i++) {
+        int x_pos = 2 + (i % 4) * 18;
+        mvprintw(u.term_y + 1 + i / 4, x_pos, "BRAMA %s: ", kierunek_terminalu(i).nazwa);
+        int count = kierunek_terminalu(i).pasazerowie.load(std::memory_order_relaxed);
+
+        if (count >= shared_memory->cfg_plane_capacity)
+            attron(COLOR_PAIR(2) | A_BOLD); // Czerwony
+        else
+            attron(COLOR_PAIR(1)); // Zielony
+
+        printw("%-3d os.", count);
+        attroff(COLOR_PAIR(1) | COLOR_PAIR(2) | A_BOLD);
+    }
+    if (u.widoczne_kierunki < kierunki) {
+        mvprintw(u.term_y + u.wiersze_kierunkow, 2, "... +%d kierunkow", kierunki - u.widoczne_kierunki);
+    }
+}
+
+void rysuj_logi(const UkladEkranu& u) {
+    // Spójna kopia historii (dodaj_log pisze pod sekwencją)
+    char historia[LOG_HISTORY_SIZE][60];
+    int log_index;
+    uint32_t v;
+    do {
+        v = sekwencja_odczyt_poczatek(&shared_memory->sekwencja_logow);
+        memcpy(historia, shared_memory->historia_logow, sizeof(historia));
+        log_index = shared_memory->log_index;
+    } while (!sekwencja_odczyt_ok(&shared_memory->sekwencja_logow, v));
+
+    wyczysc(3, u.log_x, LOG_HISTORY_SIZE, 60);
+    for(int i=0; i<LOG_HISTORY_SIZE; i++) {
+        int idx = (log_index - 1 - i + LOG_HISTORY_SIZE) % LOG_HISTORY_SIZE;
+        char* l = historia[idx];
+        l[59] = '\0';
+        if (strlen(l) > 0) {
+            if (strstr(l, "PELNY")) attron(COLOR_PAIR(1)); else attron(COLOR_PAIR(4));
+            mvprintw(3 + i, u.log_x, "%s", l);
+            attroff(COLOR_PAIR(1) | COLOR_PAIR(4));
+        }
+    }
+}
+
+// --- CZASY CZEKANIA (HISTOGRAMY) ---
+void rysuj_czasy(const UkladEkranu& u) {
+    if (u.hist_y + 1 + LICZBA_METRYK >= u.height - 1) return;
+    wyczysc(u.hist_y + 1, u.log_x, LICZBA_METRYK, 50);
+    for (int m = 0; m < LICZBA_METRYK; m++) {
+        PodsumowanieHistogramu p = hist_podsumuj(m);
+        char p50[16], p99[16], max[16];
+        formatuj_czas(p50, sizeof(p50), m, p.p50);
+        formatuj_czas(p99, sizeof(p99), m, p.p99);
+        formatuj_czas(max, sizeof(max), m, p.max);
+        mvprintw(u.hist_y + 1 + m, u.log_x, "%-20s %8s %8s %8s", NAZWY_METRYK[m], p50, p99, max);
+    }
+}
+
+void rysuj_status(const UkladEkranu& u, int loty) {
+    wyczysc(u.info_y + 5, 2, 1, 40);
+    attron(COLOR_PAIR(3));
+    mvprintw(u.info_y + 5, 2, " Calkowita liczba lotow: %d", loty);
+    attroff(COLOR_PAIR(3));
+}
+
+// --- PAUZA (WIELKI NAPIS) ---
+void rysuj_pauze(const UkladEkranu& u) {
+    attron(COLOR_PAIR(5) | A_BOLD);
+    int py = u.height / 2 - 2;
+    int px = u.width / 2 - 22;
+    mvprintw(py, px,     "                                             ");
+    mvprintw(py+1, px,   "   !!! PAUZA - WCISNIJ SPACJE ABY WZNOWIC !!!   ");
+    mvprintw(py+2, px,   "                                             ");
+    attroff(COLOR_PAIR(5) | A_BOLD);
+}
+
+void rysuj_panel(const UkladEkranu& u, int panel) {
+    switch (panel) {
+        case PANEL_PALIWO:   rysuj_paliwo(u); break;
+        case PANEL_PASY:     rysuj_pasy(u); break;
+        case PANEL_CYSTERNY: rysuj_cysterny(u); break;
+        case PANEL_BRAMKI:   rysuj_bramki(u); break;
+        case PANEL_TERMINAL: rysuj_terminal(u); break;
+        case PANEL_LOGI:     rysuj_logi(u); break;
+        case PANEL_RUCH:     rysuj_ruch(u); break;
+    }
+}
+
+void* watek_ekranu(void*) {
+    UkladEkranu u;
+    uint64_t narysowane[LICZBA_PANELI];
+    uint64_t narysowane_czasy = 0;
+    int narysowane_loty = -1;
+    bool pelne = true;
+    bool byla_pauza = false;
+
+    long okres_ns = 1000000000L / stan_ekranu.fps;
+    struct timespec nastepna, teraz;
+    clock_gettime(CLOCK_MONOTONIC, &nastepna);
+    time_t czasy_s = 0;
+
+    while (!stan_ekranu.koniec.load()) {
+        if (stan_ekranu.zmiana_rozmiaru.exchange(false)) {
+            struct winsize ws;
+            if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0) resizeterm(ws.ws_row, ws.ws_col);
+            pelne = true;
+        }
+        if (stan_ekranu.przerysuj.exchange(false)) pelne = true;
+        // Zniknięcie napisu pauzy odsłania panele - rysujemy wszystko
+        bool pauza = stan_ekranu.pauza.load();
+        if (pauza != byla_pauza) { pelne = true; byla_pauza = pauza; }
+
+        bool zmiany = pelne;
+        if (pelne) {
+            oblicz_uklad_ekranu(u);
+            erase();
+            rysuj_tlo(u);
+            for (int p = 0; p < LICZBA_PANELI; p++) narysowane[p] = ~0ULL;
+            narysowane_czasy = ~0ULL;
+            narysowane_loty = -1;
+            czasy_s = 0;
+            pelne = false;
+        }
+
+        // Wersja czytana przed rysowaniem: zmiana w trakcie trafi do następnej klatki
+        for (int p = 0; p < LICZBA_PANELI; p++) {
+            uint64_t w = shared_memory->wersje_paneli[p].wersja.load(std::memory_order_acquire);
+            if (w == narysowane[p]) continue;
+            narysowane[p] = w;
+            rysuj_panel(u, p);
+            zmiany = true;
+        }
+
+        // Scalanie szard histogramów jest drogie - najwyżej raz na sekundę
+        clock_gettime(CLOCK_MONOTONIC, &teraz);
+        if (teraz.tv_sec != czasy_s) {
+            czasy_s = teraz.tv_sec;
+            uint64_t n = 0;
+            for (int m = 0; m < LICZBA_METRYK; m++) n += hist_liczba(m);
+            if (n != narysowane_czasy) {
+                narysowane_czasy = n;
+                rysuj_czasy(u);
+                zmiany = true;
+            }
+        }
+
+        int loty = stan_ekranu.loty.load();
+        if (loty != narysowane_loty) {
+            narysowane_loty = loty;
+            rysuj_status(u, loty);
+            zmiany = true;
+        }
+
+        if (zmiany) {
+            if (pauza) rysuj_pauze(u);
+            refresh();
+        }
+
+        nastepna.tv_nsec += okres_ns;
+        while (nastepna.tv_nsec >= 1000000000L) { nastepna.tv_nsec -= 1000000000L; nastepna.tv_sec++; }
+        // Po dłuższym przestoju nie nadrabiamy klatek
+        if (teraz.tv_sec > nastepna.tv_sec + 1) nastepna = teraz;
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &nastepna, nullptr);
+    }
+    return nullptr;
 }
 
 // =============================================================
-// =======  MAIN (MENU WYBORU)  ================================
+// =======  TRYB BEZ GUI (--headless)  =========================
 // =============================================================
 
-int main() {
-    setlocale(LC_ALL, "");
-    srand(time(NULL));
+void wypisz_pomoc(const char* nazwa) {
+    std::cout << "Uzycie: " << nazwa << " [opcje]" << std::endl;
+    std::cout << "  --scenario=N     scenariusz 1-4 (bez menu)" << std::endl;
+    std::cout << "  --headless       bez ncurses, raport na koniec" << std::endl;
+    std::cout << "  --speed=N        zegar przyspieszony N razy (z --headless)" << std::endl;
+    std::cout << "  --max-speed      zegar wirtualny, przeskok do najblizszego zdarzenia" << std::endl;
+    std::cout << "  --duration=S     czas symulacji w sekundach (domyslnie 3600)" << std::endl;
+    std::cout << "  --pool=N         N stalych procesow obslugi zamiast fork() na samolot" << std::endl;
+    std::cout << "  --fps=N          klatki ekranu na sekunde (domyslnie 10)" << std::endl;
+    std::cout << "  --benchmark      porownanie fork() i puli (scenariusz 5, --max-speed)" << std::endl;
+    std::cout << "  --seed=N         ziarno losowania (domyslnie czas)" << std::endl;
+    std::cout << "  --trace=PLIK     slad zdarzen (binarny; slad_json PLIK > trace.json)" << std::endl;
+    std::cout << "  --record=PLIK    zapis ustawien i skrotu wyniku (z --max-speed)" << std::endl;
+    std::cout << "  --replay=PLIK    powtorzenie zapisanego przebiegu i porownanie skrotu" << std::endl;
+    std::cout << "  --flight-log=PLIK dziennik lotow (kolumnowy; dziennik_zapytania PLIK)" << std::endl;
+    std::cout << "  --runways=N --gates=N --tankers=N --directions=N --spawn-rate=N" << std::endl;
+    std::cout << "  --pax-rate=N --boarding-time=S --capacity=N --landing-time=US" << std::endl;
+    std::cout << "  --taxiway=N --divert-after=S --ground-ops=0|1 --cleaning-time=S --catering-time=S" << std::endl;
+    std::cout << "  --runway-policy=N (0 fcfs, 1 ladowania, 2 starty, 3 krotsza operacja," << std::endl;
+    std::cout << "                   4 naprzemiennie po --runway-batch=N) --takeoff-time=US" << std::endl;
+    std::cout << "  --pax-records=1  pasazer jako rekord: zmierzone czasy czekania na kierunek" << std::endl;
+    std::cout << "  --direction-policy=N kierunek samolotu: 0 losowy, 1 najwieksza kolejka," << std::endl;
+    std::cout << "                   2 kolejka na obiecane miejsce (wybor przy bramce)" << std::endl;
+    std::cout << "  --fuel-delivery=L --delivery-time=S  dostawa paliwa (L litrow co S sekund)" << std::endl;
+    std::cout << "  --engine=N       0 proces na samolot, 1 zdarzenia w jednym procesie (bez GUI," << std::endl;
+    std::cout << "                   zegar wirtualny; duze floty)" << std::endl;
+    std::cout << "  --max-runways=N --max-gates=N --max-tankers=N  zainstalowane (zapas na zmiany w biegu)" << std::endl;
+    std::cout << "                   wartosci zamiast tych ze scenariusza" << std::endl;
+    std::cout << "  --kill-every=S   co S s SIGKILL dla losowego samolotu (--engine=0; zasoby odbiera nadzorca)" << std::endl;
+    std::cout << "Plik scenariusza i zmiany w biegu:" << std::endl;
+    std::cout << "  --scenario-file=PLIK parametry \"param = N\" i harmonogram \"[GG:MM] param=N ...\"" << std::endl;
+    std::cout << "                   (linia polecen ma pierwszenstwo); w trakcie: so2ctl param=N" << std::endl;
+    std::cout << "Siec lotnisk (lotnisko na proces, silnik zdarzen, raport zbiorczy):" << std::endl;
+    std::cout << "  --network=N      N lotnisk (2-" << SIEC_MAX_LOTNISK << ") o tej samej konfiguracji" << std::endl;
+    std::cout << "  --flight-time=S  czas lotu miedzy lotniskami (domyslnie 900)" << std::endl;
+    std::cout << "  --network-share=P procent odlotow do innych lotnisk (domyslnie 50)" << std::endl;
+    std::cout << "Przeglad parametrow (rownolegle przebiegi z --max-speed, wynik CSV):" << std::endl;
+    std::cout << "  --sweep          wlacza przeglad" << std::endl;
+    std::cout << "  --range=P=A:B[:K] zakres parametru P (nazwy jak wyzej), krok K" << std::endl;
+    std::cout << "  --replications=N --jobs=N --csv=PLIK" << std::endl;
+    std::cout << "Optymalizacja (model kolejek, potem przebiegi silnika zdarzen):" << std::endl;
+    std::cout << "  --optimize       najtansza konfiguracja spelniajaca cel (--range jak wyzej," << std::endl;
+    std::cout << "                   domyslnie runways=1:4 gates=1:20 tankers=1:10)" << std::endl;
+    std::cout << "  --target-throughput=N odlotow/h (domyslnie przyloty; ustawia spawn-rate)" << std::endl;
+    std::cout << "  --target-p99=S   p99 przylot-odlot (domyslnie 2x obsluga bez czekania)" << std::endl;
+    std::cout << "  --cost=P=C       koszt jednostki parametru (runways 100, gates 10," << std::endl;
+    std::cout << "                   tankers 5, boarding-time -1)  --max-trials=N (64)" << std::endl;
+}
 
-    // 1. CZYSZCZENIE
-    int old_shmid = shmget(SHM_KEY, sizeof(SharedData), 0666);
-    if (old_shmid != -1) shmctl(old_shmid, IPC_RMID, nullptr);
-    int old_semid = semget(SEM_KEY, 4, 0666);
-    if (old_semid != -1) semctl(old_semid, 0, IPC_RMID);
+// --range=nazwa=min:max[:krok]
+bool parsuj_zakres(const char* tekst, ZakresParametru& z) {
+    const char* rowna = strchr(tekst, '=');
+    if (rowna == nullptr) return false;
+    z.parametr = znajdz_parametr(tekst, rowna - tekst);
+    if (z.parametr == -1) return false;
+    z.krok = 1;
+    int n = sscanf(rowna + 1, "%d:%d:%d", &z.min, &z.max, &z.krok);
+    if (n < 2 || z.krok <= 0 || z.min > z.max) return false;
+    const ParametrKonfiguracji& p = PARAMETRY[z.parametr];
+    return z.min >= p.min && z.max <= p.max;
+}
 
-    // 2. TWORZENIE PAMIĘCI
-    shmid = shmget(SHM_KEY, sizeof(SharedData), IPC_CREAT | 0666);
-    shared_memory = (SharedData*)shmat(shmid, nullptr, 0);
-    memset(shared_memory, 0, sizeof(SharedData));
-
-    // 3. MENU WYBORU SCENARIUSZA
-    std::cout << "============================================" << std::endl;
-    std::cout << "    WYBIERZ SCENARIUSZ SYMULACJI LOTNISKA     " << std::endl;
-    std::cout << "============================================" << std::endl;
-    std::cout << "1. Poza sezonem (optymalnie)" << std::endl;
-    std::cout << "2. Wakacje, tlumy ludzi" << std::endl;
-    std::cout << "3. Aremagedon" << std::endl;
-    std::cout << "4. AWARIA PASA " << std::endl;
-    std::cout << "Wybierz (1-4): ";
-
-    int wybor;
-    std::cin >> wybor;
-
-    // USTAWIENIA DOMYŚLNE
-    shared_memory->paliwo_w_magazynie = FUEL_MAX;
-    shared_memory->nastepna_dostawa = time(NULL) + DELIVERY_TIME;
-    shared_memory->aktywne_samoloty = 0;
+bool parsuj_opcje(int argc, char** argv, OpcjeUruchomienia& o) {
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (strcmp(a, "--headless") == 0) o.headless = true;
+        else if (strncmp(a, "--scenario=", 11) == 0) o.scenariusz = atoi(a + 11);
+        else if (strncmp(a, "--speed=", 8) == 0) { o.tryb_zegara = ZEGAR_PRZYSPIESZONY; o.predkosc = atof(a + 8); }
+        else if (strcmp(a, "--max-speed") == 0) o.tryb_zegara = ZEGAR_WIRTUALNY;
+        else if (strncmp(a, "--duration=", 11) == 0) o.czas_symulacji_s = atoll(a + 11);
+        else if (strncmp(a, "--pool=", 7) == 0) o.pula = atoi(a + 7);
+        else if (strncmp(a, "--fps=", 6) == 0) o.fps = atoi(a + 6);
+        else if (strcmp(a, "--benchmark") == 0) o.benchmark = true;
+        else if (strncmp(a, "--seed=", 7) == 0) { o.ziarno = (unsigned)strtoul(a + 7, nullptr, 10); o.ziarno_podane = true; }
+        else if (strcmp(a, "--sweep") == 0) o.przeglad = true;
+        else if (strncmp(a, "--range=", 8) == 0) {
+            ZakresParametru z;
+            if (!parsuj_zakres(a + 8, z)) { std::cerr << "Niepoprawny zakres: " << a << std::endl; return false; }
+            o.zakresy.push_back(z);
+        }
+        else if (strncmp(a, "--replications=", 15) == 0) o.replikacje = atoi(a + 15);
+        else if (strncmp(a, "--jobs=", 7) == 0) o.zadania = atoi(a + 7);
+        else if (strncmp(a, "--csv=", 6) == 0) o.plik_csv = a + 6;
+        else if (strcmp(a, "--optimize") == 0) o.optymalizacja = true;
+        else if (strncmp(a, "--target-throughput=", 20) == 0) o.cel_odloty_h = atof(a + 20);
+        else if (strncmp(a, "--target-p99=", 13) == 0) o.cel_p99_s = atof(a + 13);
+        else if (strncmp(a, "--max-trials=", 13) == 0) o.max_prob = atoi(a + 13);
+        else if (strncmp(a, "--cost=", 7) == 0) {
+            const char* rowna = strchr(a + 7, '=');
+            int p = rowna != nullptr ? znajdz_parametr(a + 7, rowna - (a + 7)) : -1;
+            if (p == -1) { std::cerr << "Niepoprawny koszt: " << a << std::endl; return false; }
+            o.koszty.push_back(std::make_pair(p, atoi(rowna + 1)));
+        }
+        else if (strncmp(a, "--trace=", 8) == 0) o.plik_sladu = a + 8;
+        else if (strncmp(a, "--record=", 9) == 0) o.plik_zapisu = a + 9;
+        else if (strncmp(a, "--replay=", 9) == 0) o.plik_odtworzenia = a + 9;
+        else if (strncmp(a, "--flight-log=", 13) == 0) o.plik_dziennika = a + 13;
+        else if (strncmp(a, "--network=", 10) == 0) o.lotniska = atoi(a + 10);
+        else if (strncmp(a, "--flight-time=", 14) == 0) o.czas_lotu_s = atoi(a + 14);
+        else if (strncmp(a, "--network-share=", 16) == 0) o.udzial_sieci = atoi(a + 16);
+        else if (strncmp(a, "--scenario-file=", 16) == 0) o.plik_scenariusza = a + 16;
+        else if (strncmp(a, "--", 2) == 0 && strchr(a, '=') != nullptr &&
+                 znajdz_parametr(a + 2, strchr(a, '=') - (a + 2)) != -1) {
+            int p = znajdz_parametr(a + 2, strchr(a, '=') - (a + 2));
+            o.nadpisania[p] = atoi(strchr(a, '=') + 1);
+            if (o.nadpisania[p] < PARAMETRY[p].min || o.nadpisania[p] > PARAMETRY[p].max) {
+                std::cerr << "Wartosc poza zakresem " << PARAMETRY[p].min << ".." << PARAMETRY[p].max << ": " << a << std::endl;
+                return false;
+            }
+        }
+        else { wypisz_pomoc(argv[0]); return false; }
+    }
+    // Po opcjach: plik uzupełnia tylko to, czego nie podano w linii poleceń
+    if (!o.plik_scenariusza.empty() && !wczytaj_plik_scenariusza(o.plik_scenariusza, o)) return false;
+    if (o.predkosc <= 0) { std::cerr << "Niepoprawna wartosc --speed" << std::endl; return false; }
+    if (o.pula < 0 || o.pula > ZEGAR_MAX_UCZESTNIKOW / 2) { std::cerr << "Niepoprawna wartosc --pool" << std::endl; return false; }
+    if (o.fps < 1 || o.fps > 1000) { std::cerr << "Niepoprawna wartosc --fps" << std::endl; return false; }
+    if (o.lotniska != 0) {
+        if (o.lotniska < 2 || o.lotniska > SIEC_MAX_LOTNISK) { std::cerr << "Niepoprawna wartosc --network" << std::endl; return false; }
+        if (o.czas_lotu_s < 1 || o.czas_lotu_s > 86400) { std::cerr << "Niepoprawna wartosc --flight-time" << std::endl; return false; }
+        if (o.udzial_sieci < 0 || o.udzial_sieci > 100) { std::cerr << "Niepoprawna wartosc --network-share" << std::endl; return false; }
+        if (o.przeglad || o.benchmark || !o.plik_zapisu.empty() || !o.plik_odtworzenia.empty()) {
+            std::cerr << "--network bez --sweep, --benchmark, --record i --replay" << std::endl;
+            return false;
+        }
+        // Lotniska sieci to przebiegi silnika zdarzeń
+        o.nadpisania[PARAM_ENGINE] = SILNIK_ZDARZENIA;
+    }
+    if (o.optymalizacja) {
+        if (o.cel_odloty_h < 0 || o.cel_p99_s < 0 || o.max_prob < 1) {
+            std::cerr << "Niepoprawny cel albo --max-trials" << std::endl;
+            return false;
+        }
+        if (o.przeglad || o.benchmark || o.lotniska != 0 || !o.plik_zapisu.empty() || !o.plik_odtworzenia.empty()) {
+            std::cerr << "--optimize bez --sweep, --benchmark, --network, --record i --replay" << std::endl;
+            return false;
+        }
+    }
+    // Powtarzalny jest tylko zegar wirtualny (zegar.h)
+    if (!o.plik_zapisu.empty() && (o.tryb_zegara != ZEGAR_WIRTUALNY || o.przeglad || o.benchmark)) {
+        std::cerr << "--record wymaga --max-speed (bez --sweep i --benchmark)" << std::endl;
+        return false;
+    }
+    // Silnik zdarzeń sam prowadzi czas wirtualny
+    if (o.nadpisania[PARAM_ENGINE] == SILNIK_ZDARZENIA) o.tryb_zegara = ZEGAR_WIRTUALNY;
+    // Zegar inny niż realny ma sens tylko bez GUI
+    if (o.tryb_zegara != ZEGAR_REALNY) o.headless = true;
+    return true;
+}
+
+// Dziecko ginie razem z nadzorcą (tryb bez GUI kończy się bez kill(0, ...))
+void po_fork_w_dziecku(int slot, int wpis) {
+    // Pętla GUI blokuje SIGINT/SIGCHLD dla signalfd - dziecko nie dziedziczy
+    sigset_t pusta;
+    sigemptyset(&pusta);
+    sigprocmask(SIG_SETMASK, &pusta, nullptr);
+    zegar_slot = slot;
+    if (wpis >= 0) moj_wpis = &rejestr_procesu(wpis);
+    flaga_jednostek = SEM_UNDO;
+    hist_wybierz_shard(getpid());
+    slad_wybierz_pierscien(getpid());
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+    zegar_start();
+}
+
+// Próbka długości kolejek do średnich w raporcie
+void probkuj_kolejki() {
+    SharedData* d = shared_memory;
+    int w_systemie = samoloty_w_systemie(d);
+    int kolejka_pas = d->czeka_na_pas.load();
+    int czeka = 0;
+    for (int i = 0; i < d->cfg_kierunki; i++) czeka += kierunek_terminalu(i).pasazerowie;
+
+    d->probki++;
+    d->probki_w_systemie += w_systemie;
+    d->probki_kolejka_pas += kolejka_pas;
+    d->probki_kolejka_bramka += d->czeka_na_bramke.load();
+    d->probki_pasazerowie_czeka += czeka;
+    int w_powietrzu = d->w_powietrzu.load();
+    d->probki_w_powietrzu += w_powietrzu;
+    d->probki_na_kolowaniu += d->na_kolowaniu.load();
+    d->probki_pasy += d->cfg_runways;
+    d->probki_bramki += d->cfg_gates;
+    if (w_systemie > d->max_w_systemie) d->max_w_systemie = w_systemie;
+    if (kolejka_pas > d->max_kolejka_pas) d->max_kolejka_pas = kolejka_pas;
+    if (w_powietrzu > d->max_w_powietrzu) d->max_w_powietrzu = w_powietrzu;
+}
+
+// Nowi pasażerowie w terminalu w jednym takcie (wspólne z silnikiem zdarzeń)
+void przybycie_pasazerow(int loop_counter) {
+    Losowanie los;
+    los_init(&los, shared_memory->ziarno, LOS_TERMINAL, loop_counter);
+    if (los_ponizej(&los, 100) < shared_memory->cfg_pax_rate) {
+        int kier = los_ponizej(&los, shared_memory->cfg_kierunki);
+        int ile = 1 + los_ponizej(&los, 3);
+        KierunekTerminalu& k = kierunek_terminalu(kier);
+        blokada_wez(&k.blokada);
+        if (shared_memory->off_kolejki != 0) {
+            ile = kolejka_dodaj(&kolejka_pasazerow(kier), miejsca_pasazerow(kier), ile, zegar_teraz_us());
+        }
+        k.pasazerowie += ile;
+        blokada_oddaj(&k.blokada);
+        zmien_panel(PANEL_TERMINAL);
+        shared_memory->stat_pasazerowie_przybyli += ile;
+    }
+
+}
+
+// Jeden takt pętli głównej: ewentualny nowy samolot i nowi pasażerowie.
+// Pidy procesów nowych samolotów (tryb fork) dopisuje do nowe.
+void krok_symulacji(int loop_counter, int& plane_id_counter, std::vector<pid_t>* nowe) {
+    if (loop_counter % shared_memory->cfg_spawn_rate == 0 && shared_memory->cfg_pula > 0) {
+        // Tryb puli: samolot to tylko wpis w kolejce zleceń
+        bool ok = zlec_samolot(plane_id_counter);
+        if (ok) shared_memory->stat_przyloty++; else shared_memory->stat_odrzucone++;
+        if (ok) plane_id_counter++;
+    }
+    else if (loop_counter % shared_memory->cfg_spawn_rate == 0) {
+        czekajace_przyloty.push_back(std::make_pair(plane_id_counter++, zegar_teraz_us()));
+        shared_memory->stat_przyloty++;
+    }
+    if (shared_memory->cfg_pula == 0) wpusc_przyloty(nowe);
+
+    wstrzyknij_awarie(loop_counter);
+    przybycie_pasazerow(loop_counter);
+    probkuj_kolejki();
+}
+
+void wypisz_blokade(const char* nazwa, const char* kierunek, Blokada* b) {
+    long long wejscia = b->wejscia.load();
+    long long spory = b->spory.load();
+    long long przejecia = b->przejecia.load();
+    printf("  %-14s %-3s %12lld / %-10lld (%.3f%%)", nazwa, kierunek, wejscia, spory,
+           wejscia > 0 ? 100.0 * spory / wejscia : 0.0);
+    if (przejecia > 0) printf(", po zabitym %lld", przejecia);
+    printf("\n");
+}
+
+WynikSymulacji zbierz_wynik(int64_t czas_us, double czas_real_s) {
+    SharedData* d = shared_memory;
+    WynikSymulacji w;
+    memset(&w, 0, sizeof(w));
+    w.cfg = d->poczatkowa;
+    w.ziarno = d->ziarno;
+    w.czas_sym_s = czas_us / 1e6;
+    w.czas_real_s = czas_real_s;
+    w.przyloty = d->stat_przyloty.load();
+    w.odrzucone = d->stat_odrzucone.load();
+    w.odloty = d->stat_odloty.load();
+    w.pelne = d->stat_pelne.load();
+    w.pasazerowie_przybyli = d->stat_pasazerowie_przybyli.load();
+    w.pasazerowie_zabrani = d->stat_pasazerowie_zabrani.load();
+    w.bez_paliwa = d->stat_bez_paliwa.load();
+    w.przekierowane = d->stat_przekierowane.load();
+    w.zabite = d->stat_zabite;
+    w.odzyskane = d->stat_odzyskane;
+    w.przyloty_sieci = d->stat_przyloty_sieci.load();
+    w.odloty_sieci = d->stat_odloty_sieci.load();
+    w.w_locie_sieci = d->w_locie_sieci;
+    if (w.odloty > 0) w.sredni_czas_obslugi_s = d->stat_obsluga_suma_us.load() / (double)w.odloty / 1e6;
+    w.max_czas_obslugi_s = d->stat_obsluga_max_us.load() / 1e6;
+    w.p99_czas_obslugi_s = hist_podsumuj(HIST_OBSLUGA).p99 / 1e6;
+    if (d->probki > 0) {
+        w.srednio_w_systemie = (double)d->probki_w_systemie / d->probki;
+        w.srednia_kolejka_pas = (double)d->probki_kolejka_pas / d->probki;
+        w.srednia_kolejka_bramka = (double)d->probki_kolejka_bramka / d->probki;
+        w.srednio_pasazerow_czeka = (double)d->probki_pasazerowie_czeka / d->probki;
+        w.srednio_w_powietrzu = (double)d->probki_w_powietrzu / d->probki;
+        w.srednio_na_kolowaniu = (double)d->probki_na_kolowaniu / d->probki;
+    }
+    w.max_w_systemie = d->max_w_systemie;
+    w.max_kolejka_pas = d->max_kolejka_pas;
+    w.max_w_powietrzu = d->max_w_powietrzu;
+    // Prawo Little'a: średni czas oczekiwania = średnia kolejka / tempo napływu
+    if (w.pasazerowie_przybyli > 0 && w.czas_sym_s > 0) {
+        w.sredni_czas_czekania_pasazera_s = w.srednio_pasazerow_czeka / (w.pasazerowie_przybyli / w.czas_sym_s);
+    }
+    PodsumowanieHistogramu pax = hist_podsumuj(HIST_PASAZER_CZEKANIE);
+    w.zmierzone_czekanie_pasazera_s = pax.srednia / 1e6;
+    w.p99_czekanie_pasazera_s = pax.p99 / 1e6;
+    // Względem średniej liczby czynnych (zmiany w biegu), bez zmian to cfg_runways/cfg_gates
+    double pasy = d->probki > 0 ? (double)d->probki_pasy / d->probki : d->cfg_runways;
+    double bramki = d->probki > 0 ? (double)d->probki_bramki / d->probki : d->cfg_gates;
+    if (czas_us > 0) {
+        w.wykorzystanie_pasow = d->stat_pas_zajety_us.load() / ((double)czas_us * pasy);
+        w.wykorzystanie_bramek = d->stat_gate_zajety_us.load() / ((double)czas_us * bramki);
+    }
+    w.ladowania = (long long)hist_liczba(HIST_LADOWANIE_CZEKANIE);
+    w.starty = (long long)hist_liczba(HIST_START_CZEKANIE);
+    w.p99_czekanie_ladowanie_s = hist_podsumuj(HIST_LADOWANIE_CZEKANIE).p99 / 1e6;
+    w.p99_czekanie_start_s = hist_podsumuj(HIST_START_CZEKANIE).p99 / 1e6;
+    w.p99_czekanie_bramka_s = hist_podsumuj(HIST_BRAMKA_CZEKANIE).p99 / 1e6;
+    w.p99_czekanie_cysterna_s = hist_podsumuj(HIST_CYSTERNA_CZEKANIE).p99 / 1e6;
+    w.p99_czekanie_paliwo_s = hist_podsumuj(HIST_PALIWO_CZEKANIE).p99 / 1e6;
+    if (d->stat_gate_zajety_us > 0) w.paliwo_w_bramkach = (double)d->stat_paliwo_czekanie_us / d->stat_gate_zajety_us;
+    if (czas_us > 0) w.niedobor_paliwa = (double)magazyn_czas_braku_us(&d->magazyn) / czas_us;
+    // Bez blokad - ich czasy są rzeczywiste
+    w.skrot_histogramow = 0xCBF29CE484222325ULL;
+    for (int m = 0; m < HIST_BLOKADA_CZEKANIE; m++) w.skrot_histogramow = hist_skrot(m, w.skrot_histogramow);
+    return w;
+}
+
+void raport_bez_gui(int64_t czas_us, double czas_real_s) {
+    SharedData* d = shared_memory;
+    WynikSymulacji w = zbierz_wynik(czas_us, czas_real_s);
+    double godziny = czas_us / 3600e6;
+    double odloty = (double)d->stat_odloty;
+    int waiting = 0;
+    for (int i = 0; i < d->cfg_kierunki; i++) waiting += kierunek_terminalu(i).pasazerowie;
+
+    printf("============================================\n");
+    printf(" RAPORT: %s\n", d->scenariusz_nazwa);
+    printf("============================================\n");
+    printf("Czas symulacji:        %.1f h (%.2f s rzeczywistych, x%.0f)\n",
+           godziny, czas_real_s, czas_real_s > 0 ? (czas_us / 1e6) / czas_real_s : 0.0);
+    printf("Samoloty przylecialy:  %lld (odrzucone: %lld)\n", d->stat_przyloty.load(), d->stat_odrzucone.load());
+    printf("Odloty:                %lld (%.1f / h), z kompletem: %lld\n",
+           d->stat_odloty.load(), godziny > 0 ? odloty / godziny : 0.0, d->stat_pelne.load());
+    printf("W systemie na koniec:  %d", samoloty_w_systemie(d));
+    if (samoloty_bez_procesu(d) > 0) printf(" (czeka na proces obslugi: %d)", samoloty_bez_procesu(d));
+    printf("\n");
+    printf("Pasazerowie:           przybyli %lld, zabrani %lld (%.1f / h), czekaja %d\n",
+           d->stat_pasazerowie_przybyli.load(), d->stat_pasazerowie_zabrani.load(),
+           godziny > 0 ? d->stat_pasazerowie_zabrani / godziny : 0.0, waiting);
+    printf("Przydzial kierunkow:   %s\n", NAZWY_PRZYDZIALU[d->cfg_przydzial_kierunkow]);
+    printf("Silnik:                %s\n", NAZWY_SILNIKOW[d->cfg_silnik]);
+    printf("Sredni zaladunek:      %.1f%%\n",
+           odloty > 0 ? 100.0 * d->stat_pasazerowie_zabrani / (odloty * d->cfg_plane_capacity) : 0.0);
+    printf("Czas obslugi:          sredni %.2f s, p99 %.2f s, max %.2f s\n",
+           odloty > 0 ? d->stat_obsluga_suma_us / odloty / 1e6 : 0.0, w.p99_czas_obslugi_s,
+           d->stat_obsluga_max_us / 1e6);
+    printf("Wykorzystanie pasow:   %.1f%%\n", 100.0 * w.wykorzystanie_pasow);
+    printf("Wykorzystanie bramek:  %.1f%% (obsluga %s)\n", 100.0 * w.wykorzystanie_bramek,
+           d->cfg_obsluga_rownolegla ? "rownolegla" : "kolejna");
+    if (d->stat_zmiany > 0) {
+        printf("Zmiany w biegu:        %lld; na koniec pasy %d, bramki %d, cysterny %d (zainstalowane %d/%d/%d)\n",
+               d->stat_zmiany, d->cfg_runways, d->cfg_gates, d->cfg_tankers, d->cfg_max_pasow, d->cfg_max_bramek,
+               d->cfg_max_cystern);
+    }
+    printf("Samoloty w systemie:   srednio %.1f, max %d\n", w.srednio_w_systemie, w.max_w_systemie);
+    printf("Kolejka do pasa:       srednio %.2f, max %d\n", w.srednia_kolejka_pas, w.max_kolejka_pas);
+    printf("Wieza (pasy):          %s, %.1f operacji / h\n", NAZWY_POLITYK[d->cfg_polityka_pasow],
+           godziny > 0 ? (w.ladowania + w.starty) / godziny : 0.0);
+    for (int m = HIST_LADOWANIE_CZEKANIE; m <= HIST_START_CZEKANIE; m++) {
+        PodsumowanieHistogramu p = hist_podsumuj(m);
+        char srednia[16], p99[16];
+        formatuj_czas(srednia, sizeof(srednia), m, (uint64_t)p.srednia);
+        formatuj_czas(p99, sizeof(p99), m, p.p99);
+        printf("  %-20s %llu (%.1f / h), srednio %s, p99 %s\n", NAZWY_METRYK[m], (unsigned long long)p.liczba,
+               godziny > 0 ? p.liczba / godziny : 0.0, srednia, p99);
+    }
+    printf("Kolejka do bramki:     srednio %.2f\n", w.srednia_kolejka_bramka);
+    printf("Krazace w powietrzu:   srednio %.2f, max %d, przekierowane %lld\n",
+           w.srednio_w_powietrzu, w.max_w_powietrzu, w.przekierowane);
+    if (d->cfg_zabijanie > 0 || w.zabite > 0) {
+        printf("Zabite w obsludze:     %lld (kill-every %d s), odzyskane zasoby %lld\n", w.zabite,
+               d->cfg_zabijanie, w.odzyskane);
+    }
+    if (d->cfg_kolowanie > 0) {
+        printf("Droga kolowania:       srednio %.2f z %d miejsc\n", w.srednio_na_kolowaniu, d->cfg_kolowanie);
+    } else {
+        printf("Droga kolowania:       brak (bramka brana na pasie)\n");
+    }
+    printf("Czekanie pasazera:     ~%.1f s (prawo Little'a)\n", w.sredni_czas_czekania_pasazera_s);
+    if (d->off_kolejki != 0) {
+        // Rozkład z rekordów pasażerów, osobno na kierunek
+        printf("  %-8s %10s %10s %10s %10s %10s %10s\n", "kierunek", "zabrani", "srednia", "p50", "p99", "max",
+               "odrzuceni");
+        for (int i = 0; i < d->cfg_kierunki; i++) {
+            const KolejkaPasazerow& k = kolejka_pasazerow(i);
+            PodsumowanieHistogramu p = hist_podsumuj_w(&k.czekanie);
+            char srednia[16], p50[16], p99[16], max[16];
+            formatuj_czas(srednia, sizeof(srednia), HIST_PASAZER_CZEKANIE, (uint64_t)p.srednia);
+            formatuj_czas(p50, sizeof(p50), HIST_PASAZER_CZEKANIE, p.p50);
+            formatuj_czas(p99, sizeof(p99), HIST_PASAZER_CZEKANIE, p.p99);
+            formatuj_czas(max, sizeof(max), HIST_PASAZER_CZEKANIE, p.max);
+            printf("  %-8s %10llu %10s %10s %10s %10s %10lld\n", kierunek_terminalu(i).nazwa,
+                   (unsigned long long)p.liczba, srednia, p50, p99, max, k.odrzuceni);
+        }
+    }
+    PodsumowanieHistogramu paliwo = hist_podsumuj(HIST_PALIWO_CZEKANIE);
+    printf("Czekanie na paliwo:    %lld tankowan, p99 %.1f s, niedobor %.1f%% czasu\n", d->stat_bez_paliwa.load(),
+           paliwo.p99 / 1e6, 100.0 * w.niedobor_paliwa);
+    printf("                       %.1f%% zajecia bramek (dostawa %d L co %d s)\n", 100.0 * w.paliwo_w_bramkach,
+           d->cfg_dostawa_paliwa, d->cfg_czas_dostawy);
+    printf("Paliwo w magazynie:    %d L\n", d->magazyn.stan.load());
+
+    // Rywalizacja o blokady: odsetek wejść, które musiały czekać
+    printf("Blokady (wejscia / spory):\n");
+    for (int i = 0; i < d->cfg_kierunki; i++) {
+        wypisz_blokade("terminal", kierunek_terminalu(i).nazwa, &kierunek_terminalu(i).blokada);
+    }
+    wypisz_blokade("przydzial", "", &d->blokada_przydzialu);
+    wypisz_blokade("kolejka puli", "", &d->blokada_zadan);
+    wypisz_blokade("wieza", "", &d->wieza.blokada);
+    wypisz_blokade("logi", "", &d->blokada_logow);
+
+    printf("Czasy czekania / zajecia:   %8s %10s %10s %10s %10s\n", "liczba", "srednia", "p50", "p99", "max");
+    for (int m = 0; m < LICZBA_METRYK; m++) {
+        PodsumowanieHistogramu p = hist_podsumuj(m);
+        char srednia[16], p50[16], p99[16], max[16];
+        formatuj_czas(srednia, sizeof(srednia), m, (uint64_t)p.srednia);
+        formatuj_czas(p50, sizeof(p50), m, p.p50);
+        formatuj_czas(p99, sizeof(p99), m, p.p99);
+        formatuj_czas(max, sizeof(max), m, p.max);
+        printf("  %-24s %8llu %10s %10s %10s %10s\n", NAZWY_METRYK[m], (unsigned long long)p.liczba,
+               srednia, p50, p99, max);
+    }
+    fflush(stdout);
+}
+
+// Raport (albo wynik rurą), zapis przebiegu i sprzątanie IPC; nie wraca
+void zakoncz_bez_gui(const OpcjeUruchomienia& opcje, int scenariusz, double real_s) {
+    WynikSymulacji w = zbierz_wynik(zegar_teraz_us(), real_s);
+    if (opcje.wynik_fd >= 0) {
+        if (write(opcje.wynik_fd, &w, sizeof(w)) != sizeof(w)) perror("write");
+    } else {
+        raport_bez_gui(zegar_teraz_us(), real_s);
+    }
+    if (!opcje.plik_zapisu.empty() && zapisz_przebieg(opcje.plik_zapisu, scenariusz, opcje, w)) {
+        printf("Zapis przebiegu:       %s (skrot %016llx)\n", opcje.plik_zapisu.c_str(),
+               (unsigned long long)skrot_wyniku(w));
+    }
+
+    zakoncz_slad();
+    dziennik_zamknij(zegar_teraz_us());
+
+    // Dzieci giną przez PR_SET_PDEATHSIG po wyjściu nadzorcy
+    if (opcje.wynik_fd >= 0) close(opcje.wynik_fd);
+    shmdt(shared_memory);
+    shmctl(shmid, IPC_RMID, nullptr);
+    semctl(semid, 0, IPC_RMID);
+    exit(0);
+}
+
+void wykonaj_zmiany(int64_t teraz_us);     // ZMIANY W BIEGU
+
+void petla_bez_gui(const OpcjeUruchomienia& opcje, int scenariusz) {
+    int loop_counter = 0;
+    int plane_id_counter = 1;
+    int64_t koniec_us = opcje.czas_symulacji_s * 1000000LL;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    while (zegar_teraz_us() < koniec_us) {
+        wykonaj_zmiany(zegar_teraz_us());
+        krok_symulacji(loop_counter, plane_id_counter, nullptr);
+        loop_counter++;
+        zbierz_procesy();
+        zegar_spij_us(TAKT_US);
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    zakoncz_bez_gui(opcje, scenariusz, (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+}
+
+// =============================================================
+// =======  SILNIK ZDARZEŃ (--engine=1, zdarzenia.h)  ==========
+// =============================================================
+//
+// Te same fazy co obsluz_samolot i ten sam model zasobów w segmencie
+// (liczniki, histogramy, rekordy, kierunki, magazyn), ale samolot to
+// rekord z fazą, a czekanie to wpis na liście zamiast semafora, wieży
+// czy futeksu. Semafory zegara wirtualnego, wieża i magazyn mają tu
+// odpowiedniki o tej samej kolejności obsługi: przekazanie jednostki
+// pierwszemu czekającemu, polityka pasów z wieza.h, FIFO do paliwa.
+// Wynik zgadza się z silnikiem procesów statystycznie, nie co do
+// zdarzenia (inna kolejność w tej samej chwili).
+
+enum FazaSamolotu {
+    FS_PRZYLOT = 0,
+    FS_KOLOWANIE,           // Po zgodzie na drogę kołowania (albo bez niej)
+    FS_PAS_LADOWANIE,       // Po przydziale pasa do lądowania albo po terminie
+    FS_PRZEKIEROWANIE,
+    FS_PO_LADOWANIU,
+    FS_BRAMKA,
+    FS_PRZED_CYSTERNA,      // Po sprzątaniu i cateringu (obsługa kolejna)
+    FS_CYSTERNA,
+    FS_PALIWO,
+    FS_PO_TANKOWANIU,
+    FS_PO_BOARDINGU,
+    FS_PAS_START,
+    FS_ODLOT
+};
+
+struct SamolotZdarzen {
+    int id;                     // 0 = rekord wolny
+    int faza;
+    uint32_t epoka;
+    ListaCzekajacych* czeka_na; // Lista, z której zdejmuje termin
+    bool wynik;                 // Czekanie zakończone przydziałem (false = termin)
+    Losowanie los;
+    int kierunek;
+    int pas;
+    int zwolniony_pas;
+    int bramka;
+    int cysterna;
+    int pasazerowie;            // Zabrani przy boardingu
+    long long bilet;            // Kolejność zgłoszeń do pasa
+    int64_t t_przylot;
+    int64_t t_czeka;
+    int64_t t_pas;
+    int64_t t_ladowanie;
+    int pas_ladowania;
+    int64_t t_gate;
+    int64_t t_cysterna;
+    int64_t termin;
+    int64_t pas_zajety;
+    int64_t gate_zajety;
+    int64_t koniec_boardingu;
+    int64_t koniec_obslugi;
+    int nastepny_wolny;
+};
+
+struct SemaforZdarzen {
+    int wartosc;
+    ListaCzekajacych czekajacy;
+};
+
+struct SilnikZdarzen {
+    int64_t teraz_us;
+    KolejkaZdarzen kolejka;
+    std::vector<SamolotZdarzen> samoloty;
+    std::vector<WezelCzekania> wezly;      // Węzły list czekających, indeks jak samoloty
+    int wolny;                             // Lista wolnych rekordów
+
+    SemaforZdarzen kolowanie;
+    SemaforZdarzen bramki;
+    SemaforZdarzen cysterny;
+
+    // Pasy: wolne w kolejności zwolnienia (najdłużej wolny pierwszy, jak w wieży)
+    StanPolitykiPasow polityka;
+    ListaCzekajacych do_pasa[LICZBA_OPERACJI];
+    long long nastepny_bilet;
+    std::vector<int> wolne_pasy;           // Pierścień na wszystkie zainstalowane
+    size_t wolne_pasy_glowa;
+    int ile_wolnych_pasow;
+    int pasy_do_zamkniecia;                // Jak w wieży (wieza_zmien_pasy)
+    std::vector<int> zamkniete_pasy;
+
+    ListaCzekajacych do_paliwa;
+
+    // Sieć lotnisk (siec.h): -1 = lotnisko samodzielne
+    int lotnisko;
+    uint32_t nastepny_lot;
+    PrzylotySieci przyloty;
+};
+
+static SilnikZdarzen silnik;
+
+static int silnik_nowy_samolot(int id, int64_t t_przylot) {
+    if (silnik.wolny == -1) {
+        silnik.samoloty.push_back(SamolotZdarzen());
+        silnik.wezly.push_back(WezelCzekania());
+        silnik.samoloty.back().nastepny_wolny = -1;
+        silnik.samoloty.back().epoka = 0;
+        silnik.wolny = (int)silnik.samoloty.size() - 1;
+    }
+    int idx = silnik.wolny;
+    SamolotZdarzen& s = silnik.samoloty[idx];
+    silnik.wolny = s.nastepny_wolny;
+    uint32_t epoka = s.epoka;
+    s = SamolotZdarzen();
+    s.epoka = epoka;                       // Stare zdarzenia rekordu zostają nieaktualne
+    s.id = id;
+    s.faza = FS_PRZYLOT;
+    s.t_przylot = t_przylot;
+    los_init(&s.los, shared_memory->ziarno, LOS_SAMOLOT, id);
+    return idx;
+}
+
+static void silnik_zwolnij_samolot(int idx) {
+    SamolotZdarzen& s = silnik.samoloty[idx];
+    s.id = 0;
+    s.epoka++;
+    s.nastepny_wolny = silnik.wolny;
+    silnik.wolny = idx;
+}
+
+static void silnik_zaplanuj(int idx, int64_t czas_us) {
+    SamolotZdarzen& s = silnik.samoloty[idx];
+    zdarzenia_dodaj(&silnik.kolejka, czas_us, idx, ++s.epoka);
+}
+
+// Upływ czasu; true = bez czekania (us <= 0, jak zegar_spij_us)
+static bool silnik_spij(int idx, int64_t us) {
+    if (us <= 0) return true;
+    silnik_zaplanuj(idx, silnik.teraz_us + us);
+    return false;
+}
+
+static void silnik_czekaj(ListaCzekajacych* l, int idx, int64_t termin_us, int64_t priorytet) {
+    SamolotZdarzen& s = silnik.samoloty[idx];
+    lista_dopisz(l, silnik.wezly.data(), idx, priorytet);
+    s.czeka_na = l;
+    s.epoka++;
+    if (termin_us != INT64_MAX) zdarzenia_dodaj(&silnik.kolejka, termin_us, idx, s.epoka);
+}
+
+// Przydział zasobu czekającemu (już zdjętemu z listy); rusza w tej chwili
+static void silnik_obudz(int idx) {
+    SamolotZdarzen& s = silnik.samoloty[idx];
+    s.czeka_na = nullptr;
+    s.wynik = true;
+    silnik_zaplanuj(idx, silnik.teraz_us);
+}
+
+// Jak zegar_sem_p_do / zegar_sem_p_prio; true = rozstrzygnięte od razu (wynik w s.wynik)
+static bool silnik_sem_p(SemaforZdarzen* sem, int idx, int64_t termin_us, int64_t priorytet) {
+    SamolotZdarzen& s = silnik.samoloty[idx];
+    if (sem->wartosc > 0) {
+        sem->wartosc--;
+        s.wynik = true;
+        return true;
+    }
+    if (termin_us <= silnik.teraz_us) {
+        s.wynik = false;
+        return true;
+    }
+    silnik_czekaj(&sem->czekajacy, idx, termin_us, priorytet);
+    return false;
+}
+
+static void silnik_sem_v(SemaforZdarzen* sem) {
+    int idx = lista_zdejmij(&sem->czekajacy, silnik.wezly.data());
+    if (idx == -1) sem->wartosc++;
+    else silnik_obudz(idx);
+}
+
+// Jak wieza_wez_pas; pas w s.pas (-1 = minął termin)
+static bool silnik_wez_pas(int idx, int rodzaj, int64_t termin_us) {
+    SamolotZdarzen& s = silnik.samoloty[idx];
+    if (silnik.ile_wolnych_pasow > 0) {
+        s.pas = silnik.wolne_pasy[silnik.wolne_pasy_glowa];
+        silnik.wolne_pasy_glowa = (silnik.wolne_pasy_glowa + 1) % silnik.wolne_pasy.size();
+        silnik.ile_wolnych_pasow--;
+        polityka_pasow_zalicz(&silnik.polityka, rodzaj);
+        s.wynik = true;
+        return true;
+    }
+    s.pas = -1;
+    if (termin_us <= silnik.teraz_us) {
+        s.wynik = false;
+        return true;
+    }
+    s.bilet = silnik.nastepny_bilet++;
+    silnik_czekaj(&silnik.do_pasa[rodzaj], idx, termin_us, INT64_MAX);
+    return false;
+}
+
+static void silnik_zwolnij_pas(int pas) {
+    if (silnik.pasy_do_zamkniecia > 0) {
+        silnik.pasy_do_zamkniecia--;
+        silnik.zamkniete_pasy.push_back(pas);
+        return;
+    }
+    int lad = silnik.do_pasa[OP_LADOWANIE].glowa;
+    int start = silnik.do_pasa[OP_START].glowa;
+    int rodzaj = polityka_pasow_wybierz(&silnik.polityka, lad == -1 ? -1 : silnik.samoloty[lad].bilet,
+                                        start == -1 ? -1 : silnik.samoloty[start].bilet);
+    if (rodzaj == -1) {
+        size_t n = silnik.wolne_pasy.size();
+        silnik.wolne_pasy[(silnik.wolne_pasy_glowa + silnik.ile_wolnych_pasow) % n] = pas;
+        silnik.ile_wolnych_pasow++;
+        return;
+    }
+    int idx = lista_zdejmij(&silnik.do_pasa[rodzaj], silnik.wezly.data());
+    polityka_pasow_zalicz(&silnik.polityka, rodzaj);
+    silnik.samoloty[idx].pas = pas;
+    silnik_obudz(idx);
+}
+
+// Jak magazyn_pobierz: rezerwacja, przy braku FIFO do dostawy
+static bool silnik_pobierz_paliwo(int idx, int ilosc) {
+    MagazynPaliwa* m = &shared_memory->magazyn;
+    int stan = m->stan.load(std::memory_order_relaxed);
+    if (silnik.do_paliwa.glowa == -1 && stan >= ilosc) {
+        m->stan.store(stan - ilosc, std::memory_order_relaxed);
+        return true;
+    }
+    if (m->czekajacy++ == 0) m->brak_od_us = silnik.teraz_us;
+    silnik_czekaj(&silnik.do_paliwa, idx, INT64_MAX, INT64_MAX);
+    return false;
+}
+
+// Jak proces_dostawcy_paliwa + magazyn_dostarcz (wszyscy czekają na FUEL_NEEDED)
+static void silnik_dostawa() {
+    SharedData* d = shared_memory;
+    MagazynPaliwa* m = &d->magazyn;
+    int stan = std::min(m->stan.load(std::memory_order_relaxed) + d->cfg_dostawa_paliwa, m->pojemnosc);
+    while (silnik.do_paliwa.glowa != -1 && stan >= FUEL_NEEDED) {
+        stan -= FUEL_NEEDED;
+        silnik_obudz(lista_zdejmij(&silnik.do_paliwa, silnik.wezly.data()));
+        if (--m->czekajacy == 0) {
+            m->brak_us += silnik.teraz_us - m->brak_od_us;
+            m->brak_od_us = -1;
+        }
+    }
+    m->stan.store(stan, std::memory_order_relaxed);
+    slad_zapisz(silnik.teraz_us, ZD_DOSTAWA_PALIWA, 0, -1, stan);
+
+    d->nastepna_dostawa = silnik.teraz_us / 1000000 + d->cfg_czas_dostawy;
+}
+
+// Fazy obsluz_samolot; wraca, gdy samolot czeka (faza = co dalej) albo odleciał
+static void krok_samolotu(int idx) {
+    SharedData* d = shared_memory;
+    bool kolowanie = d->cfg_kolowanie > 0;
+    bool rownolegle = d->cfg_obsluga_rownolegla != 0;
+    while (true) {
+        SamolotZdarzen& s = silnik.samoloty[idx];
+        int64_t teraz = silnik.teraz_us;
+        switch (s.faza) {
+        case FS_PRZYLOT:
+            d->aktywne_samoloty++;
+            s.kierunek = los_ponizej(&s.los, d->cfg_kierunki);
+            slad_zapisz(s.t_przylot, ZD_PRZYLOT, s.id, -1, s.kierunek);
+            s.termin = (d->cfg_przekierowanie > 0) ? s.t_przylot + d->cfg_przekierowanie * 1000000LL : INT64_MAX;
+            d->w_powietrzu++;
+            d->czeka_na_pas++;
+            s.faza = FS_KOLOWANIE;
+            s.wynik = true;
+            if (kolowanie && !silnik_sem_p(&silnik.kolowanie, idx, s.termin, INT64_MAX)) return;
+            break;
+
+        case FS_KOLOWANIE:
+            s.t_czeka = teraz;
+            if (!s.wynik) { s.faza = FS_PRZEKIEROWANIE; break; }
+            s.faza = FS_PAS_LADOWANIE;
+            if (!silnik_wez_pas(idx, OP_LADOWANIE, s.termin)) return;
+            break;
+
+        case FS_PAS_LADOWANIE:
+            if (!s.wynik) {
+                if (kolowanie) silnik_sem_v(&silnik.kolowanie);
+                s.faza = FS_PRZEKIEROWANIE;
+                break;
+            }
+            d->czeka_na_pas--;
+            d->w_powietrzu--;
+            s.t_pas = teraz;
+            hist_zapisz(HIST_KRAZENIE, s.t_pas - s.t_przylot);
+            hist_zapisz(HIST_LADOWANIE_CZEKANIE, s.t_pas - s.t_czeka);
+            ustaw_pas(s.pas, s.id);
+            slad_zapisz(s.t_pas, ZD_LADOWANIE, s.id, s.pas, 0);
+            s.t_ladowanie = s.t_pas;
+            s.pas_ladowania = s.pas;
+            s.faza = FS_PO_LADOWANIU;
+            if (!silnik_spij(idx, d->cfg_landing_time)) return;
+            break;
+
+        case FS_PRZEKIEROWANIE:
+            d->czeka_na_pas--;
+            d->w_powietrzu--;
+            hist_zapisz(HIST_KRAZENIE, teraz - s.t_przylot);
+            d->aktywne_samoloty--;
+            d->stat_przekierowane++;
+            slad_zapisz(teraz, ZD_PRZEKIEROWANY, s.id, -1, 0);
+            silnik_zwolnij_samolot(idx);
+            return;
+
+        case FS_PO_LADOWANIU:
+            s.t_czeka = teraz;
+            if (kolowanie) {
+                ustaw_pas(s.pas, 0);
+                silnik_zwolnij_pas(s.pas);
+                s.pas_zajety = teraz - s.t_pas;
+                hist_zapisz(HIST_PAS_ZAJETY, s.pas_zajety);
+                slad_zapisz(teraz, ZD_ZJAZD_Z_PASA, s.id, s.pas, 0);
+                d->na_kolowaniu++;
+            } else {
+                slad_zapisz(teraz, ZD_WYLADOWAL, s.id, s.pas, 0);
+            }
+            d->czeka_na_bramke++;
+            s.faza = FS_BRAMKA;
+            if (!silnik_sem_p(&silnik.bramki, idx, INT64_MAX, INT64_MAX)) return;
+            break;
+
+        case FS_BRAMKA: {
+            d->czeka_na_bramke--;
+            s.zwolniony_pas = -1;
+            if (kolowanie) {
+                d->na_kolowaniu--;
+                silnik_sem_v(&silnik.kolowanie);
+            } else {
+                ustaw_pas(s.pas, 0);
+                silnik_zwolnij_pas(s.pas);
+                s.pas_zajety = teraz - s.t_pas;
+                hist_zapisz(HIST_PAS_ZAJETY, s.pas_zajety);
+                s.zwolniony_pas = s.pas;
+            }
+            s.t_gate = teraz;
+            hist_zapisz(HIST_BRAMKA_CZEKANIE, s.t_gate - s.t_czeka);
+            s.kierunek = przydziel_kierunek(s.kierunek);
+            s.bramka = sloty_zajmij(&d->wolne_bramki, los_ponizej(&s.los, d->cfg_gates));
+            ustaw_bramke(s.bramka, s.id, s.kierunek, 0);
+            slad_zapisz(s.t_gate, ZD_BRAMKA, s.id, s.bramka, s.zwolniony_pas);
+
+            int64_t sprzatanie = d->cfg_sprzatanie * 1000000LL;
+            int64_t catering = d->cfg_catering * 1000000LL;
+            s.koniec_boardingu = s.t_gate + sprzatanie + d->cfg_boarding_time * 1000000LL;
+            s.koniec_obslugi = std::max(s.koniec_boardingu, s.t_gate + catering);
+            s.faza = FS_PRZED_CYSTERNA;
+            if (!rownolegle && !silnik_spij(idx, sprzatanie + catering)) return;
+            break;
+        }
+
+        case FS_PRZED_CYSTERNA:
+            s.t_czeka = teraz;
+            d->czeka_na_cysterne++;
+            s.faza = FS_CYSTERNA;
+            if (!silnik_sem_p(&silnik.cysterny, idx, INT64_MAX, rownolegle ? s.koniec_boardingu : INT64_MAX)) return;
+            break;
+
+        case FS_CYSTERNA:
+            d->czeka_na_cysterne--;
+            s.t_cysterna = teraz;
+            hist_zapisz(HIST_CYSTERNA_CZEKANIE, s.t_cysterna - s.t_czeka);
+            s.cysterna = sloty_zajmij(&d->wolne_cysterny, los_ponizej(&s.los, d->cfg_tankers));
+            ustaw_cysterne(s.cysterna, s.id);
+            slad_zapisz(s.t_cysterna, ZD_CYSTERNA, s.id, s.cysterna, 0);
+            s.faza = FS_PALIWO;
+            if (!silnik_pobierz_paliwo(idx, FUEL_NEEDED)) return;
+            break;
+
+        case FS_PALIWO: {
+            int64_t czekanie_paliwo = teraz - s.t_cysterna;
+            hist_zapisz(HIST_PALIWO_CZEKANIE, czekanie_paliwo);
+            if (czekanie_paliwo > 0) {
+                d->stat_bez_paliwa++;
+                d->stat_paliwo_czekanie_us += czekanie_paliwo;
+                slad_zapisz(s.t_cysterna, ZD_BRAK_PALIWA, s.id, s.cysterna, 0);
+                slad_zapisz(teraz, ZD_PALIWO, s.id, s.cysterna, 0);
+            }
+            s.faza = FS_PO_TANKOWANIU;
+            if (!silnik_spij(idx, CZAS_TANKOWANIA_US)) return;
+            break;
+        }
+
+        case FS_PO_TANKOWANIU:
+            if (!zamknij_zwalniana_cysterne(s.cysterna)) {
+                ustaw_cysterne(s.cysterna, 0);
+                sloty_zwolnij(&d->wolne_cysterny, s.cysterna);
+                silnik_sem_v(&silnik.cysterny);
+            }
+            hist_zapisz(HIST_CYSTERNA_ZAJETA, teraz - s.t_cysterna);
+            slad_zapisz(teraz, ZD_BOARDING, s.id, s.cysterna, 0);
+            s.faza = FS_PO_BOARDINGU;
+            if (!silnik_spij(idx, rownolegle ? s.koniec_obslugi - teraz : d->cfg_boarding_time * 1000000LL)) return;
+            break;
+
+        case FS_PO_BOARDINGU: {
+            KierunekTerminalu& kierunek = kierunek_terminalu(s.kierunek);
+            int capacity = d->cfg_plane_capacity;
+            blokada_wez(&kierunek.blokada);
+            int ludzie_w_terminalu = kierunek.pasazerowie;
+            int do_zabrania = (ludzie_w_terminalu < capacity) ? ludzie_w_terminalu : capacity;
+            if (d->off_kolejki != 0) {
+                do_zabrania = kolejka_zabierz(&kolejka_pasazerow(s.kierunek), miejsca_pasazerow(s.kierunek),
+                                              capacity, teraz);
+            }
+            if (do_zabrania > 0) kierunek.pasazerowie -= do_zabrania;
+            blokada_oddaj(&kierunek.blokada);
+            oddaj_kierunek(s.kierunek);
+
+            if (!zamknij_zwalniana_bramke(s.bramka)) {
+                ustaw_bramke(s.bramka, 0, -1, 0);
+                sloty_zwolnij(&d->wolne_bramki, s.bramka);
+                silnik_sem_v(&silnik.bramki);
+            }
+            s.pasazerowie = do_zabrania;
+            s.t_czeka = teraz;
+            s.gate_zajety = teraz - s.t_gate;
+            hist_zapisz(HIST_BRAMKA_ZAJETA, s.gate_zajety);
+            slad_zapisz(teraz, ZD_BRAMKA_ZWOLNIONA, s.id, s.bramka, do_zabrania);
+
+            d->czeka_na_pas++;
+            s.faza = FS_PAS_START;
+            if (!silnik_wez_pas(idx, OP_START, INT64_MAX)) return;
+            break;
+        }
+
+        case FS_PAS_START:
+            d->czeka_na_pas--;
+            s.t_pas = teraz;
+            hist_zapisz(HIST_START_CZEKANIE, s.t_pas - s.t_czeka);
+            ustaw_pas(s.pas, -s.id);
+            slad_zapisz(s.t_pas, ZD_START, s.id, s.pas, 0);
+            s.faza = FS_ODLOT;
+            if (!silnik_spij(idx, czas_startu_us())) return;
+            break;
+
+        case FS_ODLOT:
+            ustaw_pas(s.pas, 0);
+            silnik_zwolnij_pas(s.pas);
+            s.pas_zajety += teraz - s.t_pas;
+            hist_zapisz(HIST_PAS_ZAJETY, teraz - s.t_pas);
+            slad_zapisz(teraz, ZD_ODLOT, s.id, s.pas, s.pasazerowie);
+
+            d->aktywne_samoloty--;
+            d->stat_odloty++;
+            if (s.pasazerowie >= d->cfg_plane_capacity) d->stat_pelne++;
+            d->stat_pasazerowie_zabrani += s.pasazerowie;
+            d->stat_obsluga_suma_us += teraz - s.t_przylot;
+            hist_zapisz(HIST_OBSLUGA, teraz - s.t_przylot);
+            atomic_max(d->stat_obsluga_max_us, teraz - s.t_przylot);
+            d->stat_pas_zajety_us += s.pas_zajety;
+            d->stat_gate_zajety_us += s.gate_zajety;
+            dziennik_dopisz(RekordLotu{ s.id, (int16_t)s.kierunek, (int16_t)s.pas_ladowania, (int16_t)s.pas,
+                                        (int16_t)s.bramka, (int16_t)s.cysterna, s.pasazerowie, FUEL_NEEDED,
+                                        s.t_przylot, s.t_ladowanie, s.t_gate, s.t_cysterna, s.t_pas, teraz });
+            if (silnik.lotnisko >= 0 && los_ponizej(&s.los, 100) < siec->udzial) {
+                LotSieci lot = { teraz + siec->okno_us, (uint32_t)silnik.lotnisko, silnik.nastepny_lot++ };
+                siec_wyslij(siec, siec_cel(siec, silnik.lotnisko, s.kierunek), lot, &silnik.przyloty);
+                d->stat_odloty_sieci++;
+            }
+            silnik_zwolnij_samolot(idx);
+            return;
+        }
+    }
+}
+
+static void silnik_init(int lotnisko) {
+    SharedData* d = shared_memory;
+    silnik.teraz_us = 0;
+    zdarzenia_init(&silnik.kolejka);
+    silnik.samoloty.clear();
+    silnik.wezly.clear();
+    silnik.wolny = -1;
+
+    silnik.kolowanie.wartosc = d->cfg_kolowanie;
+    silnik.bramki.wartosc = d->cfg_gates;
+    silnik.cysterny.wartosc = d->cfg_tankers;
+    lista_init(&silnik.kolowanie.czekajacy);
+    lista_init(&silnik.bramki.czekajacy);
+    lista_init(&silnik.cysterny.czekajacy);
+
+    polityka_pasow_init(&silnik.polityka, d->cfg_polityka_pasow, d->cfg_paczka_pasow, d->cfg_landing_time,
+                        czas_startu_us());
+    for (int r = 0; r < LICZBA_OPERACJI; r++) lista_init(&silnik.do_pasa[r]);
+    silnik.nastepny_bilet = 0;
+    silnik.wolne_pasy.resize(d->cfg_max_pasow);
+    for (int p = 0; p < d->cfg_runways; p++) silnik.wolne_pasy[p] = p;
+    silnik.wolne_pasy_glowa = 0;
+    silnik.ile_wolnych_pasow = d->cfg_runways;
+    silnik.pasy_do_zamkniecia = 0;
+    silnik.zamkniete_pasy.clear();
+    for (int p = d->cfg_runways; p < d->cfg_max_pasow; p++) silnik.zamkniete_pasy.push_back(p);
+
+    lista_init(&silnik.do_paliwa);
+
+    silnik.lotnisko = lotnisko;
+    silnik.nastepny_lot = 0;
+    silnik.przyloty.kopiec.clear();
+}
+
+// Odpowiednik petla_bez_gui. Takt terminalu i dostawa stoją poza kopcem:
+// w tej samej chwili idą przed samolotami, jak nadzorca i dostawca
+// (najniższe sloty) w zegarze wirtualnym. W sieci lotnisk (siec.h) także
+// przyloty z innych lotnisk, a przed każdym końcem okna bariera.
+void petla_zdarzen(const OpcjeUruchomienia& opcje, int scenariusz) {
+    SharedData* d = shared_memory;
+    int64_t koniec_us = opcje.czas_symulacji_s * 1000000LL;
+    int loop_counter = 0;
+    int plane_id_counter = 1;
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    silnik_init(opcje.lotnisko);
+    int64_t takt_us = 0;
+    int64_t dostawa_us = d->cfg_czas_dostawy * 1000000LL;
+    d->nastepna_dostawa = d->cfg_czas_dostawy;
+    int64_t koniec_okna_us = (opcje.lotnisko >= 0) ? siec->okno_us : INT64_MAX;
+
+    while (true) {
+        int64_t samolot_us = zdarzenia_najblizsze_us(&silnik.kolejka);
+        int64_t przylot_us = przyloty_najblizszy_us(&silnik.przyloty);
+        int64_t t = std::min(std::min(takt_us, dostawa_us), std::min(przylot_us, samolot_us));
+        if (t >= koniec_okna_us) {
+            siec_bariera(siec, opcje.lotnisko, &silnik.przyloty);
+            koniec_okna_us += siec->okno_us;
+            continue;
+        }
+        if (t > silnik.teraz_us) {
+            silnik.teraz_us = t;
+            zegar_przestaw_us(t);
+        }
+
+        if (t == takt_us) {
+            if (t >= koniec_us) break;
+            wykonaj_zmiany(t);
+            if (loop_counter % d->cfg_spawn_rate == 0) {
+                int idx = silnik_nowy_samolot(plane_id_counter++, t);
+                d->stat_przyloty++;
+                silnik_zaplanuj(idx, t);
+            }
+            przybycie_pasazerow(loop_counter);
+            probkuj_kolejki();
+            loop_counter++;
+            takt_us += TAKT_US;
+        } else if (t == dostawa_us) {
+            silnik_dostawa();
+            dostawa_us += d->cfg_czas_dostawy * 1000000LL;
+        } else if (t == przylot_us) {
+            przyloty_zdejmij(&silnik.przyloty);
+            int idx = silnik_nowy_samolot(plane_id_counter++, t);
+            d->stat_przyloty++;
+            d->stat_przyloty_sieci++;
+            silnik_zaplanuj(idx, t);
+        } else {
+            Zdarzenie z;
+            zdarzenia_zdejmij(&silnik.kolejka, &z);
+            SamolotZdarzen& s = silnik.samoloty[z.uczestnik];
+            if (z.epoka != s.epoka) continue;
+            if (s.czeka_na != nullptr) {
+                // Termin minął przed przydziałem
+                lista_wypisz(s.czeka_na, silnik.wezly.data(), z.uczestnik);
+                s.czeka_na = nullptr;
+                s.wynik = false;
+            }
+            krok_samolotu(z.uczestnik);
+        }
+    }
+
+    // Ostatnia bariera: nikt już nie wysyła, w kopcu zostały loty w drodze
+    if (opcje.lotnisko >= 0) {
+        siec_bariera(siec, opcje.lotnisko, &silnik.przyloty);
+        d->w_locie_sieci = (long long)silnik.przyloty.kopiec.size();
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    zakoncz_bez_gui(opcje, scenariusz, (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+}
+
+// =============================================================
+// =======  ZMIANY W BIEGU (plik scenariusza, so2ctl)  =========
+// =============================================================
+//
+// Pasy, bramki i cysterny to liczby jednostek w puli zainstalowanych
+// (cfg_max_*). Zmniejszenie zamyka od razu wolne jednostki, a za zajęte
+// zostawia dług (*_do_zamkniecia): zwalniający samolot zamyka wtedy
+// swoją zamiast ją oddać, więc nikt w trakcie obsługi jej nie traci.
+// Zwiększenie najpierw kasuje dług, potem otwiera zamknięte. Zmiany
+// wykonuje nadzorca w swoim takcie, w zegarze wirtualnym i silniku
+// zdarzeń zawsze w tej samej chwili symulacji.
+
+// Jak wieza_zmien_pasy
+static void silnik_zmien_pasy(int z, int na) {
+    for (int n = z; n > na; n--) {
+        if (silnik.ile_wolnych_pasow == 0) { silnik.pasy_do_zamkniecia++; continue; }
+        silnik.zamkniete_pasy.push_back(silnik.wolne_pasy[silnik.wolne_pasy_glowa]);
+        silnik.wolne_pasy_glowa = (silnik.wolne_pasy_glowa + 1) % silnik.wolne_pasy.size();
+        silnik.ile_wolnych_pasow--;
+    }
+    for (int n = z; n < na; n++) {
+        if (silnik.pasy_do_zamkniecia > 0) { silnik.pasy_do_zamkniecia--; continue; }
+        auto najnizszy = std::min_element(silnik.zamkniete_pasy.begin(), silnik.zamkniete_pasy.end());
+        int pas = *najnizszy;
+        silnik.zamkniete_pasy.erase(najnizszy);
+        silnik_zwolnij_pas(pas);
+    }
+}
+
+static bool bramka_sprobuj() { return sem_sprobuj(SEM_GATE); }
+static void bramka_oddaj() { sem_v(SEM_GATE); }
+static bool silnik_sem_sprobuj(SemaforZdarzen* sem) {
+    if (sem->wartosc == 0) return false;
+    sem->wartosc--;
+    return true;
+}
+static bool silnik_bramka_sprobuj() { return silnik_sem_sprobuj(&silnik.bramki); }
+static void silnik_bramka_oddaj() { silnik_sem_v(&silnik.bramki); }
+static bool silnik_cysterna_sprobuj() { return silnik_sem_sprobuj(&silnik.cysterny); }
+static void silnik_cysterna_oddaj() { silnik_sem_v(&silnik.cysterny); }
+static void pokaz_bramke(int idx, int samolot) { ustaw_bramke(idx, samolot, -1, 0); }
+
+// Pula slotów z jednostkami semafora (bramki, cysterny)
+struct PulaWBiegu {
+    PulaSlotow* wolne;
+    PulaSlotow* zamkniete;
+    std::atomic<int>* do_zamkniecia;
+    bool (*sprobuj)();              // Jednostka bez czekania
+    void (*oddaj)();                // Czekającemu albo do semafora
+    void (*pokaz)(int idx, int samolot);
+};
+
+static void zmien_pule(const PulaWBiegu& p, int z, int na) {
+    for (int n = z; n > na; n--) {
+        if (!p.sprobuj()) { p.do_zamkniecia->fetch_add(1); continue; }
+        // Jednostka bez slotu nie istnieje: ktoś oddał slot przed sem_v albo wolny już jest
+        int idx;
+        while ((idx = sloty_zajmij_ostatni(p.wolne)) == -1) sched_yield();
+        p.pokaz(idx, -1);
+        sloty_zwolnij(p.zamkniete, idx);
+    }
+    for (int n = z; n < na; n++) {
+        if (wez_zamkniecie(*p.do_zamkniecia)) continue;
+        // Zwalniający mógł wziąć dług i jeszcze nie odłożyć slotu
+        int idx;
+        while ((idx = sloty_zajmij(p.zamkniete, 0)) == -1) sched_yield();
+        p.pokaz(idx, 0);
+        sloty_zwolnij(p.wolne, idx);
+        p.oddaj();
+    }
+}
+
+// Zmiana parametru z PARAMETRY oznaczonego w_biegu; false = odrzucona
+// (powód w powod). Wywołuje tylko nadzorca.
+bool zmien_w_biegu(int p, int wartosc, char* powod, size_t n) {
+    SharedData* d = shared_memory;
+    const ParametrKonfiguracji& par = PARAMETRY[p];
+    if (!par.w_biegu) { snprintf(powod, n, "%s: tylko przy starcie", par.nazwa); return false; }
+    if (wartosc < par.min || wartosc > par.max) {
+        snprintf(powod, n, "%s: poza zakresem %d..%d", par.nazwa, par.min, par.max);
+        return false;
+    }
+    int zainstalowane = (p == PARAM_RUNWAYS) ? d->cfg_max_pasow : (p == PARAM_GATES) ? d->cfg_max_bramek
+                      : (p == PARAM_TANKERS) ? d->cfg_max_cystern : INT_MAX;
+    if (wartosc > zainstalowane) {
+        snprintf(powod, n, "%s: zainstalowano %d (--max-*)", par.nazwa, zainstalowane);
+        return false;
+    }
+
+    bool zdarzenia = d->cfg_silnik == SILNIK_ZDARZENIA;
+    int stara = d->*(par.pole);
+    if (p == PARAM_RUNWAYS) {
+        if (zdarzenia) silnik_zmien_pasy(stara, wartosc);
+        else wieza_zmien_pasy(&d->wieza, wartosc);
+        zmien_panel(PANEL_PASY);
+    } else if (p == PARAM_GATES) {
+        PulaWBiegu pula = { &d->wolne_bramki, &d->zamkniete_bramki, &d->bramki_do_zamkniecia,
+                            zdarzenia ? silnik_bramka_sprobuj : bramka_sprobuj,
+                            zdarzenia ? silnik_bramka_oddaj : bramka_oddaj, pokaz_bramke };
+        zmien_pule(pula, stara, wartosc);
+    } else if (p == PARAM_TANKERS) {
+        PulaWBiegu pula = { &d->wolne_cysterny, &d->zamkniete_cysterny, &d->cysterny_do_zamkniecia,
+                            zdarzenia ? silnik_cysterna_sprobuj : cysterna_sprobuj,
+                            zdarzenia ? silnik_cysterna_oddaj : cysterna_jednostka_oddaj, ustaw_cysterne };
+        zmien_pule(pula, stara, wartosc);
+    }
+    d->*(par.pole) = wartosc;
+    if (p == PARAM_LANDING_TIME || p == PARAM_TAKEOFF_TIME) {
+        // Czasy, którymi polityka "krotsza" waży kolejki pasów
+        StanPolitykiPasow* pol = zdarzenia ? &silnik.polityka : &d->wieza.polityka;
+        blokada_wez(&d->wieza.blokada);
+        pol->czas_operacji_us[OP_LADOWANIE] = d->cfg_landing_time;
+        pol->czas_operacji_us[OP_START] = czas_startu_us();
+        blokada_oddaj(&d->wieza.blokada);
+    }
+
+    d->stat_zmiany++;
+    char log[60];
+    snprintf(log, sizeof(log), ">> ZMIANA %s: %d -> %d", par.nazwa, stara, wartosc);
+    zapisz_log(log);
+    stan_ekranu.przerysuj.store(true);
+    return true;
+}
+
+// Harmonogram z pliku scenariusza, stan nadzorcy
+struct HarmonogramZmian {
+    const std::vector<ZmianaParametru>* zmiany;
+    int64_t cykl_us;
+    size_t nastepna;
+    int64_t poczatek_cyklu_us;
+};
+
+static HarmonogramZmian harmonogram;
+
+void harmonogram_init(const OpcjeUruchomienia& opcje) {
+    harmonogram.zmiany = &opcje.zmiany;
+    harmonogram.cykl_us = opcje.cykl_zmian_us;
+    harmonogram.nastepna = 0;
+    harmonogram.poczatek_cyklu_us = 0;
+}
+
+// W każdym takcie nadzorcy: zmiany z harmonogramu, których czas minął,
+// potem polecenia czekające w skrzynce (sterowanie.h)
+void wykonaj_zmiany(int64_t teraz_us) {
+    SharedData* d = shared_memory;
+    char powod[64];
+    const std::vector<ZmianaParametru>* zmiany = harmonogram.zmiany;
+    while (zmiany != nullptr && !zmiany->empty()) {
+        if (harmonogram.nastepna == zmiany->size()) {
+            if (harmonogram.cykl_us == 0) break;
+            harmonogram.nastepna = 0;
+            harmonogram.poczatek_cyklu_us += harmonogram.cykl_us;
+        }
+        const ZmianaParametru& z = (*zmiany)[harmonogram.nastepna];
+        if (harmonogram.poczatek_cyklu_us + z.czas_us > teraz_us) break;
+        harmonogram.nastepna++;
+        if (!zmien_w_biegu(z.parametr, z.wartosc, powod, sizeof(powod))) zapisz_log(powod);
+    }
+
+    for (int i = 0; i < STEROWANIE_MAX_POLECEN; i++) {
+        PolecenieSterujace& pol = d->sterowanie.polecenia[i];
+        int czeka = POL_CZEKA;
+        if (pol.stan.load(std::memory_order_relaxed) != POL_CZEKA ||
+            !pol.stan.compare_exchange_strong(czeka, POL_WYKONYWANE, std::memory_order_acquire)) continue;
+        // Nazwa poza skrzynką: odpowiedź leży w tej samej strukturze
+        char parametr[sizeof(pol.parametr)];
+        memcpy(parametr, pol.parametr, sizeof(parametr));
+        parametr[sizeof(parametr) - 1] = '\0';
+        int p = znajdz_parametr(parametr, strlen(parametr));
+        bool ok = false;
+        pol.odpowiedz[0] = '\0';
+        if (p == -1) snprintf(pol.odpowiedz, sizeof(pol.odpowiedz), "%s: nieznany parametr", parametr);
+        else ok = zmien_w_biegu(p, pol.wartosc, pol.odpowiedz, sizeof(pol.odpowiedz));
+        pol.czas_us = teraz_us;
+        pol.stan.store(ok ? POL_WYKONANE : POL_ODRZUCONE, std::memory_order_release);
+    }
+}
+
+// =============================================================
+// =======  PĘTLA GŁÓWNA GUI (epoll)  ==========================
+// =============================================================
+//
+// Jedno epoll_wait na wszystko: klawiatura, takt symulacji (timerfd),
+// SIGINT/SIGCHLD/SIGWINCH (signalfd) i koniec każdego samolotu (pidfd).
+// Ekran rysuje osobny wątek (watek_ekranu), więc przyloty nie zależą od
+// kosztu rysowania; takty, które mimo to minęły, są nadrabiane (licznik
+// wygaśnięć timerfd). W pauzie proces śpi w epoll_wait.
+
+#ifndef P_PIDFD
+#define P_PIDFD 3
+#endif
+
+// epoll_event.data.u64: stałe źródła, a od ZR_SAMOLOT - pidfd samolotu
+enum ZrodloZdarzenia {
+    ZR_KLAWIATURA = 0,
+    ZR_TAKT,
+    ZR_SYGNALY,
+    ZR_SAMOLOT
+};
+
+static void epoll_dodaj(int ep, int fd, uint64_t zrodlo) {
+    struct epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = zrodlo;
+    if (epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev) == -1) perror("epoll_ctl");
+}
+
+static int nowy_timer(long okres_us) {
+    int fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    struct itimerspec t = {};
+    t.it_interval.tv_sec = okres_us / 1000000;
+    t.it_interval.tv_nsec = (okres_us % 1000000) * 1000;
+    t.it_value = t.it_interval;
+    timerfd_settime(fd, 0, &t, nullptr);
+    return fd;
+}
+
+static uint64_t odczytaj_timer(int fd) {
+    uint64_t wygasniecia = 0;
+    if (read(fd, &wygasniecia, sizeof(wygasniecia)) != sizeof(wygasniecia)) return 0;
+    return wygasniecia;
+}
+
+// Koniec samolotu zgłasza jego pidfd; bez pidfd (stare jądro, brak
+// deskryptorów) samolot zbierze obsługa SIGCHLD
+static void obserwuj_samolot(int ep, pid_t pid) {
+    int fd = (int)syscall(SYS_pidfd_open, pid, 0);
+    if (fd == -1) return;
+    epoll_dodaj(ep, fd, ZR_SAMOLOT + (uint64_t)fd);
+}
+
+void petla_gui(int fps) {
+    // Maska przed startem wątku ekranu - dziedziczy ją i nie łapie sygnałów
+    sigset_t maska;
+    sigemptyset(&maska);
+    sigaddset(&maska, SIGINT);
+    sigaddset(&maska, SIGCHLD);
+    sigaddset(&maska, SIGWINCH);
+    pthread_sigmask(SIG_BLOCK, &maska, nullptr);
+    int sygnaly = signalfd(-1, &maska, SFD_NONBLOCK | SFD_CLOEXEC);
+
+    int takt = nowy_timer(TAKT_US);
+
+    int ep = epoll_create1(EPOLL_CLOEXEC);
+    epoll_dodaj(ep, STDIN_FILENO, ZR_KLAWIATURA);
+    epoll_dodaj(ep, takt, ZR_TAKT);
+    epoll_dodaj(ep, sygnaly, ZR_SYGNALY);
+
+    int loop_counter = 0;
+    int plane_id_counter = 1;
+    bool paused = false;
+    bool koniec = false;
+
+    stan_ekranu.fps = fps;
+    pthread_t ekran;
+    pthread_create(&ekran, nullptr, watek_ekranu, nullptr);
+
+    while (!koniec) {
+        struct epoll_event zdarzenia[64];
+        int n = epoll_wait(ep, zdarzenia, 64, -1);
+        if (n == -1) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+
+        for (int i = 0; i < n; i++) {
+            uint64_t zrodlo = zdarzenia[i].data.u64;
+            if (zrodlo == ZR_KLAWIATURA) {
+                // Klawiatura czytana wprost (cbreak); ncurses należy do wątku ekranu
+                char klawisze[32];
+                ssize_t ile = read(STDIN_FILENO, klawisze, sizeof(klawisze));
+                if (ile <= 0) koniec = true;
+                for (ssize_t k = 0; k < ile; k++) {
+                    if (klawisze[k] == ' ') { paused = !paused; stan_ekranu.pauza.store(paused); }
+                    else if (klawisze[k] == 'q') koniec = true;
+                }
+            }
+            else if (zrodlo == ZR_TAKT) {
+                uint64_t takty = odczytaj_timer(takt);
+                if (paused) continue;
+                for (uint64_t t = 0; t < takty; t++) {
+                    wykonaj_zmiany(zegar_teraz_us());
+                    std::vector<pid_t> samoloty;
+                    krok_symulacji(loop_counter, plane_id_counter, &samoloty);
+                    loop_counter++;
+                    for (pid_t samolot : samoloty) obserwuj_samolot(ep, samolot);
+                }
+                stan_ekranu.loty.store(plane_id_counter - 1);
+            }
+            else if (zrodlo == ZR_SYGNALY) {
+                struct signalfd_siginfo si;
+                while (read(sygnaly, &si, sizeof(si)) == sizeof(si)) {
+                    if (si.ssi_signo == SIGINT) koniec = true;
+                    if (si.ssi_signo == SIGWINCH) stan_ekranu.zmiana_rozmiaru.store(true);
+                }
+                // Dostawca, pula i samoloty bez pidfd
+                zbierz_procesy();
+            }
+            else {
+                int fd = (int)(zrodlo - ZR_SAMOLOT);
+                siginfo_t info = {};
+                if (waitid((idtype_t)P_PIDFD, (id_t)fd, &info, WEXITED | WNOHANG) == 0 && info.si_pid > 0) {
+                    odbierz_proces(info.si_pid, info.si_code == CLD_KILLED || info.si_code == CLD_DUMPED);
+                }
+                epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+                close(fd);
+            }
+        }
+    }
+
+    stan_ekranu.koniec.store(true);
+    pthread_join(ekran, nullptr);
+}
+
+// =============================================================
+// =======  MAIN (MENU WYBORU)  ================================
+// =============================================================
+
+// Parametry scenariuszy A-D (i obciążenia do --benchmark)
+void ustaw_scenariusz(int wybor, Konfiguracja& cfg) {
+    cfg.cfg_tankers = DOMYSLNE_CYSTERNY;
+    cfg.cfg_kierunki = DOMYSLNE_KIERUNKI;
+    cfg.cfg_kolowanie = DOMYSLNE_KOLOWANIE;
+    cfg.cfg_przekierowanie = 0;
+    cfg.cfg_obsluga_rownolegla = 0;
+    cfg.cfg_sprzatanie = 0;
+    cfg.cfg_catering = 0;
+    cfg.cfg_polityka_pasow = POLITYKA_FCFS;
+    cfg.cfg_paczka_pasow = 4;
+    cfg.cfg_czas_startu = 0;
+    cfg.cfg_rekordy_pasazerow = 0;
+    cfg.cfg_przydzial_kierunkow = PRZYDZIAL_LOSOWY;
+    cfg.cfg_dostawa_paliwa = FUEL_DELIVERY;
+    cfg.cfg_czas_dostawy = DELIVERY_TIME;
 
     if (wybor == 1) {
         // Scenariusz 1: Ideał - Zrównoważony
-        strcpy(shared_memory->scenariusz_nazwa, "SCENARIUSZ A: Poza sezonem(BALANS)");
-        shared_memory->cfg_runways = 2;
-        shared_memory->cfg_gates = 6;
+        strcpy(cfg.scenariusz_nazwa, "SCENARIUSZ A: Poza sezonem(BALANS)");
+        cfg.cfg_runways = 2;
+        cfg.cfg_gates = 6;
 
-        shared_memory->cfg_spawn_rate = 35;
-        shared_memory->cfg_pax_rate = 20;       // 20% - Szansa na pasażera (optymalna przy rzadszych lotach)
-        shared_memory->cfg_boarding_time = 4;   // 5s - Czas na podziwianie postoju
+        cfg.cfg_spawn_rate = 35;
+        cfg.cfg_pax_rate = 20;       // 20% - Szansa na pasażera (optymalna przy rzadszych lotach)
+        cfg.cfg_boarding_time = 4;   // 5s - Czas na podziwianie postoju
 
-        shared_memory->cfg_plane_capacity = 30;
-        shared_memory->cfg_landing_time = 2000000; // 2.0s - Szybsze lądowanie, żeby zwolnić pas
+        cfg.cfg_plane_capacity = 30;
+        cfg.cfg_landing_time = 2000000; // 2.0s - Szybsze lądowanie, żeby zwolnić pas
     }
     else if (wybor == 2) {
         // Scenariusz 2: TŁUM / WAKACJE
         // Cel: Pasażerów przybywa szybciej niż samoloty mogą ich zabrać.
         // Efekt: Czerwone liczniki w terminalu, każdy samolot "PELNY".
-        strcpy(shared_memory->scenariusz_nazwa, "SCENARIUSZ B: Wakacje");
+        strcpy(cfg.scenariusz_nazwa, "SCENARIUSZ B: Wakacje");
 
-        shared_memory->cfg_runways = 3;
-        shared_memory->cfg_gates = 6;
+        cfg.cfg_runways = 3;
+        cfg.cfg_gates = 6;
 
         // ZMIANY:
-        shared_memory->cfg_spawn_rate = 20;
-        shared_memory->cfg_pax_rate = 50;
-        shared_memory->cfg_boarding_time = 4;
+        cfg.cfg_spawn_rate = 20;
+        cfg.cfg_pax_rate = 50;
+        cfg.cfg_boarding_time = 4;
 
-        shared_memory->cfg_plane_capacity = 30;
-        shared_memory->cfg_landing_time = 2500000;
+        cfg.cfg_plane_capacity = 30;
+        cfg.cfg_landing_time = 2500000;
     }
     else  if(wybor == 3){
         // --- OPCJA 3: NIEWYDOLNOŚĆ LOTNISKA ---
 
-        strcpy(shared_memory->scenariusz_nazwa, "SCENARIUSZ C: ARMAGEDON");
+        strcpy(cfg.scenariusz_nazwa, "SCENARIUSZ C: ARMAGEDON");
 
-        shared_memory->cfg_runways = 2;
-        shared_memory->cfg_gates = 6;
+        cfg.cfg_runways = 2;
+        cfg.cfg_gates = 6;
 
         // Parametry: Ruch normalny, ale infrastruktura za słaba -> KOREK
-        shared_memory->cfg_spawn_rate = 30;     // 3.0s - Samoloty przylatują szybciej niż 1 pas obsłuży
-        shared_memory->cfg_pax_rate = 80;
-        shared_memory->cfg_boarding_time = 6;   // 6s - Bardzo wolna obsługa naziemna (chaos)
-        shared_memory->cfg_plane_capacity = 30;
-        shared_memory->cfg_landing_time = 3500000; // 3.0s - Wolne lądowanie (dodaje opóźnienia)
+        cfg.cfg_spawn_rate = 30;     // 3.0s - Samoloty przylatują szybciej niż 1 pas obsłuży
+        cfg.cfg_pax_rate = 80;
+        cfg.cfg_boarding_time = 6;   // 6s - Bardzo wolna obsługa naziemna (chaos)
+        cfg.cfg_plane_capacity = 30;
+        cfg.cfg_landing_time = 3500000; // 3.0s - Wolne lądowanie (dodaje opóźnienia)
+    }
+    else if (wybor == 5) {
+        // Obciążenie do --benchmark: dużo krótkich obsług, bez wąskiego gardła
+        strcpy(cfg.scenariusz_nazwa, "BENCHMARK");
+        cfg.cfg_runways = 5;
+        cfg.cfg_gates = 10;
+        cfg.cfg_spawn_rate = 4;
+        cfg.cfg_pax_rate = 50;
+        cfg.cfg_boarding_time = 1;
+        cfg.cfg_plane_capacity = 30;
+        cfg.cfg_landing_time = 100000;
     }
     else {
-        strcpy(shared_memory->scenariusz_nazwa, "SCENARIUSZ D: AWARIA PASA");
-        shared_memory->cfg_runways = 1;
-        shared_memory->cfg_gates = 4;
-        shared_memory->cfg_spawn_rate = 20;
-        shared_memory->cfg_pax_rate = 40;
-        shared_memory->cfg_boarding_time = 2;
-        shared_memory->cfg_plane_capacity = 30;
-        shared_memory->cfg_landing_time = 3000000;
+        strcpy(cfg.scenariusz_nazwa, "SCENARIUSZ D: AWARIA PASA");
+        cfg.cfg_runways = 1;
+        cfg.cfg_gates = 4;
+        cfg.cfg_spawn_rate = 20;
+        cfg.cfg_pax_rate = 40;
+        cfg.cfg_boarding_time = 2;
+        cfg.cfg_plane_capacity = 30;
+        cfg.cfg_landing_time = 3000000;
     }
+}
 
-    // 4. INICJALIZACJA SEMAFORÓW
-    semid = semget(SEM_KEY, 4, IPC_CREAT | 0666);
-    semctl(semid, SEM_PAS, SETVAL, shared_memory->cfg_runways);
-    semctl(semid, SEM_GATE, SETVAL, shared_memory->cfg_gates);
-    semctl(semid, SEM_CYSTERNA, SETVAL, MAX_TANKERS);
-    semctl(semid, MUTEX_ZASOBY, SETVAL, 1);
 
-    signal(SIGINT, cleanup);
+// Zainstalowane pasy/bramki/cysterny: podane --max-*, a co najmniej tyle,
+// ile scenariusz otwiera na starcie i w harmonogramie zmian
+void ustal_zainstalowane(Konfiguracja& cfg, const std::vector<ZmianaParametru>& zmiany) {
+    cfg.cfg_max_pasow = std::max(cfg.cfg_max_pasow, cfg.cfg_runways);
+    cfg.cfg_max_bramek = std::max(cfg.cfg_max_bramek, cfg.cfg_gates);
+    cfg.cfg_max_cystern = std::max(cfg.cfg_max_cystern, cfg.cfg_tankers);
+    for (const ZmianaParametru& z : zmiany) {
+        if (z.parametr == PARAM_RUNWAYS) cfg.cfg_max_pasow = std::max(cfg.cfg_max_pasow, z.wartosc);
+        if (z.parametr == PARAM_GATES) cfg.cfg_max_bramek = std::max(cfg.cfg_max_bramek, z.wartosc);
+        if (z.parametr == PARAM_TANKERS) cfg.cfg_max_cystern = std::max(cfg.cfg_max_cystern, z.wartosc);
+    }
+}
 
-    if (fork() == 0) { proces_dostawcy_paliwa(); exit(0); }
+// Procesy obsługi działające naraz (wpisy rejestru i sloty zegara): pula
+// albo tyle samolotów, ile przyleci w przebiegu przy najczęstszych
+// przylotach ze scenariusza i harmonogramu zmian. Bez końca przebiegu
+// (GUI) górna granica zegara. Przyloty ponad to (--spawn-rate zmienione
+// przez so2ctl) czekają na zwolniony wpis - żaden nie przepada.
+int ustal_pojemnosc(const Konfiguracja& cfg, const OpcjeUruchomienia& opcje) {
+    int limit = ZEGAR_MAX_UCZESTNIKOW - UCZESTNICY_NADZORU;
+    if (opcje.pula > 0) return opcje.pula;
+    if (!opcje.headless) return limit;
+    int co = cfg.cfg_spawn_rate;
+    for (const ZmianaParametru& z : opcje.zmiany) {
+        if (z.parametr == PARAM_SPAWN_RATE) co = std::min(co, z.wartosc);
+    }
+    long long przyloty = opcje.czas_symulacji_s * (1000000LL / TAKT_US) / co + 1;
+    return (int)std::min<long long>(przyloty, limit);
+}
 
-    // 5. START GUI
-    initscr();
-    noecho();
-    curs_set(0);
-    start_color();
-    init_pair(1, COLOR_GREEN, COLOR_BLACK);
-    init_pair(2, COLOR_RED, COLOR_BLACK);
-    init_pair(3, COLOR_CYAN, COLOR_BLACK);
-    init_pair(4, COLOR_YELLOW, COLOR_BLACK);
-    init_pair(5, COLOR_YELLOW, COLOR_RED);
+// Stan segmentu przed startem procesów (po oblicz_uklad z tym cfg)
+void ustaw_stan_poczatkowy(const Konfiguracja& cfg) {
+    shared_memory->poczatkowa = cfg;
+    magazyn_init(&shared_memory->magazyn, FUEL_MAX, FUEL_MAX);
+    shared_memory->nastepna_dostawa = cfg.cfg_czas_dostawy;
+    shared_memory->aktywne_samoloty = 0;
+    for (int i = 0; i < cfg.cfg_kierunki; i++) {
+        KierunekTerminalu& k = kierunek_terminalu(i);
+        blokada_init(&k.blokada);
+        if (i < 4) snprintf(k.nazwa, sizeof(k.nazwa), "%c", KIERUNKI_NAZWY[i]);
+        else snprintf(k.nazwa, sizeof(k.nazwa), "D%02d", std::min(i + 1, MAX_KIERUNKOW));
+    }
+    for (int i = 0; i < cfg.cfg_max_bramek; i++) rekord_bramki(i).kierunek = -1;
+    if (cfg.cfg_rekordy_pasazerow) {
+        for (int i = 0; i < cfg.cfg_kierunki; i++) kolejka_init(&kolejka_pasazerow(i), pasazerowie_pojemnosc(cfg.cfg_kierunki));
+    }
+    for (int i = 0; i < cfg.cfg_max_bramek; i++) rekord_bramki(i).cysterna_poz = -1;
+    // Zainstalowane ponad liczbę na starcie czekają zamknięte
+    for (int i = cfg.cfg_gates; i < cfg.cfg_max_bramek; i++) rekord_bramki(i).samolot = -1;
+    for (int i = cfg.cfg_tankers; i < cfg.cfg_max_cystern; i++) rekord_cysterny(i).samolot = -1;
+    blokada_init(&shared_memory->blokada_cystern);
+    shared_memory->cysterny_wolne = cfg.cfg_tankers;
+    blokada_init(&shared_memory->blokada_przydzialu);
+    blokada_init(&shared_memory->blokada_zadan);
+    blokada_init(&shared_memory->blokada_logow);
+
+    sloty_init_zakres(&shared_memory->wolne_bramki, cfg.cfg_max_bramek, 0, cfg.cfg_gates);
+    sloty_init_zakres(&shared_memory->zamkniete_bramki, cfg.cfg_max_bramek, cfg.cfg_gates, cfg.cfg_max_bramek);
+    sloty_init_zakres(&shared_memory->wolne_cysterny, cfg.cfg_max_cystern, 0, cfg.cfg_tankers);
+    sloty_init_zakres(&shared_memory->zamkniete_cysterny, cfg.cfg_max_cystern, cfg.cfg_tankers, cfg.cfg_max_cystern);
+}
 
-    nodelay(stdscr, TRUE);
+// Ta sama symulacja (scenariusz 5, zegar wirtualny) w obu trybach uruchamiania
+// samolotów; miarą jest liczba obsłużonych samolotów na sekundę rzeczywistą.
+int benchmark_puli(const OpcjeUruchomienia& opcje) {
+    int pule[2] = { 0, opcje.pula > 0 ? opcje.pula : 64 };
+    WynikSymulacji wyniki[2] = {};
+
+    for (int i = 0; i < 2; i++) {
+        OpcjeUruchomienia o = opcje;
+        o.scenariusz = 5;
+        o.pula = pule[i];
+        int fd = -1;
+        pid_t pid = uruchom_przebieg_w_tle(o, &fd);
+        if (pid == -1) return 1;
+        if (!odbierz_wynik(fd, wyniki[i])) {
+            std::cerr << "Benchmark: brak wyniku przebiegu " << i << std::endl;
+        }
+        waitpid(pid, NULL, 0);
+    }
 
-    int loop_counter = 0;
-    int plane_id_counter = 1;
-    bool paused = false;
+    printf("%-16s %10s %12s %14s\n", "TRYB", "ODLOTY", "CZAS [s]", "SAMOLOTY/s");
+    for (int i = 0; i < 2; i++) {
+        char nazwa[32];
+        if (pule[i] == 0) snprintf(nazwa, sizeof(nazwa), "fork()");
+        else snprintf(nazwa, sizeof(nazwa), "pula (%d)", pule[i]);
+        printf("%-16s %10lld %12.2f %14.1f\n", nazwa, wyniki[i].odloty, wyniki[i].czas_real_s,
+               wyniki[i].czas_real_s > 0 ? wyniki[i].odloty / wyniki[i].czas_real_s : 0.0);
+    }
+    return 0;
+}
 
-    while (true) {
-        int ch = getch();
-
-        if (ch == ' ') {
-            paused = !paused;
-            if (paused) {
-                while(true) {
-                    draw_interface(loop_counter, plane_id_counter, true);
-                    usleep(50000);
-                    int c2 = getch();
-                    if (c2 == ' ') {
-                        paused = false;
-                        break;
-                    }
-                    if (c2 == 'q') { cleanup(0); }
-                }
-            }
-        }
-        else if (ch == 'q') break;
+// =============================================================
+// =======  POMIARY NA SEGMENCIE SO2 (pomiary.cpp)  ============
+// =============================================================
+//
+// Gorące ścieżki, które potrzebują prawdziwego segmentu i ekranu:
+// prywatny segment jak w uruchom_symulacje, bez procesów symulacji,
+// ekran ncurses pisany do /dev/null.
+
+static UkladEkranu uklad_pomiaru;
+
+bool pomiary_przygotuj(int scenariusz) {
+    Konfiguracja cfg = {};
+    ustaw_scenariusz(scenariusz, cfg);
+    ustal_zainstalowane(cfg, {});
+    size_t rozmiar = oblicz_uklad(cfg, false, 0, nullptr);
+    int id = shmget(IPC_PRIVATE, rozmiar, IPC_CREAT | 0600);
+    if (id == -1) { perror("shmget"); return false; }
+    void* adres = shmat(id, nullptr, 0);
+    shmctl(id, IPC_RMID, nullptr);   // Zniknie po odłączeniu ostatniego procesu
+    if (adres == (void*)-1) { perror("shmat"); return false; }
+    shared_memory = (SharedData*)adres;
+    memset((void*)shared_memory, 0, rozmiar);
+    *static_cast<Konfiguracja*>(shared_memory) = cfg;
+    oblicz_uklad(cfg, false, 0, shared_memory);
+    ustaw_stan_poczatkowy(cfg);
+
+    // Ekran jak w szczycie: co druga bramka i pierwszy pas zajęte
+    for (int i = 0; i < cfg.cfg_gates; i += 2) ustaw_bramke(i, i + 1, i % cfg.cfg_kierunki, cfg.cfg_plane_capacity / 2);
+    ustaw_pas(0, 1);
+    return true;
+}
 
-        if (!paused) {
-            draw_interface(loop_counter, plane_id_counter, false);
+void pomiary_dodaj_log(int i) {
+    dodaj_log("ID:%03d [%s] Pax: %d/%d (%s)", i, kierunek_terminalu(i % shared_memory->cfg_kierunki).nazwa,
+              shared_memory->cfg_plane_capacity, "PELNY");
+}
 
-            if (loop_counter % shared_memory->cfg_spawn_rate == 0) {
-                if (fork() == 0) {
-                    proces_samolotu(plane_id_counter);
-                } else {
-                    plane_id_counter++;
-                }
-            }
+bool pomiary_ekran_init(int wiersze, int kolumny) {
+    FILE* wyjscie = fopen("/dev/null", "w");
+    FILE* wejscie = fopen("/dev/null", "r");
+    if (wyjscie == nullptr || wejscie == nullptr) return false;
+    if (newterm("xterm-256color", wyjscie, wejscie) == nullptr) return false;
+    resizeterm(wiersze, kolumny);
+    ustaw_kolory();
+    oblicz_uklad_ekranu(uklad_pomiaru);
+    return true;
+}
 
-            if (rand() % 100 < shared_memory->cfg_pax_rate) {
-                sem_p(MUTEX_ZASOBY);
-                int kier = rand() % 4;
-                shared_memory->pasazerowie_w_terminalu[kier] += (1 + rand() % 3);
-                sem_v(MUTEX_ZASOBY);
-            }
-            loop_counter++;
+// Pełna klatka jak po zmianie rozmiaru; inaczej jeden panel jak po zmianie bramki
+void pomiary_klatka(bool pelna) {
+    const UkladEkranu& u = uklad_pomiaru;
+    if (pelna) {
+        erase();
+        rysuj_tlo(u);
+        for (int p = 0; p < LICZBA_PANELI; p++) rysuj_panel(u, p);
+        rysuj_czasy(u);
+        rysuj_status(u, shared_memory->aktywne_samoloty.load());
+    } else {
+        rysuj_panel(u, PANEL_BRAMKI);
+    }
+    refresh();
+}
+
+void pomiary_ekran_koniec() {
+    endwin();
+}
+
+#ifndef SO2_POMIARY
+int main(int argc, char** argv) {
+    OpcjeUruchomienia opcje;
+    if (!parsuj_opcje(argc, argv, opcje)) return 1;
+    if (opcje.benchmark) return benchmark_puli(opcje);
+    if (opcje.przeglad) return przeglad_parametrow(opcje);
+    if (opcje.optymalizacja) return optymalizuj(opcje);
+    if (opcje.lotniska > 0) return siec_lotnisk(opcje);
+    if (!opcje.plik_odtworzenia.empty()) return odtworz_przebieg(opcje);
+    return uruchom_symulacje(opcje);
+}
+#endif
+
+int uruchom_symulacje(const OpcjeUruchomienia& opcje) {
+    setlocale(LC_ALL, "");
+    unsigned ziarno = opcje.ziarno_podane ? opcje.ziarno : (unsigned)time(NULL);
+
+    // Przebiegi przeglądu/benchmarku mają własne, prywatne IPC
+    key_t klucz_shm = opcje.prywatne_ipc ? IPC_PRIVATE : SHM_KEY;
+    key_t klucz_sem = opcje.prywatne_ipc ? IPC_PRIVATE : SEM_KEY;
+
+    // 1. CZYSZCZENIE
+    if (!opcje.prywatne_ipc) {
+        int old_shmid = shmget(SHM_KEY, 0, 0666);
+        if (old_shmid != -1) shmctl(old_shmid, IPC_RMID, nullptr);
+        int old_semid = semget(SEM_KEY, LICZBA_SEMAFOROW, 0666);
+        if (old_semid != -1) semctl(old_semid, 0, IPC_RMID);
+    }
+
+    // 2. MENU WYBORU SCENARIUSZA
+    int wybor = opcje.scenariusz;
+    if (wybor == 0) {
+        std::cout << "============================================" << std::endl;
+        std::cout << "    WYBIERZ SCENARIUSZ SYMULACJI LOTNISKA     " << std::endl;
+        std::cout << "============================================" << std::endl;
+        std::cout << "1. Poza sezonem (optymalnie)" << std::endl;
+        std::cout << "2. Wakacje, tlumy ludzi" << std::endl;
+        std::cout << "3. Aremagedon" << std::endl;
+        std::cout << "4. AWARIA PASA " << std::endl;
+        std::cout << "Wybierz (1-4): ";
+
+        std::cin >> wybor;
+    }
+
+    Konfiguracja cfg = {};
+    ustaw_scenariusz(wybor, cfg);
+    for (int i = 0; i < LICZBA_PARAMETROW; i++) {
+        if (opcje.nadpisania[i] >= 0) cfg.*(PARAMETRY[i].pole) = opcje.nadpisania[i];
+    }
+    if (!opcje.nazwa_scenariusza.empty()) {
+        snprintf(cfg.scenariusz_nazwa, sizeof(cfg.scenariusz_nazwa), "%s", opcje.nazwa_scenariusza.c_str());
+    }
+    ustal_zainstalowane(cfg, opcje.zmiany);
+
+    // 3. TWORZENIE PAMIĘCI (rozmiar wynika z konfiguracji)
+    // Plik śladu otwierany przed utworzeniem IPC - błąd nie zostawia segmentu
+    bool slad = !opcje.plik_sladu.empty();
+    FILE* plik_sladu = nullptr;
+    if (slad) {
+        plik_sladu = fopen(opcje.plik_sladu.c_str(), "wb");
+        if (plik_sladu == nullptr) { perror(opcje.plik_sladu.c_str()); return 1; }
+    }
+    int procesy = ustal_pojemnosc(cfg, opcje);
+    size_t rozmiar = oblicz_uklad(cfg, slad, procesy, nullptr);
+    shmid = shmget(klucz_shm, rozmiar, IPC_CREAT | 0666);
+    if (shmid == -1) { perror("shmget"); return 1; }
+    shared_memory = (SharedData*)shmat(shmid, nullptr, 0);
+    memset((void*)shared_memory, 0, rozmiar);
+    *static_cast<Konfiguracja*>(shared_memory) = cfg;
+    oblicz_uklad(cfg, slad, procesy, shared_memory);
+    rejestr_init(procesy);
+    shared_memory->ziarno = ziarno;
+    hist_podlacz(&shared_memory->histogramy);
+    hist_wybierz_shard(getpid());
+    slad_wybierz_pierscien(getpid());
+    if (slad) {
+        slad_init(bufor_sladu());
+        slad_podlacz(bufor_sladu());
+    }
+
+    ustaw_stan_poczatkowy(cfg);
+
+    if (!opcje.plik_dziennika.empty()) {
+        std::vector<const char*> nazwy;
+        for (int i = 0; i < cfg.cfg_kierunki; i++) nazwy.push_back(kierunek_terminalu(i).nazwa);
+        if (!dziennik_otworz(opcje.plik_dziennika.c_str(), cfg.scenariusz_nazwa, ziarno, cfg.cfg_plane_capacity,
+                             cfg.cfg_kierunki, nazwy.data())) {
+            shmdt(shared_memory);
+            shmctl(shmid, IPC_RMID, nullptr);
+            return 1;
         }
+    }
+
+    // 4. INICJALIZACJA SEMAFORÓW
+    semid = semget(klucz_sem, LICZBA_SEMAFOROW, IPC_CREAT | 0666);
+    semctl(semid, SEM_GATE, SETVAL, shared_memory->cfg_gates);
+    semctl(semid, SEM_CYSTERNA, SETVAL, shared_memory->cfg_tankers);
+    semctl(semid, SEM_ZADANIA, SETVAL, 0);
+    semctl(semid, SEM_KOLOWANIE, SETVAL, shared_memory->cfg_kolowanie);
+
+    zegar_init(&shared_memory->zegar, opcje.tryb_zegara, opcje.predkosc,
+               (char*)shared_memory + shared_memory->off_zegar, procesy + UCZESTNICY_NADZORU);
+    zegar_sem_init(SEM_GATE, shared_memory->cfg_gates);
+    zegar_sem_init(SEM_CYSTERNA, shared_memory->cfg_tankers);
+    zegar_sem_init(SEM_ZADANIA, 0);
+    zegar_sem_init(SEM_KOLOWANIE, shared_memory->cfg_kolowanie);
+    wieza_init(&shared_memory->wieza, cfg.cfg_polityka_pasow, cfg.cfg_paczka_pasow, cfg.cfg_runways,
+               cfg.cfg_max_pasow, cfg.cfg_landing_time, czas_startu_us(),
+               rekordy_segmentu<ZgloszeniePasa>(shared_memory, shared_memory->off_zgloszenia), procesy);
+    harmonogram_init(opcje);
+    zegar_slot = zegar_zarejestruj();
+
+    signal(SIGINT, cleanup);
 
-        while (waitpid(-1, NULL, WNOHANG) > 0);
-        usleep(100000);
+    // Proces zapisu śladu: nagłówek, potem strumień rekordów
+    if (slad) {
+        NaglowekSladu n = {};
+        memcpy(n.magia, SLAD_MAGIA, sizeof(SLAD_MAGIA));
+        n.wersja = SLAD_WERSJA;
+        n.rozmiar_zdarzenia = sizeof(ZdarzenieSladu);
+        n.tryb_zegara = opcje.tryb_zegara;
+        n.ziarno = ziarno;
+        strncpy(n.scenariusz, cfg.scenariusz_nazwa, sizeof(n.scenariusz) - 1);
+        fwrite(&n, sizeof(n), 1, plik_sladu);
+        fflush(nullptr);
+        pid_zapisu_sladu = fork();
+        if (pid_zapisu_sladu == 0) { po_fork_w_dziecku(-1); proces_zapisu_sladu(plik_sladu); }
+        fclose(plik_sladu);
     }
 
+    // Silnik zdarzeń: bez procesów dostawcy, puli i samolotów
+    if (cfg.cfg_silnik == SILNIK_ZDARZENIA) petla_zdarzen(opcje, wybor);
+
+    int slot_dostawcy = zegar_zarejestruj();
+    if (fork() == 0) { po_fork_w_dziecku(slot_dostawcy); proces_dostawcy_paliwa(); exit(0); }
+
+    // Pula stałych procesów obsługi (--pool)
+    shared_memory->cfg_pula = opcje.pula;
+    for (int i = 0; i < opcje.pula; i++) uruchom_proces_obslugi();
+
+    if (opcje.headless) petla_bez_gui(opcje, wybor);
+
+    // 5. START GUI
+    initscr();
+    noecho();
+    curs_set(0);
+    ustaw_kolory();
+
+    cbreak();
+
+    petla_gui(opcje.fps);
     cleanup(0);
     return 0;
 }
\ No newline at end of file
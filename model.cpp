@@ -0,0 +1,108 @@
+#include "model.h"
+
+#include <algorithm>
+#include <cmath>
+
+const char* const NAZWY_STACJI[LICZBA_STACJI] = {
+    "pas",
+    "bramka",
+    "cysterna",
+};
+
+// (ca^2 + cs^2) / 2 ze wzoru Allena-Cunneena: obsługa stała (cs^2 = 0),
+// przyloty co spawn-rate taktów, ale pas dostaje dwa przesunięte strumienie
+// (lądowania i starty), a czekanie na pasie rozmywa strumień do bramek
+#define ZMIENNOSC 0.25
+
+// Prawdopodobieństwo czekania w M/M/c przy ruchu a < c (Erlang C z rekurencji Erlanga B)
+static double erlang_c(int c, double a) {
+    double b = 1.0;
+    for (int k = 1; k <= c; k++) b = a * b / (k + a * b);
+    double rho = a / c;
+    return b / (1.0 - rho + rho * b);
+}
+
+static WynikStacji stacja(int serwery, double naplyw, double obsluga_s) {
+    WynikStacji s;
+    s.serwery = serwery;
+    s.naplyw = naplyw;
+    s.obsluga_s = obsluga_s;
+    s.obciazenie = naplyw * obsluga_s / serwery;
+    s.czekanie_s = 0;
+    s.czekanie_p99_s = 0;
+    if (s.obciazenie >= 1.0) {
+        s.czekanie_s = INFINITY;
+        s.czekanie_p99_s = INFINITY;
+    } else if (naplyw > 0 && obsluga_s > 0) {
+        // Kolejka maleje w tempie c*mu - lambda: P(W > t) = C * exp(-(c*mu - lambda) * t)
+        double c_czeka = erlang_c(serwery, naplyw * obsluga_s);
+        double tempo = serwery / obsluga_s - naplyw;
+        s.czekanie_s = ZMIENNOSC * c_czeka / tempo;
+        if (c_czeka > 0.01) s.czekanie_p99_s = ZMIENNOSC * std::log(c_czeka / 0.01) / tempo;
+    }
+    return s;
+}
+
+// Zajęcie bramki przy danym czekaniu na cysternę
+static double czas_bramki(const Konfiguracja& cfg, double czekanie_cysterny_s) {
+    double tankowanie_s = czekanie_cysterny_s + CZAS_TANKOWANIA_US / 1e6;
+    if (cfg.cfg_obsluga_rownolegla) {
+        return std::max({ (double)cfg.cfg_sprzatanie + cfg.cfg_boarding_time, (double)cfg.cfg_catering, tankowanie_s });
+    }
+    return cfg.cfg_sprzatanie + cfg.cfg_catering + tankowanie_s + cfg.cfg_boarding_time;
+}
+
+void model_oblicz(const Konfiguracja& cfg, ModelLotniska& m) {
+    double lambda = 1e6 / ((double)cfg.cfg_spawn_rate * TAKT_US);
+    double ladowanie_s = cfg.cfg_landing_time / 1e6;
+    double start_s = (cfg.cfg_czas_startu > 0 ? cfg.cfg_czas_startu : cfg.cfg_landing_time) / 1e6;
+    m.przyloty_h = lambda * 3600;
+
+    // Cysterna, potem bramka (trzyma czekającego na cysternę), potem pas
+    // (dwie operacje na samolot; bez drogi kołowania także czekanie na bramkę)
+    m.stacje[ST_CYSTERNA] = stacja(cfg.cfg_tankers, lambda, CZAS_TANKOWANIA_US / 1e6);
+    const WynikStacji& cysterna = m.stacje[ST_CYSTERNA];
+    m.stacje[ST_BRAMKA] = stacja(cfg.cfg_gates, lambda, czas_bramki(cfg, cysterna.czekanie_s));
+    const WynikStacji& bramka = m.stacje[ST_BRAMKA];
+    double na_pasie_s = ladowanie_s + start_s + (cfg.cfg_kolowanie > 0 ? 0.0 : bramka.czekanie_s);
+    m.stacje[ST_PAS] = stacja(cfg.cfg_runways, 2 * lambda, na_pasie_s / 2);
+    const WynikStacji& pas = m.stacje[ST_PAS];
+
+    // Przepustowość: napływ albo najwęższe gardło (czasy obsługi bez czekania)
+    double pojemnosc[LICZBA_STACJI];
+    pojemnosc[ST_PAS] = cfg.cfg_runways / (ladowanie_s + start_s);
+    pojemnosc[ST_BRAMKA] = cfg.cfg_gates / czas_bramki(cfg, 0.0);
+    pojemnosc[ST_CYSTERNA] = cfg.cfg_tankers / (CZAS_TANKOWANIA_US / 1e6);
+    double dostawy = (double)cfg.cfg_dostawa_paliwa / cfg.cfg_czas_dostawy / FUEL_NEEDED;
+    m.paliwo_obciazenie = lambda / dostawy;
+    double przepustowosc = std::min(lambda, dostawy);
+    m.waskie_gardlo = -1;
+    double najwieksze = m.paliwo_obciazenie;
+    for (int s = 0; s < LICZBA_STACJI; s++) {
+        przepustowosc = std::min(przepustowosc, pojemnosc[s]);
+        if (lambda / pojemnosc[s] > najwieksze) {
+            najwieksze = lambda / pojemnosc[s];
+            m.waskie_gardlo = s;
+        }
+    }
+    m.przepustowosc_h = przepustowosc * 3600;
+
+    m.obsluga_min_s = ladowanie_s + start_s + czas_bramki(cfg, 0.0);
+    if (m.paliwo_obciazenie >= 1.0) {
+        m.obsluga_s = INFINITY;
+        m.obsluga_p99_s = INFINITY;
+    } else {
+        m.obsluga_s = ladowanie_s + start_s + 2 * pas.czekanie_s + bramka.czekanie_s + bramka.obsluga_s;
+        // Ogony czekań składane jak niezależne odchylenia (pas dwa razy)
+        double ogon_pasa = pas.czekanie_p99_s - pas.czekanie_s;
+        double ogon_bramki = bramka.czekanie_p99_s - bramka.czekanie_s;
+        double ogon_cysterny = czas_bramki(cfg, cysterna.czekanie_p99_s) - bramka.obsluga_s;
+        m.obsluga_p99_s = m.obsluga_s + std::sqrt(2 * ogon_pasa * ogon_pasa + ogon_bramki * ogon_bramki +
+                                                  ogon_cysterny * ogon_cysterny);
+    }
+
+    // Terminal: w takcie z prawdopodobieństwem pax-rate % grupa 1-3 osób
+    m.pasazerowie_h = cfg.cfg_pax_rate / 100.0 * 2.0 * 1e6 / TAKT_US * 3600;
+    double miejsca_h = m.przepustowosc_h * cfg.cfg_plane_capacity;
+    m.zaladunek = miejsca_h > 0 ? std::min(1.0, m.pasazerowie_h / miejsca_h) : 0.0;
+}
@@ -0,0 +1,53 @@
+#ifndef MODEL_H
+#define MODEL_H
+
+#include "symulacja.h"
+
+// =============================================================
+// =======  MODEL KOLEJEK LOTNISKA (szacunek analityczny)  =====
+// =============================================================
+//
+// Sieć stacji wielokanałowych w stanie ustalonym, liczona z samej
+// konfiguracji (bez symulacji): pas (lądowania i starty, bez drogi
+// kołowania także czekanie na bramkę), bramka (obsługa naziemna wraz
+// z czekaniem na cysternę), cysterna, magazyn paliwa i terminal.
+// Czekanie na stacji to Erlang C (M/M/c) skalowany współczynnikiem
+// Allena-Cunneena (ca^2 + cs^2) / 2 (ZMIENNOSC, model.cpp). Model służy
+// do odsiania konfiguracji, które nie mają szans (optymalizacja.cpp),
+// nie zastępuje przebiegu: pomija przekierowania, limit drogi kołowania,
+// politykę pasów i chwilowe braki paliwa (liczy tylko średnie dostawy).
+
+enum StacjaModelu {
+    ST_PAS = 0,
+    ST_BRAMKA,
+    ST_CYSTERNA,
+    LICZBA_STACJI
+};
+
+extern const char* const NAZWY_STACJI[LICZBA_STACJI];
+
+struct WynikStacji {
+    int serwery;
+    double naplyw;              // Zgłoszenia / s
+    double obsluga_s;           // Średni czas zajęcia serwera
+    double obciazenie;          // rho = napływ * obsługa / serwery
+    double czekanie_s;          // Średnie czekanie w kolejce (INFINITY przy rho >= 1)
+    double czekanie_p99_s;
+};
+
+struct ModelLotniska {
+    WynikStacji stacje[LICZBA_STACJI];
+    double przyloty_h;          // Napływ samolotów
+    double paliwo_obciazenie;   // Zapotrzebowanie na paliwo / dostawy
+    double przepustowosc_h;     // Odloty w stanie ustalonym: napływ albo wąskie gardło
+    int waskie_gardlo;          // Stacja o największym obciążeniu, -1 = paliwo
+    double obsluga_s;           // Średni czas przylot -> odlot
+    double obsluga_min_s;       // Przylot -> odlot bez czekania (dolna granica)
+    double obsluga_p99_s;       // Oszacowanie p99 (ogony czekań jak niezależne)
+    double pasazerowie_h;       // Napływ pasażerów do terminalu
+    double zaladunek;           // Średnie zapełnienie samolotu (0..1)
+};
+
+void model_oblicz(const Konfiguracja& cfg, ModelLotniska& m);
+
+#endif
@@ -0,0 +1,151 @@
+#include "symulacja.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// =============================================================
+// =======  ZAPIS I ODTWORZENIE PRZEBIEGU (--record/--replay)  =
+// =============================================================
+//
+// Plik zapisu to tekst "klucz=wartosc": scenariusz, ziarno, czas,
+// pula i wszystkie parametry z PARAMETRY (wartości faktycznie użyte
+// na starcie, więc zmiana scenariusza w kodzie nie zmienia odtworzenia),
+// harmonogram zmian z pliku scenariusza, a na końcu skrót wyniku.
+// Polecenia so2ctl nie są zapisywane - przebieg z nimi się nie powtórzy. W zegarze wirtualnym przebieg jest funkcją tych
+// ustawień (zegar.h, losowanie.h), więc odtworzenie daje ten sam skrót;
+// inny skrót to zmiana zachowania symulacji między wersjami kodu.
+
+#define ZAPIS_WERSJA 1
+
+struct ZapisPrzebiegu {
+    int wersja;
+    long long przyloty;         // Do podpowiedzi przy rozbieżności
+    long long odloty;
+    long long pasazerowie_zabrani;
+    unsigned long long skrot;
+};
+
+static uint64_t skrot_fnv(const void* dane, size_t n, uint64_t skrot) {
+    const unsigned char* b = static_cast<const unsigned char*>(dane);
+    for (size_t i = 0; i < n; i++) {
+        skrot ^= b[i];
+        skrot *= 0x100000001B3ULL;
+    }
+    return skrot;
+}
+
+// zbierz_wynik zeruje strukturę, więc wypełnienie też jest powtarzalne
+uint64_t skrot_wyniku(const WynikSymulacji& w) {
+    WynikSymulacji kopia = w;
+    kopia.czas_real_s = 0;
+    return skrot_fnv(&kopia, sizeof(kopia), 0xCBF29CE484222325ULL);
+}
+
+bool zapisz_przebieg(const std::string& plik, int scenariusz, const OpcjeUruchomienia& opcje,
+                     const WynikSymulacji& w) {
+    FILE* f = fopen(plik.c_str(), "w");
+    if (f == nullptr) { perror(plik.c_str()); return false; }
+    fprintf(f, "# Zapis przebiegu: SO2 --replay=%s\n", plik.c_str());
+    fprintf(f, "wersja=%d\n", ZAPIS_WERSJA);
+    fprintf(f, "scenariusz=%d\n", scenariusz);
+    fprintf(f, "ziarno=%u\n", w.ziarno);
+    fprintf(f, "czas=%lld\n", opcje.czas_symulacji_s);
+    fprintf(f, "pula=%d\n", opcje.pula);
+    for (int i = 0; i < LICZBA_PARAMETROW; i++) {
+        fprintf(f, "%s=%d\n", PARAMETRY[i].nazwa, w.cfg.*(PARAMETRY[i].pole));
+    }
+    if (!opcje.nazwa_scenariusza.empty()) fprintf(f, "nazwa=%s\n", opcje.nazwa_scenariusza.c_str());
+    if (opcje.cykl_zmian_us > 0) fprintf(f, "cykl-zmian=%lld\n", (long long)opcje.cykl_zmian_us);
+    for (const ZmianaParametru& z : opcje.zmiany) {
+        fprintf(f, "zmiana=%lld,%s,%d\n", (long long)z.czas_us, PARAMETRY[z.parametr].nazwa, z.wartosc);
+    }
+    fprintf(f, "przyloty=%lld\n", w.przyloty);
+    fprintf(f, "odloty=%lld\n", w.odloty);
+    fprintf(f, "pasazerowie-zabrani=%lld\n", w.pasazerowie_zabrani);
+    fprintf(f, "skrot=%016llx\n", (unsigned long long)skrot_wyniku(w));
+    return fclose(f) == 0;
+}
+
+static bool wczytaj_przebieg(const std::string& plik, OpcjeUruchomienia& o, ZapisPrzebiegu& z) {
+    FILE* f = fopen(plik.c_str(), "r");
+    if (f == nullptr) { perror(plik.c_str()); return false; }
+    memset(&z, 0, sizeof(z));
+    char linia[256];
+    bool jest_skrot = false;
+    bool ok = true;
+    while (ok && fgets(linia, sizeof(linia), f) != nullptr) {
+        if (linia[0] == '#' || linia[0] == '\n') continue;
+        char* rowna = strchr(linia, '=');
+        if (rowna == nullptr) { ok = false; break; }
+        *rowna = '\0';
+        char* w = rowna + 1;
+        w[strcspn(w, "\n")] = '\0';
+        if (strcmp(linia, "wersja") == 0) z.wersja = atoi(w);
+        else if (strcmp(linia, "scenariusz") == 0) o.scenariusz = atoi(w);
+        else if (strcmp(linia, "ziarno") == 0) { o.ziarno = (unsigned)strtoul(w, nullptr, 10); o.ziarno_podane = true; }
+        else if (strcmp(linia, "czas") == 0) o.czas_symulacji_s = atoll(w);
+        else if (strcmp(linia, "pula") == 0) o.pula = atoi(w);
+        else if (strcmp(linia, "przyloty") == 0) z.przyloty = atoll(w);
+        else if (strcmp(linia, "odloty") == 0) z.odloty = atoll(w);
+        else if (strcmp(linia, "pasazerowie-zabrani") == 0) z.pasazerowie_zabrani = atoll(w);
+        else if (strcmp(linia, "skrot") == 0) { z.skrot = strtoull(w, nullptr, 16); jest_skrot = true; }
+        else if (strcmp(linia, "nazwa") == 0) o.nazwa_scenariusza = w;
+        else if (strcmp(linia, "cykl-zmian") == 0) o.cykl_zmian_us = atoll(w);
+        else if (strcmp(linia, "zmiana") == 0) {
+            // czas_us,parametr,wartosc
+            char* p1 = strchr(w, ',');
+            char* p2 = p1 != nullptr ? strchr(p1 + 1, ',') : nullptr;
+            ZmianaParametru zm;
+            zm.parametr = p2 != nullptr ? znajdz_parametr(p1 + 1, p2 - (p1 + 1)) : -1;
+            if (zm.parametr == -1) { ok = false; break; }
+            zm.czas_us = atoll(w);
+            zm.wartosc = atoi(p2 + 1);
+            o.zmiany.push_back(zm);
+        }
+        else {
+            int p = znajdz_parametr(linia, strlen(linia));
+            if (p == -1) ok = false;
+            else o.nadpisania[p] = atoi(w);
+        }
+    }
+    fclose(f);
+
+    if (!ok || !jest_skrot || z.wersja != ZAPIS_WERSJA || o.scenariusz == 0 || !o.ziarno_podane) {
+        fprintf(stderr, "%s: to nie jest zapis przebiegu w wersji %d\n", plik.c_str(), ZAPIS_WERSJA);
+        return false;
+    }
+    return true;
+}
+
+int odtworz_przebieg(const OpcjeUruchomienia& opcje) {
+    OpcjeUruchomienia o;
+    o.plik_sladu = opcje.plik_sladu;
+    ZapisPrzebiegu z;
+    if (!wczytaj_przebieg(opcje.plik_odtworzenia, o, z)) return 1;
+
+    int fd;
+    pid_t pid = uruchom_przebieg_w_tle(o, &fd);
+    if (pid == -1) return 1;
+    WynikSymulacji w;
+    bool odebrany = odbierz_wynik(fd, w);
+    waitpid(pid, NULL, 0);
+    if (!odebrany) {
+        fprintf(stderr, "Odtworzenie: przebieg nie zwrocil wyniku\n");
+        return 1;
+    }
+
+    uint64_t skrot = skrot_wyniku(w);
+    printf("Odtworzenie %s: %s, ziarno %u, %.1f h w %.2f s\n", opcje.plik_odtworzenia.c_str(),
+           w.cfg.scenariusz_nazwa, w.ziarno, w.czas_sym_s / 3600, w.czas_real_s);
+    printf("  przyloty %lld (zapis %lld), odloty %lld (zapis %lld), pasazerowie %lld (zapis %lld)\n",
+           w.przyloty, z.przyloty, w.odloty, z.odloty, w.pasazerowie_zabrani, z.pasazerowie_zabrani);
+    if (skrot == z.skrot) {
+        printf("Skrot %016llx: zgodny\n", (unsigned long long)skrot);
+        return 0;
+    }
+    printf("ROZBIEZNOSC: skrot %016llx, w zapisie %016llx\n", (unsigned long long)skrot, z.skrot);
+    return 2;
+}
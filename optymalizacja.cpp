@@ -0,0 +1,239 @@
+#include "model.h"
+#include "symulacja.h"
+#include "zdarzenia.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <iostream>
+
+// =============================================================
+// =======  OPTYMALIZACJA KONFIGURACJI (--optimize)  ===========
+// =============================================================
+//
+// Najtańsza konfiguracja, która przy ruchu scenariusza osiąga cel
+// przepustowości (odloty/h) i p99 czasu przylot -> odlot:
+//
+//   1. siatka z --range (domyślnie pasy 1-4, bramki 1-20, cysterny 1-10)
+//   2. odsianie modelem kolejek (model.h) z zapasem na jego błąd
+//   3. kandydaci od najtańszego, partiami po tyle, ile przebiegów
+//      mieści --jobs, każdy w --replications replikacjach o wspólnych
+//      ziarnach; koniec, gdy przebieg potwierdzi kandydata, a tańszych
+//      do sprawdzenia już nie ma
+//
+// Koszt to suma koszt(P) * wartość(P) (--cost=P=C). Model odsiewa
+// z zapasem, bo przebieg i tak sprawdza każdego kandydata, a kolejność
+// po koszcie sprawia, że pierwszy potwierdzony jest najtańszy.
+
+#define OPT_ZAPAS_PRZEPUSTOWOSCI 0.9   // Model: przepustowość >= 0.9 celu
+#define OPT_ZAPAS_P99 1.5              // Model: p99 <= 1.5 celu (oszacowanie z góry)
+#define OPT_TOLERANCJA 0.02            // Przebieg: przepustowość >= 98% celu
+
+typedef std::array<int, LICZBA_PARAMETROW> PunktPrzegladu;
+
+struct Kandydat {
+    PunktPrzegladu punkt;              // Pełna konfiguracja (bez -1)
+    double koszt;
+    ModelLotniska model;
+    int replikacje = 0;                // Odebrane wyniki przebiegów
+    double odloty_h = 0;               // Sumy po replikacjach
+    double p99_s = 0;
+    bool spelnia = false;
+};
+
+static PunktPrzegladu punkt_z_konfiguracji(const Konfiguracja& cfg) {
+    PunktPrzegladu p;
+    for (int i = 0; i < LICZBA_PARAMETROW; i++) p[i] = cfg.*(PARAMETRY[i].pole);
+    return p;
+}
+
+static Konfiguracja konfiguracja_z_punktu(const Konfiguracja& baza, const PunktPrzegladu& p) {
+    Konfiguracja cfg = baza;
+    for (int i = 0; i < LICZBA_PARAMETROW; i++) cfg.*(PARAMETRY[i].pole) = p[i];
+    return cfg;
+}
+
+// Odloty/h bez rozbiegu: pierwsze odloty pojawiają się po czasie obsługi
+static double przepustowosc_przebiegu(const WynikSymulacji& w) {
+    double okno_s = w.czas_sym_s - w.sredni_czas_obslugi_s;
+    return okno_s > 0 ? w.odloty * 3600.0 / okno_s : 0.0;
+}
+
+static void wypisz_naglowek(const std::vector<ZakresParametru>& zakresy) {
+    for (const ZakresParametru& z : zakresy) printf("%14s ", PARAMETRY[z.parametr].nazwa);
+    printf("%8s | %9s %8s %9s | %10s %8s %s\n", "koszt", "model/h", "p99 s", "gardlo", "przebieg/h", "p99 s", "wynik");
+}
+
+static void wypisz_kandydata(const Kandydat& k, const std::vector<ZakresParametru>& zakresy) {
+    for (const ZakresParametru& z : zakresy) printf("%14d ", k.punkt[z.parametr]);
+    const char* gardlo = k.model.waskie_gardlo == -1 ? "paliwo" : NAZWY_STACJI[k.model.waskie_gardlo];
+    printf("%8.0f | %9.1f %8.1f %9s | ", k.koszt, k.model.przepustowosc_h, k.model.obsluga_p99_s, gardlo);
+    if (k.replikacje > 0) {
+        printf("%10.1f %8.1f %s\n", k.odloty_h / k.replikacje, k.p99_s / k.replikacje, k.spelnia ? "OK" : "-");
+    } else {
+        printf("%10s %8s %s\n", "", "", "brak wyniku");
+    }
+}
+
+int optymalizuj(const OpcjeUruchomienia& opcje) {
+    // --- KONFIGURACJA BAZOWA ---
+    OpcjeUruchomienia wzor = opcje;
+    wzor.optymalizacja = false;
+    wzor.plik_sladu.clear();
+    wzor.plik_dziennika.clear();
+    if (wzor.scenariusz == 0) wzor.scenariusz = 1;
+    // Silnik zdarzeń: setki krótkich przebiegów bez procesu na samolot
+    if (wzor.nadpisania[PARAM_ENGINE] == -1) wzor.nadpisania[PARAM_ENGINE] = SILNIK_ZDARZENIA;
+    if (wzor.cel_odloty_h > 0 && wzor.nadpisania[PARAM_SPAWN_RATE] == -1) {
+        // Ruch dokładnie na cel: samolot co spawn-rate taktów po 0.1 s
+        wzor.nadpisania[PARAM_SPAWN_RATE] = std::max(1, (int)(36000.0 / wzor.cel_odloty_h));
+    }
+
+    Konfiguracja baza = {};
+    ustaw_scenariusz(wzor.scenariusz, baza);
+    for (int i = 0; i < LICZBA_PARAMETROW; i++) {
+        if (wzor.nadpisania[i] >= 0) baza.*(PARAMETRY[i].pole) = wzor.nadpisania[i];
+    }
+    ModelLotniska model_bazy;
+    model_oblicz(baza, model_bazy);
+
+    double cel_h = wzor.cel_odloty_h > 0 ? wzor.cel_odloty_h : model_bazy.przyloty_h;
+    if (cel_h > model_bazy.przyloty_h * (1 + OPT_TOLERANCJA)) {
+        std::cerr << "Cel " << cel_h << " odlotow/h ponad przyloty scenariusza (" << model_bazy.przyloty_h
+                  << "/h przy spawn-rate=" << baza.cfg_spawn_rate << ")" << std::endl;
+        return 1;
+    }
+    // Domyślnie p99 do dwukrotności obsługi bez czekania
+    double cel_p99 = wzor.cel_p99_s > 0 ? wzor.cel_p99_s : 2 * model_bazy.obsluga_min_s;
+
+    double koszty[LICZBA_PARAMETROW] = {};
+    koszty[PARAM_RUNWAYS] = 100;
+    koszty[PARAM_GATES] = 10;
+    koszty[PARAM_TANKERS] = 5;
+    koszty[PARAM_BOARDING_TIME] = -1;    // Krótszy postój = więcej obsługi naziemnej
+    for (const std::pair<int, int>& k : wzor.koszty) koszty[k.first] = k.second;
+
+    std::vector<ZakresParametru> zakresy = wzor.zakresy;
+    if (zakresy.empty()) {
+        zakresy.push_back({ PARAM_RUNWAYS, 1, 4, 1 });
+        zakresy.push_back({ PARAM_GATES, 1, 20, 1 });
+        zakresy.push_back({ PARAM_TANKERS, 1, 10, 1 });
+    }
+
+    // --- SIATKA I ODSIANIE MODELEM ---
+    std::vector<PunktPrzegladu> punkty(1, punkt_z_konfiguracji(baza));
+    for (const ZakresParametru& z : zakresy) {
+        std::vector<PunktPrzegladu> nowe;
+        for (const PunktPrzegladu& p : punkty) {
+            for (int v = z.min; v <= z.max; v += z.krok) {
+                PunktPrzegladu q = p;
+                q[z.parametr] = v;
+                nowe.push_back(q);
+            }
+        }
+        punkty.swap(nowe);
+    }
+    std::vector<Kandydat> kandydaci;
+    for (const PunktPrzegladu& p : punkty) {
+        Kandydat k;
+        k.punkt = p;
+        k.koszt = 0;
+        for (int i = 0; i < LICZBA_PARAMETROW; i++) k.koszt += koszty[i] * p[i];
+        model_oblicz(konfiguracja_z_punktu(baza, p), k.model);
+        if (k.model.przepustowosc_h >= OPT_ZAPAS_PRZEPUSTOWOSCI * cel_h && k.model.obsluga_min_s <= cel_p99 &&
+            k.model.obsluga_p99_s <= OPT_ZAPAS_P99 * cel_p99) {
+            kandydaci.push_back(k);
+        }
+    }
+    std::stable_sort(kandydaci.begin(), kandydaci.end(), [](const Kandydat& a, const Kandydat& b) {
+        if (a.koszt != b.koszt) return a.koszt < b.koszt;
+        return a.model.obsluga_p99_s < b.model.obsluga_p99_s;
+    });
+
+    int replikacje = wzor.replikacje > 0 ? wzor.replikacje : 1;
+    int zadania = liczba_zadan(wzor);
+    int partia = std::max(1, (zadania + replikacje - 1) / replikacje);
+    unsigned ziarno_bazowe = wzor.ziarno_podane ? wzor.ziarno : (unsigned)time(NULL);
+
+    printf("%s, %lld s na przebieg, %d replikacji\n", baza.scenariusz_nazwa, wzor.czas_symulacji_s, replikacje);
+    printf("Cel: %.1f odlotow/h (przyloty %.1f/h), p99 przylot-odlot <= %.1f s\n", cel_h, model_bazy.przyloty_h,
+           cel_p99);
+    printf("Model scenariusza:");
+    for (int s = 0; s < LICZBA_STACJI; s++) {
+        printf(" %s %d x rho %.2f,", NAZWY_STACJI[s], model_bazy.stacje[s].serwery, model_bazy.stacje[s].obciazenie);
+    }
+    printf(" paliwo rho %.2f, zaladunek %.0f%%\n", model_bazy.paliwo_obciazenie, 100 * model_bazy.zaladunek);
+    printf("Siatka: %zu punktow, po modelu zostalo %zu\n\n", punkty.size(), kandydaci.size());
+    if (kandydaci.empty()) {
+        printf("Zaden punkt siatki nie ma szans na cel (poszerz --range albo zlagodz cel)\n");
+        return 2;
+    }
+
+    // --- PRZEBIEGI ---
+    wypisz_naglowek(zakresy);
+    int najlepszy = -1;
+    int proby = 0;
+    size_t nastepny = 0;
+    while (nastepny < kandydaci.size() && proby < wzor.max_prob) {
+        // Tańszych od potwierdzonego już nie ma
+        if (najlepszy != -1 && kandydaci[nastepny].koszt > kandydaci[najlepszy].koszt) break;
+
+        std::vector<size_t> wybrani;
+        while (nastepny < kandydaci.size() && (int)wybrani.size() < partia && proby < wzor.max_prob) {
+            wybrani.push_back(nastepny++);
+            proby++;
+        }
+
+        std::vector<OpcjeUruchomienia> przebiegi;
+        for (size_t w : wybrani) {
+            for (int r = 0; r < replikacje; r++) {
+                OpcjeUruchomienia o = wzor;
+                for (int i = 0; i < LICZBA_PARAMETROW; i++) o.nadpisania[i] = kandydaci[w].punkt[i];
+                // Wspólne ziarna: różnice między kandydatami nie giną w szumie
+                o.ziarno_podane = true;
+                o.ziarno = ziarno_bazowe + r;
+                przebiegi.push_back(o);
+            }
+        }
+        bool ok = uruchom_rownolegle(przebiegi, zadania, [&](size_t n, const WynikSymulacji* w) {
+            if (w == nullptr) return;
+            Kandydat& k = kandydaci[wybrani[n / replikacje]];
+            k.replikacje++;
+            k.odloty_h += przepustowosc_przebiegu(*w);
+            k.p99_s += w->p99_czas_obslugi_s;
+        });
+        if (!ok) return 1;
+
+        for (size_t w : wybrani) {
+            Kandydat& k = kandydaci[w];
+            k.spelnia = k.replikacje == replikacje && k.odloty_h / replikacje >= (1 - OPT_TOLERANCJA) * cel_h &&
+                        k.p99_s / replikacje <= cel_p99;
+            wypisz_kandydata(k, zakresy);
+            if (k.spelnia && (najlepszy == -1 || k.koszt < kandydaci[najlepszy].koszt ||
+                              (k.koszt == kandydaci[najlepszy].koszt && k.p99_s < kandydaci[najlepszy].p99_s))) {
+                najlepszy = (int)w;
+            }
+        }
+        fflush(stdout);
+    }
+
+    printf("\nPrzebiegi: %d kandydatow x %d replikacji\n", proby, replikacje);
+    if (najlepszy == -1) {
+        printf("Nie znaleziono konfiguracji spelniajacej cel%s\n",
+               nastepny < kandydaci.size() ? " (limit --max-trials)" : "");
+        return 2;
+    }
+    const Kandydat& k = kandydaci[najlepszy];
+    printf("NAJTANSZA (koszt %.0f): odloty %.1f/h, p99 %.1f s\n ", k.koszt, k.odloty_h / k.replikacje,
+           k.p99_s / k.replikacje);
+    if (!wzor.plik_scenariusza.empty()) printf(" --scenario-file=%s", wzor.plik_scenariusza.c_str());
+    else printf(" --scenario=%d", wzor.scenariusz);
+    for (const ZakresParametru& z : zakresy) printf(" --%s=%d", PARAMETRY[z.parametr].nazwa, k.punkt[z.parametr]);
+    if (wzor.nadpisania[PARAM_SPAWN_RATE] != opcje.nadpisania[PARAM_SPAWN_RATE]) {
+        printf(" --spawn-rate=%d", wzor.nadpisania[PARAM_SPAWN_RATE]);
+    }
+    printf("\n");
+    return 0;
+}
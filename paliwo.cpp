@@ -0,0 +1,120 @@
+#include "paliwo.h"
+#include "zegar.h"
+
+#include <algorithm>
+#include <climits>
+#include <unistd.h>
+
+void magazyn_init(MagazynPaliwa* m, int pojemnosc, int stan) {
+    blokada_init(&m->blokada);
+    m->pojemnosc = pojemnosc;
+    m->stan.store(std::min(stan, pojemnosc));
+    m->glowa = -1;
+    m->ogon = -1;
+    m->czekajacy = 0;
+    m->brak_od_us = -1;
+    m->brak_us = 0;
+    for (int i = 0; i < SLOTY_MAX; i++) {
+        m->wolne_zgloszenia[i] = SLOTY_MAX - 1 - i;
+        m->zgloszenia[i].wlasciciel = 0;
+    }
+    m->ile_wolnych_zgloszen = SLOTY_MAX;
+}
+
+int64_t magazyn_pobierz(MagazynPaliwa* m, int ilosc) {
+    blokada_wez(&m->blokada);
+    int stan = m->stan.load(std::memory_order_relaxed);
+    if (m->glowa == -1 && stan >= ilosc) {
+        m->stan.store(stan - ilosc, std::memory_order_relaxed);
+        blokada_oddaj(&m->blokada);
+        return 0;
+    }
+
+    int64_t t_start = zegar_teraz_us();
+    int idx = m->wolne_zgloszenia[--m->ile_wolnych_zgloszen];
+    ZgloszeniePaliwa& z = m->zgloszenia[idx];
+    z.przydzielone.store(0, std::memory_order_relaxed);
+    z.ilosc = ilosc;
+    z.slot_zegara = zegar_slot;
+    z.nastepny = -1;
+    z.wlasciciel = getpid();
+    if (m->ogon == -1) m->glowa = idx;
+    else m->zgloszenia[m->ogon].nastepny = idx;
+    m->ogon = idx;
+    if (m->czekajacy++ == 0) m->brak_od_us = t_start;
+    blokada_oddaj(&m->blokada);
+
+    zegar_czekaj_na(&z.przydzielone, INT64_MAX);
+
+    blokada_wez(&m->blokada);
+    z.wlasciciel = 0;
+    m->wolne_zgloszenia[m->ile_wolnych_zgloszen++] = idx;
+    blokada_oddaj(&m->blokada);
+    return zegar_teraz_us() - t_start;
+}
+
+static void koniec_czekania(MagazynPaliwa* m) {
+    if (--m->czekajacy == 0) {
+        m->brak_us += zegar_teraz_us() - m->brak_od_us;
+        m->brak_od_us = -1;
+    }
+}
+
+// Przydział po kolei, na ile starcza; zwraca stan po przydziałach (pod blokadą)
+static int obsluz_czekajacych(MagazynPaliwa* m, int stan) {
+    while (m->glowa != -1 && stan >= m->zgloszenia[m->glowa].ilosc) {
+        ZgloszeniePaliwa& z = m->zgloszenia[m->glowa];
+        stan -= z.ilosc;
+        m->glowa = z.nastepny;
+        if (m->glowa == -1) m->ogon = -1;
+        koniec_czekania(m);
+        zegar_obudz(z.slot_zegara, &z.przydzielone);
+    }
+    return stan;
+}
+
+int magazyn_dostarcz(MagazynPaliwa* m, int ilosc) {
+    blokada_wez(&m->blokada);
+    int stan = obsluz_czekajacych(m, std::min(m->stan.load(std::memory_order_relaxed) + ilosc, m->pojemnosc));
+    m->stan.store(stan, std::memory_order_relaxed);
+    blokada_oddaj(&m->blokada);
+    return stan;
+}
+
+void magazyn_porzuc(MagazynPaliwa* m, pid_t pid) {
+    blokada_wez(&m->blokada);
+    int stan = m->stan.load(std::memory_order_relaxed);
+    for (int idx = 0; idx < SLOTY_MAX; idx++) {
+        ZgloszeniePaliwa& z = m->zgloszenia[idx];
+        if (z.wlasciciel != pid) continue;
+        if (z.przydzielone.load(std::memory_order_acquire) != 0) {
+            stan = std::min(stan + z.ilosc, m->pojemnosc);
+        } else {
+            int poprzedni = -1;
+            int i = m->glowa;
+            while (i != -1 && i != idx) {
+                poprzedni = i;
+                i = m->zgloszenia[i].nastepny;
+            }
+            if (i != -1) {
+                if (poprzedni == -1) m->glowa = z.nastepny;
+                else m->zgloszenia[poprzedni].nastepny = z.nastepny;
+                if (m->ogon == idx) m->ogon = poprzedni;
+                koniec_czekania(m);
+            }
+        }
+        z.wlasciciel = 0;
+        m->wolne_zgloszenia[m->ile_wolnych_zgloszen++] = idx;
+    }
+    // Zwolnione litry albo nowa głowa kolejki mogą ruszyć następnych
+    m->stan.store(obsluz_czekajacych(m, stan), std::memory_order_relaxed);
+    blokada_oddaj(&m->blokada);
+}
+
+int64_t magazyn_czas_braku_us(MagazynPaliwa* m) {
+    blokada_wez(&m->blokada);
+    int64_t brak = m->brak_us;
+    if (m->brak_od_us >= 0) brak += zegar_teraz_us() - m->brak_od_us;
+    blokada_oddaj(&m->blokada);
+    return brak;
+}
@@ -0,0 +1,63 @@
+#ifndef PALIWO_H
+#define PALIWO_H
+
+#include <atomic>
+#include <cstdint>
+#include <sys/types.h>
+
+#include "blokady.h"
+#include "sloty.h"
+
+// =============================================================
+// =======  MAGAZYN PALIWA: POBÓR Z CZEKANIEM NA DOSTAWĘ  ======
+// =============================================================
+//
+// Przydział paliwa jest rezerwacją: litry schodzą ze stanu od razu,
+// więc magazyn nie obieca więcej, niż ma. Przy braku samolot (z
+// cysterną) staje w kolejce FIFO i śpi na fladze swojego zgłoszenia
+// (zegar_czekaj_na). Nowy pobór nie wyprzedza czekających, nawet gdy
+// starczyłoby dla niego. Dostawa przydziela po kolei tyle zgłoszeń,
+// na ile starcza, i budzi dokładnie te.
+//
+// Czekający trzyma cysternę, więc zgłoszeń nie ma więcej niż cystern.
+
+struct alignas(64) ZgloszeniePaliwa {
+    std::atomic<uint32_t> przydzielone;  // 1 = litry zarezerwowane
+    int ilosc;
+    int slot_zegara;
+    int nastepny;                        // Kolejka czekających (-1 = koniec)
+    pid_t wlasciciel;                    // Czekający proces, 0 = zgłoszenie wolne
+};
+
+struct MagazynPaliwa {
+    Blokada blokada;                     // Chroni wszystko poniżej
+    int pojemnosc;
+    std::atomic<int> stan;               // Ekran czyta bez blokady
+    int glowa;
+    int ogon;
+    int czekajacy;
+    int64_t brak_od_us;                  // Początek niedoboru (ktoś czeka), -1 = brak niedoboru
+    int64_t brak_us;                     // Zamknięte okresy niedoboru
+
+    int wolne_zgloszenia[SLOTY_MAX];
+    int ile_wolnych_zgloszen;
+    ZgloszeniePaliwa zgloszenia[SLOTY_MAX];
+};
+
+void magazyn_init(MagazynPaliwa* m, int pojemnosc, int stan);
+
+// Pobór ilosc litrów, w razie braku czeka na dostawę.
+// Zwraca czas czekania [us symulacji], 0 = paliwo było od razu.
+int64_t magazyn_pobierz(MagazynPaliwa* m, int ilosc);
+
+// Zwraca stan magazynu po dostawie i obsłudze czekających
+int magazyn_dostarcz(MagazynPaliwa* m, int ilosc);
+
+// Zgłoszenie zabitego procesu: wyjęcie z kolejki, a litry już mu
+// przydzielone wracają do magazynu (dla następnych czekających)
+void magazyn_porzuc(MagazynPaliwa* m, pid_t pid);
+
+// Łączny czas, w którym ktoś czekał na paliwo (z trwającym okresem)
+int64_t magazyn_czas_braku_us(MagazynPaliwa* m);
+
+#endif
@@ -0,0 +1,36 @@
+#include "pasazerowie.h"
+
+uint64_t pasazerowie_pojemnosc(int kierunki) {
+    uint64_t na_kierunek = PASAZEROWIE_ARENA / (kierunki > 0 ? kierunki : 1);
+    uint64_t pojemnosc = 1;
+    while (pojemnosc * 2 <= na_kierunek) pojemnosc *= 2;
+    return pojemnosc;
+}
+
+void kolejka_init(KolejkaPasazerow* k, uint64_t pojemnosc) {
+    k->glowa = 0;
+    k->ogon = 0;
+    k->maska = pojemnosc - 1;
+    k->odrzuceni = 0;
+}
+
+int kolejka_dodaj(KolejkaPasazerow* k, Pasazer* miejsca, int ile, int64_t t_us) {
+    uint64_t wolne = k->maska + 1 - (k->ogon - k->glowa);
+    int przyjeci = (uint64_t)ile < wolne ? ile : (int)wolne;
+    for (int i = 0; i < przyjeci; i++) miejsca[(k->ogon + i) & k->maska].t_przybycia_us = t_us;
+    k->ogon += przyjeci;
+    k->odrzuceni += ile - przyjeci;
+    return przyjeci;
+}
+
+int kolejka_zabierz(KolejkaPasazerow* k, const Pasazer* miejsca, int ile, int64_t t_us) {
+    uint64_t w_kolejce = k->ogon - k->glowa;
+    int zabrani = (uint64_t)ile < w_kolejce ? ile : (int)w_kolejce;
+    for (int i = 0; i < zabrani; i++) {
+        uint64_t czekanie = (uint64_t)(t_us - miejsca[(k->glowa + i) & k->maska].t_przybycia_us);
+        hist_zapisz_w(&k->czekanie, czekanie);
+        hist_zapisz(HIST_PASAZER_CZEKANIE, czekanie);
+    }
+    k->glowa += zabrani;
+    return zabrani;
+}
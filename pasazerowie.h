@@ -0,0 +1,45 @@
+#ifndef PASAZEROWIE_H
+#define PASAZEROWIE_H
+
+#include <cstdint>
+
+#include "histogram.h"
+
+// =============================================================
+// =======  PASAŻEROWIE JAKO REKORDY (--pax-records=1)  ========
+// =============================================================
+//
+// Każdy pasażer to 8-bajtowy rekord z czasem przybycia do terminalu.
+// Rekordy leżą w jednej arenie w pamięci współdzielonej, pociętej na
+// kolejki FIFO kierunków (pierścienie o pojemności 2^n). Przybycie to
+// dopisanie na ogon, boarding zdejmuje z głowy do pojemności samolotu
+// naraz - bez alokacji, licznik pozycji tylko rośnie.
+//
+// Wszystkie operacje pod blokadą kierunku (KierunekTerminalu).
+
+#define PASAZEROWIE_ARENA (1 << 20)      // Rekordów na wszystkie kierunki
+
+struct Pasazer {
+    int64_t t_przybycia_us;
+};
+
+struct alignas(64) KolejkaPasazerow {
+    uint64_t glowa;             // Następny do zabrania
+    uint64_t ogon;              // Następne wolne miejsce
+    uint64_t maska;             // Pojemność - 1
+    long long odrzuceni;        // Pełna kolejka - nie weszli do terminalu
+    Histogram czekanie;         // Czas przybycie -> boarding [us symulacji]
+};
+
+// Pojemność kolejki jednego kierunku (potęga dwójki)
+uint64_t pasazerowie_pojemnosc(int kierunki);
+
+void kolejka_init(KolejkaPasazerow* k, uint64_t pojemnosc);
+
+// Zwraca liczbę przyjętych (reszta liczona jako odrzuceni)
+int kolejka_dodaj(KolejkaPasazerow* k, Pasazer* miejsca, int ile, int64_t t_us);
+
+// Zdejmuje do ile pasażerów; czasy czekania do histogramu kolejki i HIST_PASAZER_CZEKANIE
+int kolejka_zabierz(KolejkaPasazerow* k, const Pasazer* miejsca, int ile, int64_t t_us);
+
+#endif
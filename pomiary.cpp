@@ -0,0 +1,300 @@
+#include "blokady.h"
+#include "sloty.h"
+#include "symulacja.h"
+#include "wieza.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <sched.h>
+#include <signal.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/ipc.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/sem.h>
+#include <sys/shm.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+
+// =============================================================
+// =======  MIKROPOMIARY PRYMITYWÓW IPC I GORĄCYCH ŚCIEŻEK  ====
+// =============================================================
+//
+// Użycie: pomiary [--procs=N] [--time-ms=N] [--forks=N] [--csv=PLIK]
+//
+// Każdy pomiar z rywalizacją to 1, 2, 4 ... N procesów, które przez
+// --time-ms powtarzają jedną operację; wynik to operacje na sekundę
+// wszystkich procesów razem i średni koszt operacji. Sekcja krytyczna
+// blokad to inkrementacja zwykłego licznika.
+//
+// --csv dopisuje wiersze "pomiar,procesy,operacje_s,ns_na_operacje"
+// do pliku (nagłówek przy pustym pliku) - do śledzenia regresji między
+// wersjami kodu.
+
+#define MAX_PROCESOW 64
+#define POMIAR_SLOTY 64             // Slotów w puli; procesy > slotów pomijane
+#define POMIAR_PASY 2
+#define POMIAR_SEGMENT_MB 64        // Segment dołączony przy pomiarze fork()
+
+struct alignas(64) LicznikProcesu {
+    long long operacje;
+};
+
+struct Wspolne {
+    std::atomic<int> gotowi;
+    std::atomic<int> start;
+    std::atomic<int> stop;
+    alignas(64) std::atomic<uint32_t> futex;     // 0 wolna, 1 zajęta, 2 zajęta i ktoś czeka
+    alignas(64) pthread_mutex_t mutex;
+    Blokada blokada;
+    alignas(64) std::atomic<long long> atomowy;
+    alignas(64) long long chroniony;
+    PulaSlotow sloty;
+    LicznikProcesu liczniki[MAX_PROCESOW];
+    Wieza wieza;
+    ZgloszeniePasa zgloszenia[MAX_PROCESOW];
+};
+
+static Wspolne* wspolne = nullptr;
+static int semid = -1;
+static FILE* csv = nullptr;
+
+// =============================================================
+// =======  OPERACJE  ==========================================
+// =============================================================
+
+typedef void (*Operacja)(int proces);
+
+static void op_semop(int) {
+    struct sembuf p = { 0, -1, 0 };
+    struct sembuf v = { 0, 1, 0 };
+    while (semop(semid, &p, 1) == -1 && errno == EINTR) {}
+    wspolne->chroniony++;
+    semop(semid, &v, 1);
+}
+
+// Mutex na futeksie (Drepper, "Futexes Are Tricky", wariant 2)
+static void op_futex(int) {
+    std::atomic<uint32_t>& f = wspolne->futex;
+    uint32_t c = 0;
+    if (!f.compare_exchange_strong(c, 1, std::memory_order_acquire)) {
+        if (c != 2) c = f.exchange(2, std::memory_order_acquire);
+        while (c != 0) {
+            syscall(SYS_futex, &f, FUTEX_WAIT, 2, nullptr, nullptr, 0);
+            c = f.exchange(2, std::memory_order_acquire);
+        }
+    }
+    wspolne->chroniony++;
+    if (f.fetch_sub(1, std::memory_order_release) != 1) {
+        f.store(0, std::memory_order_release);
+        syscall(SYS_futex, &f, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+    }
+}
+
+static void op_pthread(int) {
+    pthread_mutex_lock(&wspolne->mutex);
+    wspolne->chroniony++;
+    pthread_mutex_unlock(&wspolne->mutex);
+}
+
+static void op_blokada(int) {
+    blokada_wez(&wspolne->blokada);
+    wspolne->chroniony++;
+    blokada_oddaj(&wspolne->blokada);
+}
+
+static void op_atomowy(int) {
+    wspolne->atomowy.fetch_add(1, std::memory_order_relaxed);
+}
+
+static void op_sloty(int proces) {
+    int slot = sloty_zajmij(&wspolne->sloty, (proces * 7) % POMIAR_SLOTY);
+    sloty_zwolnij(&wspolne->sloty, slot);
+}
+
+static void op_wieza(int proces) {
+    int pas = wieza_wez_pas(&wspolne->wieza, proces % LICZBA_OPERACJI, -1);
+    wieza_zwolnij_pas(&wspolne->wieza, pas);
+}
+
+static void op_dodaj_log(int proces) {
+    pomiary_dodaj_log(proces);
+}
+
+// =============================================================
+// =======  POMIAR Z RYWALIZACJĄ  ==============================
+// =============================================================
+
+static double teraz_s() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void wypisz(const char* nazwa, int procesy, long long operacje, double sekundy) {
+    double na_sekunde = sekundy > 0 ? operacje / sekundy : 0.0;
+    double ns = operacje > 0 ? sekundy * 1e9 / operacje : 0.0;
+    printf("%-26s %7d %16.0f %12.1f\n", nazwa, procesy, na_sekunde, ns);
+    if (csv != nullptr) fprintf(csv, "%s,%d,%.0f,%.1f\n", nazwa, procesy, na_sekunde, ns);
+}
+
+static void zmierz(const char* nazwa, Operacja op, int procesy, int czas_ms) {
+    wspolne->gotowi.store(0);
+    wspolne->start.store(0);
+    wspolne->stop.store(0);
+    fflush(nullptr);
+
+    pid_t pidy[MAX_PROCESOW];
+    for (int i = 0; i < procesy; i++) {
+        pidy[i] = fork();
+        if (pidy[i] == 0) {
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            wspolne->gotowi.fetch_add(1);
+            while (wspolne->start.load(std::memory_order_acquire) == 0) sched_yield();
+            long long n = 0;
+            while (wspolne->stop.load(std::memory_order_relaxed) == 0) {
+                op(i);
+                n++;
+            }
+            wspolne->liczniki[i].operacje = n;
+            _exit(0);
+        }
+    }
+    while (wspolne->gotowi.load() < procesy) sched_yield();
+
+    double t0 = teraz_s();
+    wspolne->start.store(1, std::memory_order_release);
+    struct timespec ts = { czas_ms / 1000, (czas_ms % 1000) * 1000000L };
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {}
+    wspolne->stop.store(1);
+    for (int i = 0; i < procesy; i++) waitpid(pidy[i], nullptr, 0);
+    double t1 = teraz_s();
+
+    long long suma = 0;
+    for (int i = 0; i < procesy; i++) suma += wspolne->liczniki[i].operacje;
+    wypisz(nazwa, procesy, suma, t1 - t0);
+}
+
+static void zmierz_serie(const char* nazwa, Operacja op, int procesy_max, int czas_ms, int limit) {
+    for (int p = 1; p <= procesy_max && p <= limit; p *= 2) zmierz(nazwa, op, p, czas_ms);
+}
+
+// =============================================================
+// =======  POMIARY BEZ RYWALIZACJI  ===========================
+// =============================================================
+
+// fork() + exit() + waitpid() procesu samolotu przy dołączonym segmencie
+static void zmierz_fork(int ile, size_t segment_mb) {
+    int id = -1;
+    if (segment_mb > 0) {
+        id = shmget(IPC_PRIVATE, segment_mb << 20, IPC_CREAT | 0600);
+        if (id == -1) { perror("shmget"); return; }
+        void* adres = shmat(id, nullptr, 0);
+        shmctl(id, IPC_RMID, nullptr);
+        if (adres == (void*)-1) { perror("shmat"); return; }
+        memset(adres, 0, segment_mb << 20);
+    }
+    fflush(nullptr);
+    double t0 = teraz_s();
+    for (int i = 0; i < ile; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            exit(0);
+        }
+        waitpid(pid, nullptr, 0);
+    }
+    double t1 = teraz_s();
+    char nazwa[48];
+    snprintf(nazwa, sizeof(nazwa), "fork+exit (segment %zu MB)", segment_mb);
+    wypisz(nazwa, 1, ile, t1 - t0);
+}
+
+static void zmierz_klatki(bool pelna, int czas_ms) {
+    long long n = 0;
+    double t0 = teraz_s();
+    double koniec = t0 + czas_ms / 1000.0;
+    double t;
+    do {
+        pomiary_klatka(pelna);
+        n++;
+        t = teraz_s();
+    } while (t < koniec);
+    wypisz(pelna ? "ekran: pelna klatka" : "ekran: panel bramek", 1, n, t - t0);
+}
+
+int main(int argc, char** argv) {
+    int procesy_max = 4;
+    int czas_ms = 200;
+    int forki = 2000;
+    const char* plik_csv = nullptr;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (strncmp(a, "--procs=", 8) == 0) procesy_max = atoi(a + 8);
+        else if (strncmp(a, "--time-ms=", 10) == 0) czas_ms = atoi(a + 10);
+        else if (strncmp(a, "--forks=", 8) == 0) forki = atoi(a + 8);
+        else if (strncmp(a, "--csv=", 6) == 0) plik_csv = a + 6;
+        else {
+            fprintf(stderr, "Uzycie: %s [--procs=N] [--time-ms=N] [--forks=N] [--csv=PLIK]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (procesy_max < 1 || procesy_max > MAX_PROCESOW || czas_ms < 1 || forki < 1) {
+        fprintf(stderr, "Niepoprawne --procs (1..%d), --time-ms albo --forks\n", MAX_PROCESOW);
+        return 1;
+    }
+    if (plik_csv != nullptr) {
+        csv = fopen(plik_csv, "a");
+        if (csv == nullptr) { perror(plik_csv); return 1; }
+        if (ftell(csv) == 0) fprintf(csv, "pomiar,procesy,operacje_s,ns_na_operacje\n");
+    }
+
+    void* adres = mmap(nullptr, sizeof(Wspolne), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (adres == MAP_FAILED) { perror("mmap"); return 1; }
+    wspolne = new (adres) Wspolne();
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutex_init(&wspolne->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    blokada_init(&wspolne->blokada);
+    sloty_init(&wspolne->sloty, POMIAR_SLOTY);
+    wieza_init(&wspolne->wieza, POLITYKA_FCFS, 1, POMIAR_PASY, POMIAR_PASY, 0, 0, wspolne->zgloszenia, MAX_PROCESOW);
+
+    semid = semget(IPC_PRIVATE, 1, IPC_CREAT | 0600);
+    if (semid == -1) { perror("semget"); return 1; }
+    semctl(semid, 0, SETVAL, 1);
+
+    printf("%-26s %7s %16s %12s\n", "POMIAR", "PROCESY", "OPERACJE/s", "ns/OP");
+    zmierz_serie("semop P/V", op_semop, procesy_max, czas_ms, MAX_PROCESOW);
+    zmierz_serie("futex mutex", op_futex, procesy_max, czas_ms, MAX_PROCESOW);
+    zmierz_serie("pthread_mutex (pshared)", op_pthread, procesy_max, czas_ms, MAX_PROCESOW);
+    zmierz_serie("blokada (blokady.h)", op_blokada, procesy_max, czas_ms, MAX_PROCESOW);
+    zmierz_serie("atomic fetch_add", op_atomowy, procesy_max, czas_ms, MAX_PROCESOW);
+    zmierz_serie("sloty zajmij/zwolnij", op_sloty, procesy_max, czas_ms, POMIAR_SLOTY);
+    zmierz_serie("wieza wez/zwolnij pas", op_wieza, procesy_max, czas_ms, MAX_PROCESOW);
+    semctl(semid, 0, IPC_RMID);
+
+    zmierz_fork(forki, 0);
+    zmierz_fork(forki, POMIAR_SEGMENT_MB);
+
+    // Ścieżki na prawdziwym segmencie (scenariusz C, main.cpp)
+    if (!pomiary_przygotuj(3)) return 1;
+    zmierz_serie("dodaj_log", op_dodaj_log, procesy_max, czas_ms, MAX_PROCESOW);
+    if (pomiary_ekran_init(60, 200)) {
+        zmierz_klatki(true, czas_ms);
+        zmierz_klatki(false, czas_ms);
+        pomiary_ekran_koniec();
+    } else {
+        fprintf(stderr, "Brak terminfo xterm-256color - pomiar ekranu pominiety\n");
+    }
+
+    if (csv != nullptr) fclose(csv);
+    return 0;
+}
@@ -0,0 +1,222 @@
+#include "symulacja.h"
+
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// =============================================================
+// =======  PRZEBIEG W PROCESIE POTOMNYM  ======================
+// =============================================================
+
+pid_t uruchom_przebieg_w_tle(const OpcjeUruchomienia& opcje, int* fd_wyniku) {
+    int rura[2];
+    if (pipe(rura) == -1) { perror("pipe"); return -1; }
+
+    // Bufor stdio (np. nagłówek CSV) nie może trafić do dziecka
+    fflush(nullptr);
+    pid_t pid = fork();
+    if (pid == -1) {
+        perror("fork");
+        close(rura[0]);
+        close(rura[1]);
+        return -1;
+    }
+    if (pid == 0) {
+        close(rura[0]);
+        OpcjeUruchomienia o = opcje;
+        o.headless = true;
+        o.tryb_zegara = ZEGAR_WIRTUALNY;
+        o.prywatne_ipc = true;
+        o.wynik_fd = rura[1];
+        if (o.scenariusz == 0) o.scenariusz = 1;
+        exit(uruchom_symulacje(o));
+    }
+    close(rura[1]);
+    *fd_wyniku = rura[0];
+    return pid;
+}
+
+bool odbierz_wynik(int fd, WynikSymulacji& wynik) {
+    size_t odebrane = 0;
+    char* bufor = (char*)&wynik;
+    while (odebrane < sizeof(wynik)) {
+        ssize_t n = read(fd, bufor + odebrane, sizeof(wynik) - odebrane);
+        if (n <= 0) break;
+        odebrane += n;
+    }
+    close(fd);
+    return odebrane == sizeof(wynik);
+}
+
+int liczba_zadan(const OpcjeUruchomienia& opcje) {
+    int zadania = opcje.zadania;
+    if (zadania <= 0) zadania = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    return zadania > 0 ? zadania : 1;
+}
+
+bool uruchom_rownolegle(const std::vector<OpcjeUruchomienia>& przebiegi, int zadania,
+                        const std::function<void(size_t, const WynikSymulacji*)>& gotowy) {
+    // Przebiegi w toku: pid -> (deskryptor wyniku, indeks przebiegu)
+    std::map<pid_t, std::pair<int, size_t>> w_toku;
+    size_t nastepny = 0;
+    size_t zakonczone = 0;
+
+    while (zakonczone < przebiegi.size()) {
+        while ((int)w_toku.size() < zadania && nastepny < przebiegi.size()) {
+            int fd = -1;
+            pid_t pid = uruchom_przebieg_w_tle(przebiegi[nastepny], &fd);
+            if (pid == -1) {
+                // Bez sierot: przebiegi w toku nie dadzą już pełnego wyniku
+                for (auto& p : w_toku) {
+                    kill(p.first, SIGKILL);
+                    waitpid(p.first, nullptr, 0);
+                    close(p.second.first);
+                }
+                return false;
+            }
+            w_toku[pid] = std::make_pair(fd, nastepny);
+            nastepny++;
+        }
+
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid == -1) break;
+        auto it = w_toku.find(pid);
+        if (it == w_toku.end()) continue;
+
+        WynikSymulacji w;
+        bool jest = odbierz_wynik(it->second.first, w);
+        gotowy(it->second.second, jest ? &w : nullptr);
+        w_toku.erase(it);
+        zakonczone++;
+    }
+    return zakonczone == przebiegi.size();
+}
+
+// =============================================================
+// =======  PRZEGLĄD PARAMETRÓW (--sweep)  =====================
+// =============================================================
+
+typedef std::array<int, LICZBA_PARAMETROW> PunktPrzegladu;
+
+// Iloczyn kartezjański zakresów; parametry bez zakresu zostają z opcji
+static std::vector<PunktPrzegladu> siatka_punktow(const OpcjeUruchomienia& opcje) {
+    PunktPrzegladu baza;
+    for (int i = 0; i < LICZBA_PARAMETROW; i++) baza[i] = opcje.nadpisania[i];
+
+    std::vector<PunktPrzegladu> punkty(1, baza);
+    for (const ZakresParametru& z : opcje.zakresy) {
+        std::vector<PunktPrzegladu> nowe;
+        for (const PunktPrzegladu& p : punkty) {
+            for (int v = z.min; v <= z.max; v += z.krok) {
+                PunktPrzegladu q = p;
+                q[z.parametr] = v;
+                nowe.push_back(q);
+            }
+        }
+        punkty.swap(nowe);
+    }
+    return punkty;
+}
+
+static void naglowek_csv(FILE* f) {
+    fprintf(f, "scenario,runways,gates,tankers,directions,spawn_rate,pax_rate,boarding_time,capacity,landing_time_us,taxiway,divert_after_s,"
+               "ground_ops,cleaning_s,catering_s,runway_policy,runway_batch,takeoff_time_us,pax_records,direction_policy,fuel_delivery,delivery_time_s,engine,"
+               "replication,seed,sim_s,real_s,arrivals,rejected,departures,departures_per_h,full_departures,"
+               "avg_turnaround_s,max_turnaround_s,avg_planes_in_system,max_planes_in_system,"
+               "avg_runway_queue,max_runway_queue,avg_gate_queue,"
+               "pax_arrived,pax_boarded,avg_pax_waiting,avg_pax_wait_s,fuel_starved,runway_util,gate_util,"
+               "landings,takeoffs,runway_ops_per_h,p99_landing_wait_s,p99_takeoff_wait_s,p99_gate_wait_s,p99_tanker_wait_s,"
+               "diverted,avg_holding,max_holding,avg_taxiway,pax_wait_measured_s,p99_pax_wait_s,"
+               "pax_boarded_per_h,load_factor,p99_fuel_wait_s,fuel_gate_share,fuel_shortage_share,p99_turnaround_s,"
+               "kill_every,killed,reclaimed\n");
+}
+
+static void wiersz_csv(FILE* f, const WynikSymulacji& w, int replikacja) {
+    const Konfiguracja& c = w.cfg;
+    double godziny = w.czas_sym_s / 3600.0;
+    fprintf(f, "\"%s\",%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,", c.scenariusz_nazwa, c.cfg_runways,
+            c.cfg_gates, c.cfg_tankers, c.cfg_kierunki, c.cfg_spawn_rate, c.cfg_pax_rate, c.cfg_boarding_time,
+            c.cfg_plane_capacity, c.cfg_landing_time, c.cfg_kolowanie, c.cfg_przekierowanie,
+            c.cfg_obsluga_rownolegla, c.cfg_sprzatanie, c.cfg_catering, c.cfg_polityka_pasow,
+            c.cfg_paczka_pasow, c.cfg_czas_startu, c.cfg_rekordy_pasazerow, c.cfg_przydzial_kierunkow,
+            c.cfg_dostawa_paliwa, c.cfg_czas_dostawy, c.cfg_silnik);
+    fprintf(f, "%d,%u,%.1f,%.3f,%lld,%lld,%lld,%.2f,%lld,", replikacja, w.ziarno, w.czas_sym_s, w.czas_real_s,
+            w.przyloty, w.odrzucone, w.odloty, godziny > 0 ? w.odloty / godziny : 0.0, w.pelne);
+    fprintf(f, "%.3f,%.3f,%.3f,%d,%.3f,%d,%.3f,", w.sredni_czas_obslugi_s, w.max_czas_obslugi_s,
+            w.srednio_w_systemie, w.max_w_systemie, w.srednia_kolejka_pas, w.max_kolejka_pas,
+            w.srednia_kolejka_bramka);
+    fprintf(f, "%lld,%lld,%.3f,%.3f,%lld,%.4f,%.4f,", w.pasazerowie_przybyli, w.pasazerowie_zabrani,
+            w.srednio_pasazerow_czeka, w.sredni_czas_czekania_pasazera_s, w.bez_paliwa,
+            w.wykorzystanie_pasow, w.wykorzystanie_bramek);
+    fprintf(f, "%lld,%lld,%.2f,", w.ladowania, w.starty, godziny > 0 ? (w.ladowania + w.starty) / godziny : 0.0);
+    fprintf(f, "%.3f,%.3f,%.3f,%.3f,", w.p99_czekanie_ladowanie_s, w.p99_czekanie_start_s, w.p99_czekanie_bramka_s,
+            w.p99_czekanie_cysterna_s);
+    fprintf(f, "%lld,%.3f,%d,%.3f,", w.przekierowane, w.srednio_w_powietrzu, w.max_w_powietrzu,
+            w.srednio_na_kolowaniu);
+    fprintf(f, "%.3f,%.3f,", w.zmierzone_czekanie_pasazera_s, w.p99_czekanie_pasazera_s);
+    fprintf(f, "%.2f,%.4f,", godziny > 0 ? w.pasazerowie_zabrani / godziny : 0.0,
+            w.odloty > 0 ? (double)w.pasazerowie_zabrani / ((double)w.odloty * c.cfg_plane_capacity) : 0.0);
+    fprintf(f, "%.3f,%.4f,%.4f,", w.p99_czekanie_paliwo_s, w.paliwo_w_bramkach, w.niedobor_paliwa);
+    fprintf(f, "%.3f,", w.p99_czas_obslugi_s);
+    fprintf(f, "%d,%lld,%lld\n", c.cfg_zabijanie, w.zabite, w.odzyskane);
+}
+
+int przeglad_parametrow(const OpcjeUruchomienia& opcje) {
+    std::vector<PunktPrzegladu> punkty = siatka_punktow(opcje);
+    int replikacje = opcje.replikacje > 0 ? opcje.replikacje : 1;
+    int wszystkie = (int)punkty.size() * replikacje;
+    int zadania = liczba_zadan(opcje);
+    unsigned ziarno_bazowe = opcje.ziarno_podane ? opcje.ziarno : (unsigned)time(NULL);
+
+    FILE* csv = stdout;
+    if (!opcje.plik_csv.empty()) {
+        csv = fopen(opcje.plik_csv.c_str(), "w");
+        if (csv == nullptr) { perror(opcje.plik_csv.c_str()); return 1; }
+    }
+    naglowek_csv(csv);
+
+    std::cerr << "Przeglad: " << punkty.size() << " punktow x " << replikacje << " replikacji, "
+              << zadania << " rownolegle" << std::endl;
+
+    std::vector<OpcjeUruchomienia> przebiegi;
+    for (int n = 0; n < wszystkie; n++) {
+        const PunktPrzegladu& p = punkty[n / replikacje];
+        OpcjeUruchomienia o = opcje;
+        o.przeglad = false;
+        o.plik_sladu.clear();    // Przebiegi nadpisywałyby jeden plik
+        o.plik_dziennika.clear();
+        for (int i = 0; i < LICZBA_PARAMETROW; i++) o.nadpisania[i] = p[i];
+        o.ziarno_podane = true;
+        o.ziarno = ziarno_bazowe + n;
+        przebiegi.push_back(o);
+    }
+
+    int zakonczone = 0;
+    int bledy = 0;
+    bool ok = uruchom_rownolegle(przebiegi, zadania, [&](size_t n, const WynikSymulacji* w) {
+        if (w != nullptr) {
+            wiersz_csv(csv, *w, (int)n % replikacje);
+            fflush(csv);
+        } else {
+            bledy++;
+        }
+        zakonczone++;
+        std::cerr << "\r" << zakonczone << "/" << wszystkie << std::flush;
+    });
+    std::cerr << std::endl;
+
+    if (csv != stdout) fclose(csv);
+    if (!ok) return 1;
+    if (bledy > 0) {
+        std::cerr << "Przebiegi bez wyniku: " << bledy << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,29 @@
+#include "przydzial.h"
+
+#include <cstdint>
+
+const char* const NAZWY_PRZYDZIALU[LICZBA_POLITYK_PRZYDZIALU] = {
+    "losowy",
+    "najwieksza kolejka",
+    "kolejka na miejsce",
+};
+
+// a lepszy od b: porównanie ułamków czekajacy / (obiecane + pojemnosc) bez dzielenia
+static bool lepszy(int polityka, int64_t czek_a, int64_t obie_a, int64_t czek_b, int64_t obie_b, int pojemnosc) {
+    if (polityka == PRZYDZIAL_KOLEJKA) return czek_a - obie_a > czek_b - obie_b;
+    return czek_a * (obie_b + pojemnosc) > czek_b * (obie_a + pojemnosc);
+}
+
+int przydzial_wybierz(int polityka, const int* czekajacy, const int* obiecane, int kierunki, int pojemnosc,
+                      int wylosowany) {
+    if (polityka == PRZYDZIAL_LOSOWY || kierunki <= 1) return wylosowany;
+
+    int najlepszy = wylosowany;
+    for (int n = 1; n < kierunki; n++) {
+        int k = (wylosowany + n) % kierunki;
+        if (lepszy(polityka, czekajacy[k], obiecane[k], czekajacy[najlepszy], obiecane[najlepszy], pojemnosc)) {
+            najlepszy = k;
+        }
+    }
+    return najlepszy;
+}
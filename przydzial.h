@@ -0,0 +1,26 @@
+#ifndef PRZYDZIAL_H
+#define PRZYDZIAL_H
+
+// =============================================================
+// =======  PRZYDZIAŁ KIERUNKU SAMOLOTU (--direction-policy)  ==
+// =============================================================
+//
+// Kierunek wybierany jest na bramce, z zaległości terminalu (pasażerowie
+// czekający na kierunek) i miejsc już obiecanych temu kierunkowi przez
+// samoloty stojące na bramkach, które jeszcze nie zabrały pasażerów.
+// Remisy rozstrzyga kolejność od kierunku wylosowanego przy przylocie.
+
+enum PolitykaPrzydzialu {
+    PRZYDZIAL_LOSOWY = 0,       // Kierunek wylosowany przy przylocie
+    PRZYDZIAL_KOLEJKA,          // Najwięcej czekających ponad obiecane miejsca
+    PRZYDZIAL_NA_MIEJSCE,       // Najwięcej czekających na obiecane miejsce (z naszymi)
+    LICZBA_POLITYK_PRZYDZIALU
+};
+
+extern const char* const NAZWY_PRZYDZIALU[LICZBA_POLITYK_PRZYDZIALU];
+
+// czekajacy/obiecane: tablice po kierunkach; pojemnosc: miejsca samolotu
+int przydzial_wybierz(int polityka, const int* czekajacy, const int* obiecane, int kierunki, int pojemnosc,
+                      int wylosowany);
+
+#endif
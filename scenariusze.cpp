@@ -0,0 +1,167 @@
+#include "symulacja.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// =============================================================
+// =======  PLIK SCENARIUSZA (--scenario-file=PLIK)  ===========
+// =============================================================
+//
+// Tekst, wiersz po wierszu ('#' do końca wiersza to komentarz):
+//
+//   name = Awaria pasa w szczycie    nazwa w raporcie i na ekranie
+//   base = 2                         scenariusz 1-5 z ustaw_scenariusz
+//   runways = 3                      parametr z PARAMETRY, jak --runways=3
+//   cycle = 24:00                    harmonogram powtarzany co tyle
+//   [00:10] runways=1 spawn-rate=15  zmiany w chwili GG:MM[:SS] symulacji
+//
+// Wpisy harmonogramu dotyczą tylko parametrów zmienialnych w biegu
+// (kolumna w_biegu) i wykonuje je nadzorca (zmien_w_biegu, main.cpp).
+// Pojemności zainstalowane (max-*) obejmują wszystko, co harmonogram
+// otwiera, więc wpis z harmonogramu nie zostanie odrzucony.
+
+static bool blad(const std::string& plik, int wiersz, const char* format, ...)
+    __attribute__((format(printf, 3, 4)));
+static bool blad(const std::string& plik, int wiersz, const char* format, ...) {
+    fprintf(stderr, "%s:%d: ", plik.c_str(), wiersz);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+    return false;
+}
+
+static char* przytnij(char* s) {
+    while (isspace((unsigned char)*s)) s++;
+    char* koniec = s + strlen(s);
+    while (koniec > s && isspace((unsigned char)koniec[-1])) *--koniec = '\0';
+    return s;
+}
+
+static bool parsuj_liczbe(const char* tekst, int& wartosc) {
+    char* koniec;
+    long v = strtol(tekst, &koniec, 10);
+    if (koniec == tekst || *koniec != '\0' || v < -2147483647L || v > 2147483647L) return false;
+    wartosc = (int)v;
+    return true;
+}
+
+// "GG:MM" albo "GG:MM:SS" czasu symulacji; -1 = błąd
+static int64_t parsuj_godzine(const char* tekst) {
+    int64_t pola[3] = { 0, 0, 0 };
+    int n = 0;
+    const char* c = tekst;
+    while (n < 3) {
+        char* koniec;
+        long v = strtol(c, &koniec, 10);
+        if (koniec == c || v < 0) return -1;
+        pola[n++] = v;
+        c = koniec;
+        if (*c != ':') break;
+        c++;
+    }
+    if (*c != '\0' || n < 2 || pola[1] > 59 || pola[2] > 59) return -1;
+    return ((pola[0] * 60 + pola[1]) * 60 + pola[2]) * 1000000LL;
+}
+
+// "param=wartosc"; false = błąd już zgłoszony
+static bool parsuj_parametr(const std::string& plik, int wiersz, const char* nazwa, size_t dlugosc,
+                            const char* tekst, int& p, int& wartosc) {
+    p = znajdz_parametr(nazwa, dlugosc);
+    if (p == -1) return blad(plik, wiersz, "nieznany parametr %.*s", (int)dlugosc, nazwa);
+    if (!parsuj_liczbe(tekst, wartosc) || wartosc < PARAMETRY[p].min || wartosc > PARAMETRY[p].max) {
+        return blad(plik, wiersz, "%s: wartosc %s poza zakresem %d..%d", PARAMETRY[p].nazwa, tekst,
+                    PARAMETRY[p].min, PARAMETRY[p].max);
+    }
+    return true;
+}
+
+bool wczytaj_plik_scenariusza(const std::string& plik, OpcjeUruchomienia& o) {
+    FILE* f = fopen(plik.c_str(), "r");
+    if (f == nullptr) { perror(plik.c_str()); return false; }
+
+    std::vector<ZmianaParametru> zmiany;
+    int64_t cykl_us = 0;
+    int baza = 0;
+    char linia[1024];
+    int wiersz = 0;
+    bool ok = true;
+    while (ok && fgets(linia, sizeof(linia), f) != nullptr) {
+        wiersz++;
+        char* komentarz = strchr(linia, '#');
+        if (komentarz != nullptr) *komentarz = '\0';
+        char* t = przytnij(linia);
+        if (*t == '\0') continue;
+
+        // --- WPIS HARMONOGRAMU ---
+        if (*t == '[') {
+            char* nawias = strchr(t, ']');
+            if (nawias == nullptr) { ok = blad(plik, wiersz, "brak ']'"); break; }
+            *nawias = '\0';
+            int64_t czas_us = parsuj_godzine(przytnij(t + 1));
+            if (czas_us < 0) { ok = blad(plik, wiersz, "niepoprawny czas '%s' (GG:MM[:SS])", t + 1); break; }
+            int ile = 0;
+            char* stan;
+            for (char* s = strtok_r(nawias + 1, " \t\r\n", &stan); s != nullptr && ok;
+                 s = strtok_r(nullptr, " \t\r\n", &stan)) {
+                char* rowna = strchr(s, '=');
+                if (rowna == nullptr) { ok = blad(plik, wiersz, "oczekiwano param=wartosc, jest '%s'", s); break; }
+                ZmianaParametru z;
+                z.czas_us = czas_us;
+                ok = parsuj_parametr(plik, wiersz, s, rowna - s, rowna + 1, z.parametr, z.wartosc);
+                if (ok && !PARAMETRY[z.parametr].w_biegu) {
+                    ok = blad(plik, wiersz, "%s ustawia sie tylko przy starcie", PARAMETRY[z.parametr].nazwa);
+                }
+                if (ok) { zmiany.push_back(z); ile++; }
+            }
+            if (ok && ile == 0) ok = blad(plik, wiersz, "wpis harmonogramu bez zmian");
+            continue;
+        }
+
+        // --- KLUCZ = WARTOŚĆ ---
+        char* rowna = strchr(t, '=');
+        if (rowna == nullptr) { ok = blad(plik, wiersz, "oczekiwano 'klucz = wartosc' albo '[GG:MM] ...'"); break; }
+        *rowna = '\0';
+        char* klucz = przytnij(t);
+        char* wartosc = przytnij(rowna + 1);
+        if (strcmp(klucz, "name") == 0) {
+            o.nazwa_scenariusza = wartosc;
+        } else if (strcmp(klucz, "base") == 0) {
+            if (!parsuj_liczbe(wartosc, baza) || baza < 1 || baza > 5) ok = blad(plik, wiersz, "base: scenariusz 1-5");
+        } else if (strcmp(klucz, "cycle") == 0) {
+            cykl_us = parsuj_godzine(wartosc);
+            if (cykl_us <= 0) ok = blad(plik, wiersz, "cycle: niepoprawny czas '%s' (GG:MM[:SS])", wartosc);
+        } else {
+            int p, v;
+            ok = parsuj_parametr(plik, wiersz, klucz, strlen(klucz), wartosc, p, v);
+            // Linia poleceń ma pierwszeństwo
+            if (ok && o.nadpisania[p] == -1) o.nadpisania[p] = v;
+        }
+    }
+    fclose(f);
+    if (!ok) return false;
+
+    if (cykl_us > 0) {
+        for (const ZmianaParametru& z : zmiany) {
+            if (z.czas_us >= cykl_us) {
+                fprintf(stderr, "%s: zmiana %s w chwili %lld s nie miesci sie w cyklu %lld s\n", plik.c_str(),
+                        PARAMETRY[z.parametr].nazwa, (long long)(z.czas_us / 1000000), (long long)(cykl_us / 1000000));
+                return false;
+            }
+        }
+    }
+    // W tej samej chwili w kolejności z pliku
+    std::stable_sort(zmiany.begin(), zmiany.end(),
+                     [](const ZmianaParametru& a, const ZmianaParametru& b) { return a.czas_us < b.czas_us; });
+
+    // Plik zastępuje menu wyboru scenariusza
+    if (o.scenariusz == 0) o.scenariusz = (baza != 0) ? baza : 1;
+    o.zmiany = zmiany;
+    o.cykl_zmian_us = cykl_us;
+    return true;
+}
@@ -0,0 +1,275 @@
+#ifndef SEGMENT_H
+#define SEGMENT_H
+
+#include <atomic>
+#include <cstddef>
+#include <ctime>
+
+#include "blokady.h"
+#include "histogram.h"
+#include "paliwo.h"
+#include "sloty.h"
+#include "sterowanie.h"
+#include "symulacja.h"
+#include "wieza.h"
+#include "zegar.h"
+
+// =============================================================
+// =======  UKŁAD SEGMENTU PAMIĘCI WSPÓŁDZIELONEJ  =============
+// =============================================================
+//
+// Wspólny dla symulacji (main.cpp) i narzędzi, które podłączają się
+// do segmentu z zewnątrz (so2stat.cpp). Zmiana układu wymaga
+// przebudowania obu; so2stat sprawdza rozmiar SharedData przez off_pasy.
+
+// Klucze IPC
+#define SHM_KEY 77793
+#define SEM_KEY 88903
+
+// Pasy przydziela wieża (wieza.h), nie semafor
+#define SEM_GATE 0
+#define SEM_CYSTERNA 1
+#define SEM_ZADANIA 2       // Liczba zleceń w kolejce puli (tryb --pool)
+#define SEM_KOLOWANIE 3     // Wolne miejsca na drodze kołowania
+#define LICZBA_SEMAFOROW 4
+
+// Kolejka zleceń dla puli procesów obsługi samolotów
+#define MAX_ZADAN 1024
+
+#define LOG_HISTORY_SIZE 22
+
+// Rekordy zmiennej części segmentu: stan jednego pasa/bramki/cysterny
+// leży razem, każdy rekord we własnej linii cache. Pisze tylko samolot,
+// który zajął slot; wątek ekranu i so2stat czytają bez blokad (bramka:
+// sekwencja).
+struct alignas(64) RekordPasa {
+    std::atomic<int> samolot;   // 0 wolny, id > 0 ląduje, -id startuje (zamknięcie: wieza.pas_zamkniety)
+};
+
+struct alignas(64) RekordBramki {
+    Sekwencja sekwencja;
+    int samolot;            // 0 wolna, -1 zamknięta, inaczej id samolotu
+    int kierunek;
+    int pasazerowie;
+
+    // Czekanie na cysternę (--ground-ops, zegar niewirtualny)
+    int64_t cysterna_klucz;              // Koniec boardingu
+    long long cysterna_numer;            // Bilet: przy równym kluczu kolejność przyjścia
+    int cysterna_poz;                    // Miejsce w kolejka_cystern, -1 = nie czeka
+    std::atomic<uint32_t> cysterna_futex; // 1 = cysterna przekazana
+};
+
+struct alignas(64) RekordCysterny {
+    std::atomic<int> samolot;   // 0 wolna, -1 zamknięta, inaczej id samolotu
+};
+
+// Rejestr procesów obsługi (samolot albo proces puli): co trzyma
+// obsługiwany samolot. Wpis zajmuje i zwalnia nadzorca (pid), resztę
+// pisze sam proces w miejscach, w których zmienia liczniki kolejek albo
+// bierze i oddaje zasoby. Po śmierci procesu od sygnału nadzorca oddaje
+// z wpisu wszystko, co proces trzymał (ODZYSK, main.cpp). Wpisów jest
+// max_procesow (ustal_pojemnosc) - tyle procesów obsługi działa naraz.
+
+// Sloty zegara poza procesami obsługi: nadzorca i dostawca paliwa
+#define UCZESTNICY_NADZORU 2
+
+// Etap obsługi: które liczniki kolejek (SharedData) samolot podbił
+enum EtapSamolotu {
+    ETAP_KRAZY = 0,         // w_powietrzu, czeka_na_pas
+    ETAP_LADUJE,            // Na pasie po lądowaniu
+    ETAP_KOLUJE,            // na_kolowaniu, czeka_na_bramke
+    ETAP_CZEKA_BRAMKA,      // czeka_na_bramke (bez drogi kołowania, na pasie)
+    ETAP_OBSLUGA,           // Przy bramce
+    ETAP_CZEKA_CYSTERNA,    // czeka_na_cysterne
+    ETAP_CZEKA_START,       // czeka_na_pas
+    ETAP_STARTUJE
+};
+
+// Jednostki semaforów trzymane bez slotu (slot zajmowany jest zaraz po nich)
+#define JEDN_KOLOWANIE 1
+#define JEDN_BRAMKA 2
+#define JEDN_CYSTERNA 4
+
+struct alignas(64) RejestrProcesu {
+    pid_t pid;              // 0 = wpis wolny, -1 = zajęty przed fork()
+    int slot_zegara;
+    bool pula;              // Proces puli: nadzorca uruchamia następcę
+    int samolot;            // 0 = bez samolotu w obsłudze
+    int etap;               // EtapSamolotu
+    int pas;                // Trzymane sloty, -1 = brak
+    int bramka;
+    int cysterna;
+    int kierunek;           // Obietnica miejsc (przydziel_kierunek)
+    int jednostki;          // JEDN_*
+};
+
+struct alignas(64) KierunekTerminalu {
+    Blokada blokada;
+    std::atomic<int> pasazerowie;   // Zmiany pod blokadą, odczyt ekranu bez
+    int obiecane;                   // Miejsca samolotów przydzielonych przed boardingiem (blokada_przydzialu)
+    char nazwa[8];                  // N/E/S/W, dalej D05..D256 (MAX_KIERUNKOW)
+};
+
+// Panele ekranu zmieniane przez procesy symulacji. Każda zmiana podbija
+// wersję panelu; wątek ekranu rysuje tylko panele o nowej wersji.
+enum PanelEkranu {
+    PANEL_PALIWO = 0,
+    PANEL_PASY,
+    PANEL_CYSTERNY,
+    PANEL_BRAMKI,
+    PANEL_TERMINAL,
+    PANEL_LOGI,
+    PANEL_RUCH,
+    LICZBA_PANELI
+};
+
+struct alignas(64) WersjaPanelu {
+    std::atomic<uint64_t> wersja;
+};
+
+// Stała część segmentu; za nią (offsety poniżej) tablice rekordów.
+// Pola Konfiguracja to wartości bieżące (zmieniane w biegu).
+struct SharedData : Konfiguracja {
+    Konfiguracja poczatkowa;               // Na starcie przebiegu (wynik, zapis)
+
+    // --- STAN SYMULACJI ---
+    time_t nastepna_dostawa;
+    std::atomic<int> aktywne_samoloty;     // Samoloty w obsłudze (z procesem)
+    int przyloty_czekajace;                // Przyloty czekające na wolny wpis rejestru (pisze nadzorca)
+    int max_procesow;                      // Wpisy rejestru procesów obsługi
+
+    // Wolne sloty (bitmapy atomowe); tablice niżej mówią tylko kto zajmuje.
+    // Pasy przydziela wieża.
+    PulaSlotow wolne_bramki;
+    PulaSlotow wolne_cysterny;
+
+    // Zmniejszona w biegu pojemność: zajęte sloty zamyka ich zwolnienie
+    // (do_zamkniecia), zamknięte czekają w osobnej puli na ponowne otwarcie
+    PulaSlotow zamkniete_bramki;
+    PulaSlotow zamkniete_cysterny;
+    std::atomic<int> bramki_do_zamkniecia;
+    std::atomic<int> cysterny_do_zamkniecia;
+
+    // Polecenia so2ctl (sterowanie.h)
+    SkrzynkaPolecen sterowanie;
+
+    // Układ zmiennej części segmentu (offsety od początku SharedData)
+    size_t off_pasy;
+    size_t off_bramki;
+    size_t off_cysterny;
+    size_t off_kierunki;
+    size_t off_rejestr;
+    size_t off_zgloszenia;  // Zgłoszenia wieży, po jednym na wpis rejestru
+    size_t off_zegar;       // Tablice uczestników zegara (zegar_init)
+    size_t off_kolejki;     // 0 = pasażerowie jako liczniki (bez --pax-records)
+    size_t off_arena;
+    size_t off_slad;        // 0 = bez śladu zdarzeń (--trace)
+    size_t rozmiar_segmentu;
+
+    // Przydział cystern w --ground-ops (zegar niewirtualny; w wirtualnym
+    // ten sam porządek daje zegar_sem_p_prio). Czekające bramki w kopcu
+    // według (cysterna_klucz, cysterna_numer).
+    Blokada blokada_cystern;
+    int cysterny_wolne;
+    int czeka_cystern;
+    long long cysterny_bilety;
+    int kolejka_cystern[SLOTY_MAX];
+
+    // Przydział kierunków (przydzial.h): spójny odczyt wszystkich kierunków
+    Blokada blokada_przydzialu;
+
+    // Kolejka zleceń puli
+    Blokada blokada_zadan;
+    struct {
+        int id;
+        int64_t t_zgloszenia;
+    } zadania[MAX_ZADAN];
+    int zadania_glowa;
+    int zadania_ogon;
+    int zadania_ile;        // Odczyt bez blokady tylko do liczników (samoloty_w_systemie)
+    int cfg_pula;           // 0 = fork() na samolot, N = N stałych procesów
+
+    // Logi (piszący trzyma blokadę, ekran czyta przez sekwencję)
+    Blokada blokada_logow;
+    Sekwencja sekwencja_logow;
+    char historia_logow[LOG_HISTORY_SIZE][60];
+    int log_index;
+
+    // --- STATYSTYKI (raport trybu bez GUI, liczniki atomowe) ---
+    std::atomic<long long> stat_przyloty;            // Samoloty wpuszczone do systemu
+    std::atomic<long long> stat_odrzucone;           // Nie wpuszczone (pełna kolejka zleceń puli)
+    std::atomic<long long> stat_odloty;              // Samoloty, które odleciały
+    std::atomic<long long> stat_pelne;               // Odloty z kompletem pasażerów
+    std::atomic<long long> stat_pasazerowie_przybyli;
+    std::atomic<long long> stat_pasazerowie_zabrani;
+    std::atomic<long long> stat_bez_paliwa;          // Tankowania, które czekały na dostawę
+    std::atomic<long long> stat_paliwo_czekanie_us;  // Łączne czekanie na paliwo (z bramką i cysterną)
+    std::atomic<long long> stat_przekierowane;       // Odesłane na zapasowe po krążeniu
+    std::atomic<long long> stat_obsluga_suma_us;     // Suma czasów przylot -> odlot
+    std::atomic<long long> stat_obsluga_max_us;
+    std::atomic<long long> stat_pas_zajety_us;       // Łączny czas zajęcia pasów
+    std::atomic<long long> stat_gate_zajety_us;      // Łączny czas zajęcia bramek
+    std::atomic<long long> stat_przyloty_sieci;      // Przyloty z innych lotnisk (--network)
+    std::atomic<long long> stat_odloty_sieci;        // Odloty do innych lotnisk
+    long long stat_zabite;                           // Samoloty zabite w obsłudze (pisze nadzorca)
+    long long stat_odzyskane;                        // Zasoby odebrane zabitym
+    long long stat_zmiany;                           // Zmiany parametrów w biegu (pisze nadzorca)
+    long long w_locie_sieci;                         // Lecące tu na koniec (silnik zdarzeń)
+
+    // Kolejki do zasobów (samoloty czekające na semaforze)
+    std::atomic<int> czeka_na_pas;
+    std::atomic<int> czeka_na_bramke;
+    std::atomic<int> czeka_na_cysterne;
+    std::atomic<int> w_powietrzu;          // Krążące: przed zgodą na lądowanie
+    std::atomic<int> na_kolowaniu;         // Po zjeździe z pasa, przed bramką
+
+    // Próbki co takt pętli głównej (pisze tylko nadzorca)
+    long long probki;
+    long long probki_w_systemie;
+    long long probki_kolejka_pas;
+    long long probki_kolejka_bramka;
+    long long probki_pasazerowie_czeka;
+    long long probki_w_powietrzu;
+    long long probki_na_kolowaniu;
+    long long probki_pasy;                 // Czynne pasy/bramki (wykorzystanie przy zmianach)
+    long long probki_bramki;
+    int max_w_systemie;
+    int max_kolejka_pas;
+    int max_w_powietrzu;
+
+    unsigned ziarno;                                 // Ziarno losowania przebiegu
+
+    // --- ZEGAR SYMULACJI ---
+    ZegarWirtualny zegar;
+
+    // Wersje paneli ekranu (PanelEkranu)
+    WersjaPanelu wersje_paneli[LICZBA_PANELI];
+
+    // Histogramy czasów czekania/zajęcia (szardy per proces)
+    TabelaHistogramow histogramy;
+
+    // Kolejka do pasów z polityką przydziału
+    Wieza wieza;
+
+    // Paliwo: rezerwacja przy poborze, czekający budzeni przez dostawę
+    MagazynPaliwa magazyn;
+};
+
+// Tablica rekordów zmiennej części segmentu pod offsetem off
+template <typename T>
+T* rekordy_segmentu(const SharedData* d, size_t off) {
+    return (T*)((char*)d + off);
+}
+
+// Przyleciały, a nie mają jeszcze procesu: w kolejce zleceń puli albo
+// czekają na wpis rejestru
+inline int samoloty_bez_procesu(const SharedData* d) {
+    return d->zadania_ile + d->przyloty_czekajace;
+}
+
+// Samoloty, które przyleciały, a jeszcze nie odleciały
+inline int samoloty_w_systemie(const SharedData* d) {
+    return d->aktywne_samoloty.load() + samoloty_bez_procesu(d);
+}
+
+#endif
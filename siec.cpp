@@ -0,0 +1,215 @@
+#include "siec.h"
+#include "symulacja.h"
+#include "zdarzenia.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+SiecLotnisk* siec = nullptr;
+
+// =============================================================
+// =======  REGION I SKRZYNKI  =================================
+// =============================================================
+
+static SkrzynkaLotow* skrzynka(SiecLotnisk* s, int dokad, int skad) {
+    SkrzynkaLotow* skrzynki = (SkrzynkaLotow*)((char*)s + s->off_skrzynki);
+    return &skrzynki[dokad * s->lotniska + skad];
+}
+
+SiecLotnisk* siec_utworz(int lotniska, int64_t czas_lotu_us, int udzial) {
+    size_t off = (sizeof(SiecLotnisk) + alignof(SkrzynkaLotow) - 1) & ~(alignof(SkrzynkaLotow) - 1);
+    size_t rozmiar = off + (size_t)lotniska * lotniska * sizeof(SkrzynkaLotow);
+    // Strony pierścieni dochodzą dopiero przy pierwszym zapisie
+    void* adres = mmap(nullptr, rozmiar, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (adres == MAP_FAILED) { perror("mmap"); return nullptr; }
+    SiecLotnisk* s = (SiecLotnisk*)adres;
+    s->lotniska = lotniska;
+    s->udzial = udzial;
+    s->okno_us = czas_lotu_us;
+    s->rozmiar = rozmiar;
+    s->przybyli.store(0, std::memory_order_relaxed);
+    s->pokolenie.store(0, std::memory_order_relaxed);
+    s->okna = 0;
+    s->off_skrzynki = off;
+    return s;
+}
+
+void siec_usun(SiecLotnisk* s) {
+    munmap(s, s->rozmiar);
+}
+
+int siec_cel(const SiecLotnisk* s, int skad, int kierunek) {
+    return (skad + 1 + kierunek % (s->lotniska - 1)) % s->lotniska;
+}
+
+static bool pozniej(const LotSieci& a, const LotSieci& b) {
+    if (a.przylot_us != b.przylot_us) return a.przylot_us > b.przylot_us;
+    if (a.skad != b.skad) return a.skad > b.skad;
+    return a.numer > b.numer;
+}
+
+void siec_odbierz(SiecLotnisk* s, int lotnisko, PrzylotySieci* przyloty) {
+    for (int skad = 0; skad < s->lotniska; skad++) {
+        SkrzynkaLotow* k = skrzynka(s, lotnisko, skad);
+        uint64_t odczytane = k->odczytane.load(std::memory_order_relaxed);
+        uint64_t zapisane = k->zapisane.load(std::memory_order_acquire);
+        if (odczytane == zapisane) continue;
+        for (; odczytane != zapisane; odczytane++) {
+            przyloty->kopiec.push_back(k->loty[odczytane % SIEC_POJEMNOSC_SKRZYNKI]);
+            std::push_heap(przyloty->kopiec.begin(), przyloty->kopiec.end(), pozniej);
+        }
+        k->odczytane.store(odczytane, std::memory_order_release);
+    }
+}
+
+void siec_wyslij(SiecLotnisk* s, int dokad, const LotSieci& lot, PrzylotySieci* przyloty) {
+    SkrzynkaLotow* k = skrzynka(s, dokad, lot.skad);
+    uint64_t zapisane = k->zapisane.load(std::memory_order_relaxed);
+    while (zapisane - k->odczytane.load(std::memory_order_acquire) == SIEC_POJEMNOSC_SKRZYNKI) {
+        // Odbiorca może stać w barierze albo sam czekać na naszą skrzynkę
+        siec_odbierz(s, lot.skad, przyloty);
+        syscall(SYS_futex, &s->pokolenie, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        sched_yield();
+    }
+    k->loty[zapisane % SIEC_POJEMNOSC_SKRZYNKI] = lot;
+    k->zapisane.store(zapisane + 1, std::memory_order_release);
+}
+
+void siec_bariera(SiecLotnisk* s, int lotnisko, PrzylotySieci* przyloty) {
+    uint32_t pokolenie = s->pokolenie.load(std::memory_order_acquire);
+    if (s->przybyli.fetch_add(1, std::memory_order_acq_rel) + 1 == (uint32_t)s->lotniska) {
+        s->przybyli.store(0, std::memory_order_relaxed);
+        s->okna++;
+        s->pokolenie.store(pokolenie + 1, std::memory_order_release);
+        syscall(SYS_futex, &s->pokolenie, FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    } else {
+        // Czekając odbieramy: nadawca z pełną skrzynką budzi nas przez pokolenie,
+        // limit czasu na wypadek budzenia przed zaśnięciem
+        struct timespec limit = { 0, 1000000 };
+        while (s->pokolenie.load(std::memory_order_acquire) == pokolenie) {
+            siec_odbierz(s, lotnisko, przyloty);
+            syscall(SYS_futex, &s->pokolenie, FUTEX_WAIT, pokolenie, &limit, nullptr, 0);
+        }
+    }
+    siec_odbierz(s, lotnisko, przyloty);
+}
+
+int64_t przyloty_najblizszy_us(const PrzylotySieci* p) {
+    return p->kopiec.empty() ? INT64_MAX : p->kopiec[0].przylot_us;
+}
+
+LotSieci przyloty_zdejmij(PrzylotySieci* p) {
+    std::pop_heap(p->kopiec.begin(), p->kopiec.end(), pozniej);
+    LotSieci lot = p->kopiec.back();
+    p->kopiec.pop_back();
+    return lot;
+}
+
+// =============================================================
+// =======  PRZEBIEG SIECI (procesy lotnisk)  ==================
+// =============================================================
+
+static void wypisz_raport_sieci(const OpcjeUruchomienia& opcje, const std::vector<WynikSymulacji>& wyniki,
+                                double czas_real_s) {
+    const WynikSymulacji& pierwszy = wyniki[0];
+    double godziny = pierwszy.czas_sym_s / 3600.0;
+    printf("============================================\n");
+    printf(" RAPORT SIECI: %d lotnisk, %s\n", opcje.lotniska, pierwszy.cfg.scenariusz_nazwa);
+    printf("============================================\n");
+    printf("Czas symulacji:        %.1f h (%.2f s rzeczywistych, x%.0f)\n", godziny, czas_real_s,
+           czas_real_s > 0 ? pierwszy.czas_sym_s / czas_real_s : 0.0);
+    printf("Lot w sieci:           %d s, w siec %d%% odlotow, %lld okien synchronizacji\n", opcje.czas_lotu_s,
+           opcje.udzial_sieci, siec->okna);
+    printf("%-9s %10s %10s %10s %10s %8s %10s %7s %7s %9s\n", "lotnisko", "przyloty", "z sieci", "odloty",
+           "w siec", "przekier", "obsluga s", "pasy", "bramki", "w locie");
+
+    long long przyloty = 0, z_sieci = 0, odloty = 0, w_siec = 0, przekierowane = 0, w_locie = 0;
+    double obsluga_suma = 0;
+    for (size_t a = 0; a < wyniki.size(); a++) {
+        const WynikSymulacji& w = wyniki[a];
+        printf("%-9zu %10lld %10lld %10lld %10lld %8lld %10.1f %6.1f%% %6.1f%% %9lld\n", a, w.przyloty,
+               w.przyloty_sieci, w.odloty, w.odloty_sieci, w.przekierowane, w.sredni_czas_obslugi_s,
+               100.0 * w.wykorzystanie_pasow, 100.0 * w.wykorzystanie_bramek, w.w_locie_sieci);
+        przyloty += w.przyloty;
+        z_sieci += w.przyloty_sieci;
+        odloty += w.odloty;
+        w_siec += w.odloty_sieci;
+        przekierowane += w.przekierowane;
+        w_locie += w.w_locie_sieci;
+        obsluga_suma += w.sredni_czas_obslugi_s * w.odloty;
+    }
+    printf("%-9s %10lld %10lld %10lld %10lld %8lld %10.1f %7s %7s %9lld\n", "razem", przyloty, z_sieci, odloty,
+           w_siec, przekierowane, odloty > 0 ? obsluga_suma / odloty : 0.0, "", "", w_locie);
+    // Bilans lotów: każdy wysłany w sieć albo wylądował, albo jest w drodze
+    printf("Bilans lotow sieci:    %s (wyslane %lld, przyjete %lld, w locie %lld)\n",
+           w_siec == z_sieci + w_locie ? "zgodny" : "NIEZGODNY", w_siec, z_sieci, w_locie);
+    printf("Przepustowosc:         %.0f odlotow / s rzeczywista\n", czas_real_s > 0 ? odloty / czas_real_s : 0.0);
+    fflush(stdout);
+}
+
+int siec_lotnisk(const OpcjeUruchomienia& opcje) {
+    unsigned ziarno_bazowe = opcje.ziarno_podane ? opcje.ziarno : (unsigned)time(NULL);
+    siec = siec_utworz(opcje.lotniska, opcje.czas_lotu_s * 1000000LL, opcje.udzial_sieci);
+    if (siec == nullptr) return 1;
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    // Lotnisko = przebieg jak w przeglądzie, z własnym ziarnem i prywatnym IPC
+    std::vector<pid_t> pidy(opcje.lotniska, -1);
+    std::vector<int> rury(opcje.lotniska, -1);
+    bool blad = false;
+    for (int a = 0; a < opcje.lotniska && !blad; a++) {
+        OpcjeUruchomienia o = opcje;
+        o.lotnisko = a;
+        o.plik_sladu.clear();
+        if (!o.plik_dziennika.empty()) o.plik_dziennika += "." + std::to_string(a);
+        o.nadpisania[PARAM_ENGINE] = SILNIK_ZDARZENIA;
+        o.ziarno_podane = true;
+        o.ziarno = ziarno_bazowe + a;
+        pidy[a] = uruchom_przebieg_w_tle(o, &rury[a]);
+        if (pidy[a] == -1) blad = true;
+    }
+    // Nieuruchomione lotnisko nie dojdzie do bariery - uruchomione by na nie
+    // czekały; pętla niżej je zbiera i zamyka ich rury
+    if (blad) {
+        for (int a = 0; a < opcje.lotniska; a++) if (pidy[a] != -1) kill(pidy[a], SIGKILL);
+    }
+
+    // Lotnisko bez wyniku zostawiłoby resztę w barierze
+    std::vector<WynikSymulacji> wyniki(opcje.lotniska);
+    int zostalo = 0;
+    for (int a = 0; a < opcje.lotniska; a++) if (pidy[a] != -1) zostalo++;
+    while (zostalo > 0) {
+        int status = 0;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid == -1) break;
+        int a = (int)(std::find(pidy.begin(), pidy.end(), pid) - pidy.begin());
+        if (a == opcje.lotniska) continue;
+        pidy[a] = -1;
+        zostalo--;
+        if (!odbierz_wynik(rury[a], wyniki[a]) && !blad) {
+            std::cerr << "Lotnisko " << a << " zakonczone bez wyniku" << std::endl;
+            blad = true;
+        }
+        if (blad) {
+            for (int b = 0; b < opcje.lotniska; b++) if (pidy[b] != -1) kill(pidy[b], SIGKILL);
+        }
+    }
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    if (!blad) wypisz_raport_sieci(opcje, wyniki, (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9);
+    siec_usun(siec);
+    siec = nullptr;
+    return blad ? 1 : 0;
+}
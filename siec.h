@@ -0,0 +1,81 @@
+#ifndef SIEC_H
+#define SIEC_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// =============================================================
+// =======  SIEĆ LOTNISK (--network=N)  ========================
+// =============================================================
+//
+// Każde lotnisko to osobny proces z własnym segmentem i silnikiem
+// zdarzeń (zdarzenia.h). Odlot w sieć to wpis w skrzynce lotniska
+// docelowego; skrzynka to pierścień SPSC na parę (skąd, dokąd), więc
+// nadawca i odbiorca nie dzielą żadnej blokady.
+//
+// Czas synchronizowany oknami: lot trwa okno_us, więc lot wysłany
+// w oknie [k*okno, (k+1)*okno) ląduje najwcześniej w następnym. Po
+// każdym oknie bariera - za nią każde lotnisko ma już wszystkie loty,
+// które mogą dotrzeć w kolejnym oknie, i liczy je bez czekania na resztę.
+
+#define SIEC_MAX_LOTNISK 32
+#define SIEC_POJEMNOSC_SKRZYNKI 1024        // Potęga dwójki
+
+struct LotSieci {
+    int64_t przylot_us;         // Czas przylotu do lotniska docelowego
+    uint32_t skad;
+    uint32_t numer;             // Kolejny lot z lotniska skad (remis czasu)
+};
+
+struct SkrzynkaLotow {
+    alignas(64) std::atomic<uint64_t> zapisane;     // Pisze tylko nadawca
+    alignas(64) std::atomic<uint64_t> odczytane;    // Pisze tylko odbiorca
+    LotSieci loty[SIEC_POJEMNOSC_SKRZYNKI];
+};
+
+// Region współdzielony przez procesy lotnisk (mmap przed fork)
+struct SiecLotnisk {
+    int lotniska;
+    int udzial;                 // % odlotów lecących w sieć (reszta opuszcza sieć)
+    int64_t okno_us;            // Czas lotu = długość okna synchronizacji
+    size_t rozmiar;
+
+    // Bariera okna: ostatni przybyły podbija pokolenie
+    alignas(64) std::atomic<uint32_t> przybyli;
+    alignas(64) std::atomic<uint32_t> pokolenie;
+    long long okna;             // Przejścia bariery (pisze ostatni przybyły)
+
+    size_t off_skrzynki;        // SkrzynkaLotow[lotniska * lotniska], [dokad][skad]
+};
+
+// Przyloty czekające na swój czas, kopiec po (przylot_us, skad, numer):
+// kolejność nie zależy od tego, kiedy lot wyjęto ze skrzynki
+struct PrzylotySieci {
+    std::vector<LotSieci> kopiec;
+};
+
+// Region sieci bieżącego przebiegu (dziedziczony przez procesy lotnisk)
+extern SiecLotnisk* siec;
+
+SiecLotnisk* siec_utworz(int lotniska, int64_t czas_lotu_us, int udzial);
+void siec_usun(SiecLotnisk* s);
+
+// Lotnisko docelowe odlotu w kierunku terminalu (nigdy to samo)
+int siec_cel(const SiecLotnisk* s, int skad, int kierunek);
+
+// Pełna skrzynka: nadawca opróżnia własną, dopóki odbiorca nie zrobi miejsca
+void siec_wyslij(SiecLotnisk* s, int dokad, const LotSieci& lot, PrzylotySieci* przyloty);
+
+// Przenosi loty ze wszystkich skrzynek lotniska do kopca przylotów
+void siec_odbierz(SiecLotnisk* s, int lotnisko, PrzylotySieci* przyloty);
+
+// Koniec okna; wraca, gdy wszystkie lotniska je skończyły (z odebranymi lotami)
+void siec_bariera(SiecLotnisk* s, int lotnisko, PrzylotySieci* przyloty);
+
+// Czas najbliższego przylotu; INT64_MAX = brak
+int64_t przyloty_najblizszy_us(const PrzylotySieci* p);
+LotSieci przyloty_zdejmij(PrzylotySieci* p);
+
+#endif
@@ -0,0 +1,97 @@
+#include "slad.h"
+
+const char* const NAZWY_ZDARZEN[LICZBA_TYPOW_ZDARZEN] = {
+    "przylot",
+    "ladowanie",
+    "wyladowal",
+    "bramka",
+    "cysterna",
+    "boarding",
+    "bramka zwolniona",
+    "start",
+    "odlot",
+    "dostawa paliwa",
+    "zjazd z pasa",
+    "przekierowany",
+    "brak paliwa",
+    "paliwo",
+};
+
+static BuforSladu* bufor = nullptr;
+static int moj_pierscien = 0;
+static int moj_pid = 0;          // getpid() to wywołanie systemowe - pamiętamy
+
+void slad_init(BuforSladu* b) {
+    b->koniec.store(0);
+    for (int r = 0; r < SLAD_PIERSCIENIE; r++) {
+        PierscienSladu& p = b->pierscienie[r];
+        p.zapis.store(0);
+        p.odczyt.store(0);
+        p.utracone.store(0);
+        for (uint64_t i = 0; i < SLAD_POJEMNOSC; i++) p.komorki[i].numer.store(i, std::memory_order_relaxed);
+    }
+}
+
+void slad_podlacz(BuforSladu* b) {
+    bufor = b;
+}
+
+void slad_wybierz_pierscien(int pid) {
+    moj_pid = pid;
+    moj_pierscien = pid % SLAD_PIERSCIENIE;
+}
+
+// Ograniczona kolejka wielu piszących (numer komórki mówi, czyja kolej)
+void slad_zapisz(int64_t t_us, int typ, int samolot, int zasob, int wartosc) {
+    if (bufor == nullptr) return;
+    PierscienSladu& p = bufor->pierscienie[moj_pierscien];
+
+    uint64_t poz = p.zapis.load(std::memory_order_relaxed);
+    while (true) {
+        KomorkaSladu& k = p.komorki[poz & (SLAD_POJEMNOSC - 1)];
+        uint64_t numer = k.numer.load(std::memory_order_acquire);
+        if (numer == poz) {
+            if (p.zapis.compare_exchange_weak(poz, poz + 1, std::memory_order_relaxed)) {
+                k.z.t_us = t_us;
+                k.z.samolot = samolot;
+                k.z.typ = (int16_t)typ;
+                k.z.zasob = (int16_t)zasob;
+                k.z.wartosc = wartosc;
+                k.z.pid = moj_pid;
+                k.numer.store(poz + 1, std::memory_order_release);
+                return;
+            }
+        } else if (numer < poz) {
+            // Komórka sprzed okrążenia nie została odczytana - pierścień pełny
+            p.utracone.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            poz = p.zapis.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+long slad_oproznij(FILE* plik) {
+    long ile = 0;
+    for (int r = 0; r < SLAD_PIERSCIENIE; r++) {
+        PierscienSladu& p = bufor->pierscienie[r];
+        uint64_t poz = p.odczyt.load(std::memory_order_relaxed);
+        while (true) {
+            KomorkaSladu& k = p.komorki[poz & (SLAD_POJEMNOSC - 1)];
+            if (k.numer.load(std::memory_order_acquire) != poz + 1) break;
+            ZdarzenieSladu z = k.z;
+            k.numer.store(poz + SLAD_POJEMNOSC, std::memory_order_release);
+            fwrite(&z, sizeof(z), 1, plik);
+            poz++;
+            ile++;
+        }
+        p.odczyt.store(poz, std::memory_order_relaxed);
+    }
+    return ile;
+}
+
+long long slad_utracone() {
+    long long suma = 0;
+    for (int r = 0; r < SLAD_PIERSCIENIE; r++) suma += bufor->pierscienie[r].utracone.load();
+    return suma;
+}
@@ -0,0 +1,94 @@
+#ifndef SLAD_H
+#define SLAD_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+
+// =============================================================
+// =======  ŚLAD ZDARZEŃ (--trace=PLIK)  =======================
+// =============================================================
+//
+// Każde przejście samolotu między fazami (i każda dostawa paliwa) to
+// jeden 24-bajtowy rekord z czasem symulacji. Procesy piszą do
+// pierścieni w pamięci współdzielonej (pierścień wybierany po pid,
+// jak szardy histogramów) - rezerwacja komórki to jeden CAS, bez
+// blokad i wywołań systemowych. Osobny proces zapisu opróżnia
+// pierścienie do pliku binarnego; slad_json zamienia go na format
+// Chrome trace (chrome://tracing, ui.perfetto.dev).
+//
+// Pełny pierścień nie blokuje symulacji: zdarzenie jest liczone
+// jako utracone.
+
+#define SLAD_PIERSCIENIE 32
+#define SLAD_POJEMNOSC 8192          // Potęga dwójki
+#define SLAD_MAGIA "SO2SLAD"
+#define SLAD_WERSJA 1
+
+enum TypZdarzenia {
+    ZD_PRZYLOT = 0,          // Samolot w systemie, czeka na pas
+    ZD_LADOWANIE,            // Pas wzięty do lądowania       (zasob = pas)
+    ZD_WYLADOWAL,            // Koniec lądowania, czeka na bramkę na pasie (zasob = pas)
+    ZD_BRAMKA,               // Bramka wzięta                 (zasob = bramka, wartosc = zwolniony pas lub -1)
+    ZD_CYSTERNA,             // Cysterna wzięta               (zasob = cysterna)
+    ZD_BOARDING,             // Koniec tankowania, cysterna zwolniona
+    ZD_BRAMKA_ZWOLNIONA,     // Koniec boardingu              (zasob = bramka, wartosc = pasażerowie)
+    ZD_START,                // Pas wzięty do startu          (zasob = pas)
+    ZD_ODLOT,                // Pas zwolniony, samolot poza systemem (zasob = pas, wartosc = pasażerowie)
+    ZD_DOSTAWA_PALIWA,       // Dostawa do magazynu           (wartosc = stan magazynu)
+    ZD_ZJAZD_Z_PASA,         // Pas zwolniony, samolot na drodze kołowania (zasob = pas)
+    ZD_PRZEKIEROWANY,        // Za długie krążenie - lot na zapasowe
+    ZD_BRAK_PALIWA,          // Pusty magazyn, czeka z cysterną na dostawę (zasob = cysterna)
+    ZD_PALIWO,               // Paliwo przydzielone po dostawie (zasob = cysterna)
+    LICZBA_TYPOW_ZDARZEN
+};
+
+struct ZdarzenieSladu {
+    int64_t t_us;            // Czas symulacji (zegar_teraz_us)
+    int32_t samolot;
+    int16_t typ;
+    int16_t zasob;           // Indeks pasa/bramki/cysterny, -1 gdy brak
+    int32_t wartosc;
+    int32_t pid;
+};
+
+struct KomorkaSladu {
+    std::atomic<uint64_t> numer;     // == pozycja: wolna, == pozycja+1: zapisana
+    ZdarzenieSladu z;
+};
+
+struct alignas(64) PierscienSladu {
+    std::atomic<uint64_t> zapis;                    // Następna pozycja dla piszących
+    alignas(64) std::atomic<uint64_t> odczyt;       // Tylko proces zapisu
+    std::atomic<uint64_t> utracone;
+    KomorkaSladu komorki[SLAD_POJEMNOSC];
+};
+
+struct BuforSladu {
+    std::atomic<int> koniec;                        // Nadzorca: dopisz resztę i zakończ
+    PierscienSladu pierscienie[SLAD_PIERSCIENIE];
+};
+
+// Nagłówek pliku; za nim same rekordy ZdarzenieSladu
+struct NaglowekSladu {
+    char magia[8];
+    uint32_t wersja;
+    uint32_t rozmiar_zdarzenia;
+    int32_t tryb_zegara;
+    uint32_t ziarno;
+    char scenariusz[52];
+};
+
+extern const char* const NAZWY_ZDARZEN[LICZBA_TYPOW_ZDARZEN];
+
+void slad_init(BuforSladu* b);
+void slad_podlacz(BuforSladu* b);             // nullptr = śledzenie wyłączone
+void slad_wybierz_pierscien(int pid);         // Po fork(): getpid()
+
+void slad_zapisz(int64_t t_us, int typ, int samolot, int zasob, int wartosc);
+
+// Proces zapisu: przepisuje gotowe rekordy do pliku, zwraca ich liczbę
+long slad_oproznij(FILE* plik);
+long long slad_utracone();
+
+#endif
@@ -0,0 +1,164 @@
+#include "slad.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+// =============================================================
+// =======  KONWERSJA ŚLADU DO FORMATU CHROME TRACE  ===========
+// =============================================================
+//
+// Użycie: slad_json PLIK_SLADU > trace.json
+// Wynik otwiera chrome://tracing albo ui.perfetto.dev:
+//  - proces "Samoloty": wątek na samolot, odcinek na fazę obsługi,
+//  - procesy "Pasy", "Bramki", "Cysterny": wątek na zasób, odcinek
+//    na każde zajęcie,
+//  - proces "Paliwo": licznik stanu magazynu po dostawach.
+
+enum ProcesJson {
+    PJ_SAMOLOTY = 1,
+    PJ_PASY,
+    PJ_BRAMKI,
+    PJ_CYSTERNY,
+    PJ_PALIWO
+};
+
+// Faza, która zaczyna się danym zdarzeniem (nullptr = samolot opuszcza system)
+static const char* const FAZA_PO[LICZBA_TYPOW_ZDARZEN] = {
+    "czeka na pas",        // ZD_PRZYLOT
+    "ladowanie",           // ZD_LADOWANIE
+    "czeka na bramke",     // ZD_WYLADOWAL
+    "czeka na cysterne",   // ZD_BRAMKA
+    "tankowanie",          // ZD_CYSTERNA
+    "boarding",            // ZD_BOARDING
+    "czeka na pas (start)",// ZD_BRAMKA_ZWOLNIONA
+    "start",               // ZD_START
+    nullptr,               // ZD_ODLOT
+    nullptr,               // ZD_DOSTAWA_PALIWA
+    "kolowanie (czeka na bramke)", // ZD_ZJAZD_Z_PASA
+    nullptr,               // ZD_PRZEKIEROWANY
+    "czeka na paliwo",     // ZD_BRAK_PALIWA
+    "tankowanie",          // ZD_PALIWO
+};
+
+struct OtwartyOdcinek {
+    int64_t od_us;
+    const char* nazwa;
+};
+
+static bool pierwszy = true;
+
+static void przecinek() {
+    if (!pierwszy) printf(",\n");
+    pierwszy = false;
+}
+
+static void odcinek(int pid, int tid, const char* nazwa, int64_t od_us, int64_t do_us) {
+    przecinek();
+    printf("{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%d,\"tid\":%d,\"ts\":%lld,\"dur\":%lld}",
+           nazwa, pid, tid, (long long)od_us, (long long)(do_us - od_us));
+}
+
+static void nazwa_procesu(int pid, const char* nazwa) {
+    przecinek();
+    printf("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,\"args\":{\"name\":\"%s\"}}", pid, nazwa);
+}
+
+// Zajęcie zasobu: odcinek "ID n" na wątku zasobu
+static void zajmij(std::map<int, std::pair<int64_t, int>>& zasoby, int zasob, int64_t t, int samolot) {
+    if (zasob >= 0) zasoby[zasob] = std::make_pair(t, samolot);
+}
+
+static void zwolnij(std::map<int, std::pair<int64_t, int>>& zasoby, int pid, int zasob, int64_t t) {
+    auto it = zasoby.find(zasob);
+    if (it == zasoby.end()) return;
+    char nazwa[24];
+    snprintf(nazwa, sizeof(nazwa), "ID %d", it->second.second);
+    odcinek(pid, zasob + 1, nazwa, it->second.first, t);
+    zasoby.erase(it);
+}
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        fprintf(stderr, "Uzycie: %s PLIK_SLADU > trace.json\n", argv[0]);
+        return 1;
+    }
+    FILE* f = fopen(argv[1], "rb");
+    if (f == nullptr) { perror(argv[1]); return 1; }
+
+    NaglowekSladu n;
+    if (fread(&n, sizeof(n), 1, f) != 1 || memcmp(n.magia, SLAD_MAGIA, sizeof(SLAD_MAGIA)) != 0 ||
+        n.wersja != SLAD_WERSJA || n.rozmiar_zdarzenia != sizeof(ZdarzenieSladu)) {
+        fprintf(stderr, "%s: to nie jest plik sladu w wersji %d\n", argv[1], SLAD_WERSJA);
+        fclose(f);
+        return 1;
+    }
+
+    std::vector<ZdarzenieSladu> zdarzenia;
+    ZdarzenieSladu z;
+    while (fread(&z, sizeof(z), 1, f) == 1) {
+        if (z.typ >= 0 && z.typ < LICZBA_TYPOW_ZDARZEN) zdarzenia.push_back(z);
+    }
+    fclose(f);
+
+    // Pierścienie opróżniane są po kolei - porządek tylko w obrębie jednego
+    std::stable_sort(zdarzenia.begin(), zdarzenia.end(),
+                     [](const ZdarzenieSladu& a, const ZdarzenieSladu& b) { return a.t_us < b.t_us; });
+
+    printf("{\"otherData\":{\"scenariusz\":\"%s\",\"ziarno\":%u},\n\"traceEvents\":[\n", n.scenariusz, n.ziarno);
+    nazwa_procesu(PJ_SAMOLOTY, "Samoloty");
+    nazwa_procesu(PJ_PASY, "Pasy");
+    nazwa_procesu(PJ_BRAMKI, "Bramki");
+    nazwa_procesu(PJ_CYSTERNY, "Cysterny");
+    nazwa_procesu(PJ_PALIWO, "Paliwo");
+
+    std::map<int, OtwartyOdcinek> samoloty;
+    std::map<int, std::pair<int64_t, int>> pasy, bramki, cysterny;
+
+    for (const ZdarzenieSladu& e : zdarzenia) {
+        if (e.typ == ZD_DOSTAWA_PALIWA) {
+            przecinek();
+            printf("{\"name\":\"magazyn\",\"ph\":\"C\",\"pid\":%d,\"ts\":%lld,\"args\":{\"litry\":%d}}",
+                   PJ_PALIWO, (long long)e.t_us, e.wartosc);
+            continue;
+        }
+
+        // Faza samolotu: zamknięcie poprzedniej, otwarcie następnej
+        auto it = samoloty.find(e.samolot);
+        if (it != samoloty.end()) {
+            odcinek(PJ_SAMOLOTY, e.samolot, it->second.nazwa, it->second.od_us, e.t_us);
+            samoloty.erase(it);
+        }
+        if (FAZA_PO[e.typ] != nullptr) samoloty[e.samolot] = { e.t_us, FAZA_PO[e.typ] };
+
+        switch (e.typ) {
+            case ZD_LADOWANIE:
+            case ZD_START:
+                zajmij(pasy, e.zasob, e.t_us, e.samolot);
+                break;
+            case ZD_BRAMKA:
+                zwolnij(pasy, PJ_PASY, e.wartosc, e.t_us);
+                zajmij(bramki, e.zasob, e.t_us, e.samolot);
+                break;
+            case ZD_CYSTERNA:
+                zajmij(cysterny, e.zasob, e.t_us, e.samolot);
+                break;
+            case ZD_BOARDING:
+                zwolnij(cysterny, PJ_CYSTERNY, e.zasob, e.t_us);
+                break;
+            case ZD_BRAMKA_ZWOLNIONA:
+                zwolnij(bramki, PJ_BRAMKI, e.zasob, e.t_us);
+                break;
+            case ZD_ODLOT:
+            case ZD_ZJAZD_Z_PASA:
+                zwolnij(pasy, PJ_PASY, e.zasob, e.t_us);
+                break;
+        }
+    }
+    printf("\n]}\n");
+
+    fprintf(stderr, "%zu zdarzen, %zu samolotow w trakcie obslugi na koniec\n", zdarzenia.size(), samoloty.size());
+    return 0;
+}
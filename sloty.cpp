@@ -0,0 +1,63 @@
+#include "sloty.h"
+
+void sloty_init(PulaSlotow* p, int rozmiar) {
+    sloty_init_zakres(p, rozmiar, 0, rozmiar);
+}
+
+// Bity [0, n) słowa w
+static uint64_t maska_ponizej(int n, int w) {
+    int bity = n - w * 64;
+    if (bity >= 64) return ~0ULL;
+    if (bity > 0) return (1ULL << bity) - 1;
+    return 0;
+}
+
+void sloty_init_zakres(PulaSlotow* p, int rozmiar, int od, int do_) {
+    if (rozmiar > SLOTY_MAX) rozmiar = SLOTY_MAX;
+    if (do_ > rozmiar) do_ = rozmiar;
+    p->rozmiar = rozmiar;
+    for (int w = 0; w < SLOTY_MAX_SLOW; w++) {
+        p->wolne[w].store(maska_ponizej(do_, w) & ~maska_ponizej(od, w));
+    }
+}
+
+int sloty_zajmij(PulaSlotow* p, int start) {
+    int slowa = (p->rozmiar + 63) / 64;
+    if (slowa == 0) return -1;
+    if (start < 0) start = 0;
+    start %= p->rozmiar;
+
+    // Pierwsze słowo przeglądamy od bitu start, potem pozostałe słowa w kółko
+    for (int k = 0; k <= slowa; k++) {
+        int w = (start / 64 + k) % slowa;
+        uint64_t maska_od = (k == 0) ? (~0ULL << (start % 64)) : ~0ULL;
+        uint64_t bity = p->wolne[w].load(std::memory_order_relaxed);
+
+        while (bity & maska_od) {
+            int b = __builtin_ctzll(bity & maska_od);
+            uint64_t bit = 1ULL << b;
+            uint64_t poprzednie = p->wolne[w].fetch_and(~bit, std::memory_order_acquire);
+            if (poprzednie & bit) return w * 64 + b;
+            bity = poprzednie & ~bit;       // Ktoś był szybszy - kolejny bit
+        }
+    }
+    return -1;
+}
+
+void sloty_zwolnij(PulaSlotow* p, int idx) {
+    if (idx < 0) return;
+    p->wolne[idx / 64].fetch_or(1ULL << (idx % 64), std::memory_order_release);
+}
+
+int sloty_zajmij_ostatni(PulaSlotow* p) {
+    for (int w = (p->rozmiar + 63) / 64 - 1; w >= 0; w--) {
+        uint64_t bity = p->wolne[w].load(std::memory_order_relaxed);
+        while (bity != 0) {
+            uint64_t bit = 1ULL << (63 - __builtin_clzll(bity));
+            uint64_t poprzednie = p->wolne[w].fetch_and(~bit, std::memory_order_acquire);
+            if (poprzednie & bit) return w * 64 + 63 - __builtin_clzll(bit);
+            bity = poprzednie & ~bit;
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,37 @@
+#ifndef SLOTY_H
+#define SLOTY_H
+
+#include <atomic>
+#include <cstdint>
+
+// =============================================================
+// =======  PULA SLOTÓW (bramki, cysterny)  ====================
+// =============================================================
+//
+// Bitmapa wolnych slotów w pamięci współdzielonej: bit 1 = wolny.
+// Zajęcie to jedno fetch_and na słowie z wolnym bitem, zwolnienie
+// to fetch_or. Czekanie na wolny slot zapewnia semafor zasobu
+// (SEM_GATE / SEM_CYSTERNA), więc po sem_p wolny bit
+// zawsze istnieje.
+
+#define SLOTY_MAX_SLOW 16                   // 16 * 64 = 1024 sloty
+#define SLOTY_MAX (SLOTY_MAX_SLOW * 64)
+
+struct PulaSlotow {
+    int rozmiar;
+    std::atomic<uint64_t> wolne[SLOTY_MAX_SLOW];
+};
+
+void sloty_init(PulaSlotow* p, int rozmiar);
+// Pula rozmiar slotów, wolne tylko [od, do_) - reszta zamknięta na starcie
+void sloty_init_zakres(PulaSlotow* p, int rozmiar, int od, int do_);
+
+// Zajmuje wolny slot, szukając od pozycji start (rozrzut po pasach/bramkach).
+// Wywoływać po sem_p zasobu; zwraca -1 tylko przy złamaniu tej zasady.
+int sloty_zajmij(PulaSlotow* p, int start);
+void sloty_zwolnij(PulaSlotow* p, int idx);
+
+// Wolny slot o najwyższym numerze (zamykanie przy zmianie pojemności), -1 = brak
+int sloty_zajmij_ostatni(PulaSlotow* p);
+
+#endif
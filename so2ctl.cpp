@@ -0,0 +1,141 @@
+#include "segment.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <vector>
+#include <unistd.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+// =============================================================
+// =======  SO2CTL: ZMIANY W DZIAŁAJĄCEJ SYMULACJI  ============
+// =============================================================
+//
+// Użycie: so2ctl [--shmid=N] [--timeout-ms=N] PARAM=WARTOSC...
+//
+// Wpisuje polecenia do skrzynki w segmencie (sterowanie.h) i czeka na
+// odpowiedź nadzorcy, który wykonuje je w swoim takcie, np.
+//
+//   so2ctl runways=1              zamknięcie pasa (AWARIA PASA)
+//   so2ctl gates=8 spawn-rate=10  więcej bramek i gęstszy ruch
+//
+// Nazwy jak w linii poleceń SO2; zmieniać można parametry zmienialne
+// w biegu, pasy/bramki/cysterny do liczby zainstalowanych (--max-*).
+// Zajęte zasoby zamykają się po zwolnieniu, więc żaden samolot nie
+// traci pasa ani bramki w trakcie obsługi. Kod wyjścia 1, gdy któreś
+// polecenie odrzucono albo nie doczekało się odpowiedzi.
+
+static SharedData* d = nullptr;
+
+static bool uklad_gotowy(size_t rozmiar) {
+    return rozmiar >= sizeof(SharedData) &&
+           d->off_pasy == ((sizeof(SharedData) + 63) & ~(size_t)63) &&
+           d->rozmiar_segmentu == rozmiar;
+}
+
+static bool podlacz(int id) {
+    if (id == -1) id = shmget(SHM_KEY, 0, 0);
+    if (id == -1) { perror("shmget (czy symulacja dziala?)"); return false; }
+    void* adres = shmat(id, nullptr, 0);
+    if (adres == (void*)-1) { perror("shmat"); return false; }
+    d = (SharedData*)adres;
+    struct shmid_ds ds;
+    if (shmctl(id, IPC_STAT, &ds) == -1) { perror("shmctl"); return false; }
+    if (!uklad_gotowy(ds.shm_segsz)) {
+        fprintf(stderr, "Segment %d nie ma ukladu tej wersji SO2 (przebuduj so2ctl razem z SO2)\n", id);
+        return false;
+    }
+    return true;
+}
+
+// Wolne miejsce w skrzynce, od razu zarezerwowane; -1 = skrzynka pełna
+static int zajmij_polecenie() {
+    for (int i = 0; i < STEROWANIE_MAX_POLECEN; i++) {
+        int wolne = POL_WOLNE;
+        if (d->sterowanie.polecenia[i].stan.compare_exchange_strong(wolne, POL_ZAPISYWANE)) return i;
+    }
+    return -1;
+}
+
+static int64_t teraz_ms() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec * 1000LL + t.tv_nsec / 1000000;
+}
+
+static void wypisz_pomoc(const char* nazwa) {
+    fprintf(stderr,
+            "Uzycie: %s [opcje] PARAM=WARTOSC...\n"
+            "  --shmid=N         segment o danym id (domyslnie klucz SHM_KEY)\n"
+            "  --timeout-ms=N    ile czekac na wykonanie (domyslnie 5000)\n"
+            "  PARAM=WARTOSC     np. runways=1, gates=8, spawn-rate=10 (nazwy jak SO2 --PARAM)\n",
+            nazwa);
+}
+
+int main(int argc, char** argv) {
+    int id = -1;
+    int limit_ms = 5000;
+    std::vector<const char*> polecenia;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (strncmp(a, "--shmid=", 8) == 0) id = atoi(a + 8);
+        else if (strncmp(a, "--timeout-ms=", 13) == 0) limit_ms = atoi(a + 13);
+        else if (a[0] != '-' && strchr(a, '=') != nullptr) polecenia.push_back(a);
+        else { wypisz_pomoc(argv[0]); return 1; }
+    }
+    if (polecenia.empty() || limit_ms < 1) { wypisz_pomoc(argv[0]); return 1; }
+    if (!podlacz(id)) return 1;
+
+    // Wszystkie naraz: nadzorca wykona je w jednym takcie, w kolejności miejsc
+    std::vector<int> miejsca;
+    bool ok = true;
+    for (const char* p : polecenia) {
+        const char* rowna = strchr(p, '=');
+        size_t dlugosc = rowna - p;
+        char* koniec;
+        long wartosc = strtol(rowna + 1, &koniec, 10);
+        if (dlugosc == 0 || dlugosc >= sizeof(PolecenieSterujace::parametr) || koniec == rowna + 1 || *koniec != '\0') {
+            fprintf(stderr, "Niepoprawne polecenie: %s\n", p);
+            ok = false;
+            continue;
+        }
+        int i = zajmij_polecenie();
+        if (i == -1) { fprintf(stderr, "Skrzynka polecen pelna, pominieto: %s\n", p); ok = false; continue; }
+        PolecenieSterujace& pol = d->sterowanie.polecenia[i];
+        memset(pol.parametr, 0, sizeof(pol.parametr));
+        memcpy(pol.parametr, p, dlugosc);
+        pol.wartosc = (int)wartosc;
+        pol.odpowiedz[0] = '\0';
+        pol.stan.store(POL_CZEKA, std::memory_order_release);
+        miejsca.push_back(i);
+    }
+
+    int64_t termin = teraz_ms() + limit_ms;
+    for (int i : miejsca) {
+        PolecenieSterujace& pol = d->sterowanie.polecenia[i];
+        int stan;
+        while ((stan = pol.stan.load(std::memory_order_acquire)) == POL_CZEKA || stan == POL_WYKONYWANE) {
+            if (teraz_ms() >= termin) {
+                // Wycofanie; nie wyszło = nadzorca właśnie je wziął
+                int czeka = POL_CZEKA;
+                if (pol.stan.compare_exchange_strong(czeka, POL_WOLNE)) break;
+            }
+            usleep(10000);
+        }
+        if (stan == POL_WYKONANE) {
+            printf("%s=%d: wykonano w %.1f s symulacji\n", pol.parametr, pol.wartosc, pol.czas_us / 1e6);
+        } else if (stan == POL_ODRZUCONE) {
+            printf("%s=%d: odrzucono (%s)\n", pol.parametr, pol.wartosc, pol.odpowiedz);
+            ok = false;
+        } else {
+            printf("%s=%d: brak odpowiedzi (czy symulacja jest wstrzymana?)\n", pol.parametr, pol.wartosc);
+            ok = false;
+            continue;   // Wycofane polecenie jest już WOLNE
+        }
+        pol.stan.store(POL_WOLNE, std::memory_order_release);
+    }
+    shmdt(d);
+    return ok ? 0 : 1;
+}
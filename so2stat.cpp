@@ -0,0 +1,357 @@
+#include "segment.h"
+
+#include <cerrno>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <poll.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// =============================================================
+// =======  SO2STAT: STAN DZIAŁAJĄCEJ SYMULACJI Z ZEWNĄTRZ  ====
+// =============================================================
+//
+// Użycie: so2stat [--shmid=N] [--interval-ms=N] [--out=PLIK] [--socket=ŚCIEŻKA] [--once]
+//
+// Podłącza segment SHM_KEY (albo --shmid, np. z ipcs) tylko do odczytu
+// i co --interval-ms wypisuje migawkę w formacie tekstowym Prometheusa:
+// zajętość pasów/bramek/cystern, paliwo, samoloty w systemie, kolejki
+// w terminalu, liczniki skumulowane i podsumowania histogramów.
+//
+//   --out=PLIK      migawka zapisywana do PLIK.tmp i podmieniana rename()
+//                   (np. katalog textfile node_exportera)
+//   --socket=PATH   gniazdo uniksowe: każde połączenie dostaje bieżącą
+//                   migawkę; żądanie "GET ..." dostaje odpowiedź HTTP
+//                   (curl --unix-socket PATH http://x/metrics)
+//   bez --out/--socket migawki idą na stdout
+//
+// so2stat nie bierze blokad ani semaforów symulacji i nie pisze do
+// segmentu (SHM_RDONLY), więc nie zmienia przebiegu. Rekordy czytane
+// bez blokad, jak robi to wątek ekranu. Kończy się, gdy symulacja
+// usunie segment.
+
+#define SO2STAT_PROBY_PODLACZENIA 50   // Co 100 ms, zanim symulacja wypełni segment
+
+static const SharedData* d = nullptr;
+static int shmid = -1;
+static volatile sig_atomic_t koniec = 0;
+
+static void na_sygnal(int) {
+    koniec = 1;
+}
+
+static bool uklad_gotowy(size_t rozmiar) {
+    return rozmiar >= sizeof(SharedData) &&
+           d->off_pasy == ((sizeof(SharedData) + 63) & ~(size_t)63) &&
+           d->rozmiar_segmentu == rozmiar;
+}
+
+static bool podlacz(int id) {
+    if (id == -1) id = shmget(SHM_KEY, 0, 0);
+    if (id == -1) { perror("shmget (czy symulacja dziala?)"); return false; }
+    void* adres = shmat(id, nullptr, SHM_RDONLY);
+    if (adres == (void*)-1) { perror("shmat"); return false; }
+    shmid = id;
+    d = (const SharedData*)adres;
+
+    struct shmid_ds ds;
+    if (shmctl(shmid, IPC_STAT, &ds) == -1) { perror("shmctl"); return false; }
+    for (int i = 0; i < SO2STAT_PROBY_PODLACZENIA && !uklad_gotowy(ds.shm_segsz); i++) usleep(100000);
+    if (!uklad_gotowy(ds.shm_segsz)) {
+        fprintf(stderr, "Segment %d nie ma ukladu tej wersji SO2 (przebuduj so2stat razem z SO2)\n", shmid);
+        return false;
+    }
+    zegar_podlacz(const_cast<ZegarWirtualny*>(&d->zegar));
+    hist_podlacz(const_cast<TabelaHistogramow*>(&d->histogramy));
+    return true;
+}
+
+// Segment usunięty przez symulację (IPC_RMID) albo już nie istnieje
+static bool segment_usuniety() {
+    struct shmid_ds ds;
+    if (shmctl(shmid, IPC_STAT, &ds) == -1) return true;
+    return (ds.shm_perm.mode & SHM_DEST) != 0;
+}
+
+// =============================================================
+// =======  MIGAWKA (format tekstowy Prometheusa)  =============
+// =============================================================
+
+static void dopisz(std::string& s, const char* format, ...) __attribute__((format(printf, 2, 3)));
+static void dopisz(std::string& s, const char* format, ...) {
+    char bufor[512];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(bufor, sizeof(bufor), format, args);
+    va_end(args);
+    if (n > 0) s.append(bufor, (size_t)n < sizeof(bufor) ? n : sizeof(bufor) - 1);
+}
+
+static void metryka(std::string& s, const char* nazwa, const char* typ, const char* opis, double wartosc) {
+    dopisz(s, "# HELP %s %s\n# TYPE %s %s\n%s %.15g\n", nazwa, opis, nazwa, typ, nazwa, wartosc);
+}
+
+// Wartość etykiety: \ i " poprzedzone \ (nazwy scenariuszy, metryk)
+static std::string etykieta(const char* tekst) {
+    std::string e;
+    for (const char* c = tekst; *c != '\0'; c++) {
+        if (*c == '\\' || *c == '"') e += '\\';
+        if (*c == '\n') { e += "\\n"; continue; }
+        e += *c;
+    }
+    return e;
+}
+
+static int zajete_bramki() {
+    const RekordBramki* bramki = rekordy_segmentu<RekordBramki>(d, d->off_bramki);
+    int zajete = 0;
+    for (int i = 0; i < d->cfg_max_bramek; i++) {
+        int samolot;
+        uint32_t s;
+        do {
+            s = sekwencja_odczyt_poczatek(&bramki[i].sekwencja);
+            samolot = bramki[i].samolot;
+        } while (!sekwencja_odczyt_ok(&bramki[i].sekwencja, s));
+        if (samolot > 0) zajete++;             // -1 = zamknięta
+    }
+    return zajete;
+}
+
+static std::string migawka() {
+    std::string s;
+    s.reserve(16384);
+
+    dopisz(s, "# HELP so2_info Przebieg podlaczonej symulacji\n# TYPE so2_info gauge\n");
+    dopisz(s, "so2_info{scenario=\"%s\",seed=\"%u\",pool=\"%d\",clock=\"%d\"} 1\n",
+           etykieta(d->scenariusz_nazwa).c_str(), d->ziarno, d->cfg_pula, d->zegar.tryb);
+    metryka(s, "so2_sim_time_seconds", "gauge", "Czas symulacji", zegar_teraz_us() / 1e6);
+
+    // --- ZAJĘTOŚĆ ZASOBÓW ---
+    const RekordPasa* pasy = rekordy_segmentu<RekordPasa>(d, d->off_pasy);
+    const RekordCysterny* cysterny = rekordy_segmentu<RekordCysterny>(d, d->off_cysterny);
+    int pasy_zajete = 0;
+    int cysterny_zajete = 0;
+    // Rekordy są na wszystkie zainstalowane (cfg_max_*); zamknięta cysterna ma -1
+    for (int i = 0; i < d->cfg_max_pasow; i++) pasy_zajete += pasy[i].samolot.load(std::memory_order_relaxed) != 0;
+    for (int i = 0; i < d->cfg_max_cystern; i++) cysterny_zajete += cysterny[i].samolot.load(std::memory_order_relaxed) > 0;
+    metryka(s, "so2_runways", "gauge", "Aktywne pasy", d->cfg_runways);
+    metryka(s, "so2_runways_busy", "gauge", "Zajete pasy", pasy_zajete);
+    metryka(s, "so2_gates", "gauge", "Bramki", d->cfg_gates);
+    metryka(s, "so2_gates_busy", "gauge", "Zajete bramki", zajete_bramki());
+    metryka(s, "so2_tankers", "gauge", "Cysterny", d->cfg_tankers);
+    metryka(s, "so2_tankers_busy", "gauge", "Zajete cysterny", cysterny_zajete);
+    metryka(s, "so2_capacity_changes_total", "counter", "Zmiany w biegu (plik scenariusza, so2ctl)", d->stat_zmiany);
+
+    // --- PALIWO ---
+    metryka(s, "so2_fuel_liters", "gauge", "Paliwo w magazynie (po rezerwacjach)",
+            d->magazyn.stan.load(std::memory_order_relaxed));
+    metryka(s, "so2_fuel_capacity_liters", "gauge", "Pojemnosc magazynu", d->magazyn.pojemnosc);
+    metryka(s, "so2_fuel_waiting", "gauge", "Tankowania czekajace na dostawe", d->magazyn.czekajacy);
+
+    // --- SAMOLOTY I KOLEJKI ---
+    metryka(s, "so2_planes_active", "gauge", "Samoloty w systemie (z czekajacymi na proces)", samoloty_w_systemie(d));
+    metryka(s, "so2_planes_queued", "gauge", "Czekajace na proces obslugi (kolejka puli, brak wpisu rejestru)",
+            samoloty_bez_procesu(d));
+    metryka(s, "so2_planes_airborne", "gauge", "Krazace przed zgoda na ladowanie", d->w_powietrzu.load());
+    metryka(s, "so2_planes_taxiing", "gauge", "Na drodze kolowania", d->na_kolowaniu.load());
+    metryka(s, "so2_queue_runway", "gauge", "Czekajace na pas", d->czeka_na_pas.load());
+    metryka(s, "so2_queue_gate", "gauge", "Czekajace na bramke", d->czeka_na_bramke.load());
+    metryka(s, "so2_queue_tanker", "gauge", "Czekajace na cysterne", d->czeka_na_cysterne.load());
+
+    const KierunekTerminalu* kierunki = rekordy_segmentu<KierunekTerminalu>(d, d->off_kierunki);
+    dopisz(s, "# HELP so2_terminal_passengers Pasazerowie czekajacy w terminalu\n"
+              "# TYPE so2_terminal_passengers gauge\n");
+    for (int i = 0; i < d->cfg_kierunki; i++) {
+        dopisz(s, "so2_terminal_passengers{direction=\"%s\"} %d\n", etykieta(kierunki[i].nazwa).c_str(),
+               kierunki[i].pasazerowie.load(std::memory_order_relaxed));
+    }
+
+    // --- LICZNIKI SKUMULOWANE ---
+    long long odloty = d->stat_odloty.load();
+    metryka(s, "so2_arrivals_total", "counter", "Samoloty wpuszczone do systemu", d->stat_przyloty.load());
+    metryka(s, "so2_rejected_total", "counter", "Samoloty niewpuszczone", d->stat_odrzucone.load());
+    metryka(s, "so2_departures_total", "counter", "Odloty", odloty);
+    metryka(s, "so2_departures_full_total", "counter", "Odloty z kompletem pasazerow", d->stat_pelne.load());
+    metryka(s, "so2_diverted_total", "counter", "Przekierowane na zapasowe", d->stat_przekierowane.load());
+    metryka(s, "so2_killed_total", "counter", "Samoloty zabite w obsludze (--kill-every)", d->stat_zabite);
+    metryka(s, "so2_reclaimed_total", "counter", "Zasoby odebrane zabitym samolotom", d->stat_odzyskane);
+    metryka(s, "so2_network_arrivals_total", "counter", "Przyloty z innych lotnisk sieci", d->stat_przyloty_sieci.load());
+    metryka(s, "so2_network_departures_total", "counter", "Odloty do innych lotnisk sieci", d->stat_odloty_sieci.load());
+    metryka(s, "so2_passengers_arrived_total", "counter", "Pasazerowie przybyli do terminalu",
+            d->stat_pasazerowie_przybyli.load());
+    metryka(s, "so2_passengers_boarded_total", "counter", "Pasazerowie zabrani", d->stat_pasazerowie_zabrani.load());
+    metryka(s, "so2_fuel_waits_total", "counter", "Tankowania, ktore czekaly na dostawe", d->stat_bez_paliwa.load());
+    metryka(s, "so2_fuel_wait_seconds_total", "counter", "Laczne czekanie na paliwo",
+            d->stat_paliwo_czekanie_us.load() / 1e6);
+    metryka(s, "so2_runway_busy_seconds_total", "counter", "Laczny czas zajecia pasow", d->stat_pas_zajety_us.load() / 1e6);
+    metryka(s, "so2_gate_busy_seconds_total", "counter", "Laczny czas zajecia bramek", d->stat_gate_zajety_us.load() / 1e6);
+    long long obsluga_us = d->stat_obsluga_suma_us.load();
+    metryka(s, "so2_turnaround_seconds_total", "counter", "Suma czasow przylot -> odlot", obsluga_us / 1e6);
+    metryka(s, "so2_turnaround_seconds_avg", "gauge", "Sredni czas przylot -> odlot",
+            odloty > 0 ? obsluga_us / 1e6 / odloty : 0.0);
+    metryka(s, "so2_turnaround_seconds_max", "gauge", "Najdluzszy czas przylot -> odlot",
+            d->stat_obsluga_max_us.load() / 1e6);
+
+    // --- HISTOGRAMY (czasy symulacji; blokady w ns rzeczywistych) ---
+    dopisz(s, "# HELP so2_duration_seconds Czasy czekania i zajecia (histogram.h)\n"
+              "# TYPE so2_duration_seconds summary\n");
+    for (int m = 0; m < LICZBA_METRYK; m++) {
+        PodsumowanieHistogramu p = hist_podsumuj(m);
+        double skala = (m >= HIST_BLOKADA_CZEKANIE) ? 1e-9 : 1e-6;
+        std::string e = etykieta(NAZWY_METRYK[m]);
+        dopisz(s, "so2_duration_seconds{metric=\"%s\",quantile=\"0.5\"} %.9g\n", e.c_str(), p.p50 * skala);
+        dopisz(s, "so2_duration_seconds{metric=\"%s\",quantile=\"0.99\"} %.9g\n", e.c_str(), p.p99 * skala);
+        dopisz(s, "so2_duration_seconds_sum{metric=\"%s\"} %.9g\n", e.c_str(), p.srednia * p.liczba * skala);
+        dopisz(s, "so2_duration_seconds_count{metric=\"%s\"} %llu\n", e.c_str(), (unsigned long long)p.liczba);
+    }
+    return s;
+}
+
+// =============================================================
+// =======  WYJŚCIA  ===========================================
+// =============================================================
+
+static bool zapisz_plik(const std::string& plik, const std::string& tresc) {
+    std::string tmp = plik + ".tmp";
+    FILE* f = fopen(tmp.c_str(), "w");
+    if (f == nullptr) { perror(tmp.c_str()); return false; }
+    fwrite(tresc.data(), 1, tresc.size(), f);
+    if (fclose(f) != 0 || rename(tmp.c_str(), plik.c_str()) != 0) { perror(plik.c_str()); return false; }
+    return true;
+}
+
+static void wyslij_wszystko(int fd, const char* dane, size_t n) {
+    while (n > 0) {
+        ssize_t w = write(fd, dane, n);
+        if (w <= 0) { if (w == -1 && errno == EINTR) continue; return; }
+        dane += w;
+        n -= w;
+    }
+}
+
+static int otworz_gniazdo(const std::string& sciezka) {
+    struct sockaddr_un adres = {};
+    adres.sun_family = AF_UNIX;
+    if (sciezka.size() >= sizeof(adres.sun_path)) {
+        fprintf(stderr, "Za dluga sciezka gniazda: %s\n", sciezka.c_str());
+        return -1;
+    }
+    strcpy(adres.sun_path, sciezka.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd == -1) { perror("socket"); return -1; }
+    unlink(sciezka.c_str());
+    if (bind(fd, (struct sockaddr*)&adres, sizeof(adres)) == -1 || listen(fd, 8) == -1) {
+        perror(sciezka.c_str());
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+// Jedno połączenie: HTTP, jeśli klient zaczął od "GET", inaczej sama migawka
+static void obsluz_polaczenie(int gniazdo) {
+    int fd = accept4(gniazdo, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd == -1) return;
+    char zadanie[256];
+    ssize_t n = 0;
+    struct pollfd p = { fd, POLLIN, 0 };
+    if (poll(&p, 1, 100) > 0) n = read(fd, zadanie, sizeof(zadanie));
+    std::string tresc = migawka();
+    if (n >= 4 && memcmp(zadanie, "GET ", 4) == 0) {
+        char naglowek[160];
+        int h = snprintf(naglowek, sizeof(naglowek),
+                         "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: %zu\r\n\r\n",
+                         tresc.size());
+        wyslij_wszystko(fd, naglowek, h);
+    }
+    wyslij_wszystko(fd, tresc.data(), tresc.size());
+    close(fd);
+}
+
+static void wypisz_pomoc(const char* nazwa) {
+    fprintf(stderr,
+            "Uzycie: %s [opcje]\n"
+            "  --shmid=N         segment o danym id (domyslnie klucz SHM_KEY)\n"
+            "  --interval-ms=N   co ile ms migawka (domyslnie 1000)\n"
+            "  --out=PLIK        migawka do pliku (podmiana przez rename)\n"
+            "  --socket=SCIEZKA  migawka dla kazdego polaczenia na gniezdzie uniksowym\n"
+            "  --once            jedna migawka na stdout i koniec\n",
+            nazwa);
+}
+
+int main(int argc, char** argv) {
+    int id = -1;
+    int okres_ms = 1000;
+    bool raz = false;
+    std::string plik;
+    std::string sciezka_gniazda;
+    for (int i = 1; i < argc; i++) {
+        const char* a = argv[i];
+        if (strncmp(a, "--shmid=", 8) == 0) id = atoi(a + 8);
+        else if (strncmp(a, "--interval-ms=", 14) == 0) okres_ms = atoi(a + 14);
+        else if (strncmp(a, "--out=", 6) == 0) plik = a + 6;
+        else if (strncmp(a, "--socket=", 9) == 0) sciezka_gniazda = a + 9;
+        else if (strcmp(a, "--once") == 0) raz = true;
+        else { wypisz_pomoc(argv[0]); return 1; }
+    }
+    if (okres_ms < 1) { wypisz_pomoc(argv[0]); return 1; }
+
+    if (!podlacz(id)) return 1;
+    if (raz) {
+        std::string tresc = migawka();
+        fwrite(tresc.data(), 1, tresc.size(), stdout);
+        return 0;
+    }
+
+    int gniazdo = -1;
+    if (!sciezka_gniazda.empty()) {
+        gniazdo = otworz_gniazdo(sciezka_gniazda);
+        if (gniazdo == -1) return 1;
+    }
+    signal(SIGINT, na_sygnal);
+    signal(SIGTERM, na_sygnal);
+    signal(SIGPIPE, SIG_IGN);
+
+    bool na_stdout = plik.empty() && gniazdo == -1;
+    while (!koniec) {
+        bool ostatnia = segment_usuniety();
+        if (na_stdout) {
+            std::string tresc = migawka();
+            fwrite(tresc.data(), 1, tresc.size(), stdout);
+            fputc('\n', stdout);
+            fflush(stdout);
+        }
+        if (!plik.empty()) zapisz_plik(plik, migawka());
+        if (ostatnia) break;
+
+        // Czekanie do następnej migawki, w międzyczasie odpowiedzi na gnieździe
+        struct timespec t0, t;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        int zostalo = okres_ms;
+        while (!koniec && zostalo > 0) {
+            if (gniazdo != -1) {
+                struct pollfd p = { gniazdo, POLLIN, 0 };
+                if (poll(&p, 1, zostalo) > 0) obsluz_polaczenie(gniazdo);
+            } else {
+                poll(nullptr, 0, zostalo);
+            }
+            clock_gettime(CLOCK_MONOTONIC, &t);
+            zostalo = okres_ms - (int)((t.tv_sec - t0.tv_sec) * 1000 + (t.tv_nsec - t0.tv_nsec) / 1000000);
+        }
+    }
+
+    if (gniazdo != -1) {
+        close(gniazdo);
+        unlink(sciezka_gniazda.c_str());
+    }
+    shmdt(d);
+    return 0;
+}
@@ -0,0 +1,40 @@
+#ifndef STEROWANIE_H
+#define STEROWANIE_H
+
+#include <atomic>
+#include <cstdint>
+
+// =============================================================
+// =======  STEROWANIE W BIEGU (so2ctl)  =======================
+// =============================================================
+//
+// Skrzynka poleceń w segmencie: so2ctl wpisuje "parametr=wartość",
+// a nadzorca symulacji w każdym takcie wykonuje oczekujące polecenia
+// tą samą drogą co harmonogram pliku scenariusza (zmien_w_biegu,
+// main.cpp) i odpisuje wynik. Jedyną synchronizacją jest stan
+// polecenia: kto przestawi go CAS-em, ten ma wyłączność na resztę pól.
+
+#define STEROWANIE_MAX_POLECEN 16
+
+enum StanPolecenia {
+    POL_WOLNE = 0,
+    POL_ZAPISYWANE,         // so2ctl wypełnia pola
+    POL_CZEKA,              // Do wykonania w najbliższym takcie
+    POL_WYKONYWANE,         // Wziął je nadzorca
+    POL_WYKONANE,
+    POL_ODRZUCONE           // Powód w odpowiedz
+};
+
+struct PolecenieSterujace {
+    std::atomic<int> stan;
+    char parametr[24];          // Nazwa jak w linii poleceń (--gates=N -> "gates")
+    int wartosc;
+    int64_t czas_us;            // Czas symulacji wykonania
+    char odpowiedz[64];
+};
+
+struct SkrzynkaPolecen {
+    PolecenieSterujace polecenia[STEROWANIE_MAX_POLECEN];
+};
+
+#endif
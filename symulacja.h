@@ -0,0 +1,255 @@
+#ifndef SYMULACJA_H
+#define SYMULACJA_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+
+#include "zegar.h"
+
+// =============================================================
+// =======  KONFIGURACJA I URUCHAMIANIE SYMULACJI  =============
+// =============================================================
+
+#define MAX_KIERUNKOW 256
+
+// Stałe przebiegu (main.cpp; model kolejek w model.cpp liczy z nich czasy obsługi)
+#define TAKT_US 100000              // Takt pętli głównej (przyloty i pasażerowie)
+#define FUEL_NEEDED 600             // Litry na samolot
+#define CZAS_TANKOWANIA_US 2000000
+
+// --- KONFIGURACJA (Ustawiana na starcie, przed utworzeniem segmentu) ---
+struct Konfiguracja {
+    int cfg_runways;        // Aktywne pasy
+    int cfg_gates;          // Aktywne bramki
+    int cfg_tankers;        // Cysterny
+    int cfg_kierunki;       // Liczba kierunków (bram terminalu)
+    int cfg_spawn_rate;     // Co ile cykli nowy samolot
+    int cfg_pax_rate;       // Szansa na pasażera %
+    int cfg_boarding_time;  // Czas postoju
+    int cfg_plane_capacity; // Pojemność samolotu
+    int cfg_landing_time;   // Czas na pasie (mikrosekundy)
+    int cfg_kolowanie;      // Miejsca na drodze kołowania (0 = czekanie na bramkę na pasie)
+    int cfg_przekierowanie; // Po ilu s krążenia samolot leci na zapasowe (0 = nigdy)
+    int cfg_obsluga_rownolegla; // 1 = tankowanie równolegle z boardingiem
+    int cfg_sprzatanie;     // Sprzątanie przed boardingiem (s, 0 = brak)
+    int cfg_catering;       // Catering równolegle z resztą (s, 0 = brak)
+    int cfg_polityka_pasow; // Kolejność przydziału pasów (PolitykaPasow, wieza.h)
+    int cfg_paczka_pasow;   // Ile operacji jednego rodzaju z rzędu (naprzemiennie)
+    int cfg_czas_startu;    // Czas na pasie przy starcie (us, 0 = jak lądowanie)
+    int cfg_rekordy_pasazerow; // 1 = pasażer jako rekord z czasem przybycia
+    int cfg_przydzial_kierunkow; // Wybór kierunku samolotu (PolitykaPrzydzialu, przydzial.h)
+    int cfg_dostawa_paliwa; // Litry na dostawę
+    int cfg_czas_dostawy;   // Co ile s dostawa
+    int cfg_silnik;         // Procesy albo zdarzenia w jednym procesie (SilnikSymulacji, zdarzenia.h)
+    int cfg_max_pasow;      // Zainstalowane pasy/bramki/cysterny: rekordy w segmencie i górna
+    int cfg_max_bramek;     // granica zmian w biegu (0 = tyle, ile wymaga scenariusz)
+    int cfg_max_cystern;
+    int cfg_zabijanie;      // Co ile s zabity losowy samolot (--kill-every, 0 = nigdy)
+    char scenariusz_nazwa[50]; // Nazwa do wyświetlania
+};
+
+// Parametry, które można nadpisać z linii poleceń (--runways=N)
+// i przeglądać w --sweep (--range=runways=1:4)
+enum ParametrId {
+    PARAM_RUNWAYS = 0,
+    PARAM_GATES,
+    PARAM_TANKERS,
+    PARAM_DIRECTIONS,
+    PARAM_SPAWN_RATE,
+    PARAM_PAX_RATE,
+    PARAM_BOARDING_TIME,
+    PARAM_CAPACITY,
+    PARAM_LANDING_TIME,
+    PARAM_TAXIWAY,
+    PARAM_DIVERT_AFTER,
+    PARAM_GROUND_OPS,
+    PARAM_CLEANING_TIME,
+    PARAM_CATERING_TIME,
+    PARAM_RUNWAY_POLICY,
+    PARAM_RUNWAY_BATCH,
+    PARAM_TAKEOFF_TIME,
+    PARAM_PAX_RECORDS,
+    PARAM_DIRECTION_POLICY,
+    PARAM_FUEL_DELIVERY,
+    PARAM_DELIVERY_TIME,
+    PARAM_ENGINE,
+    PARAM_MAX_RUNWAYS,
+    PARAM_MAX_GATES,
+    PARAM_MAX_TANKERS,
+    PARAM_KILL_EVERY,
+    LICZBA_PARAMETROW
+};
+
+struct ParametrKonfiguracji {
+    const char* nazwa;
+    int Konfiguracja::* pole;
+    int min;
+    int max;
+    bool w_biegu;           // Zmienialny w trakcie przebiegu (plik scenariusza, so2ctl)
+};
+
+extern const ParametrKonfiguracji PARAMETRY[LICZBA_PARAMETROW];
+
+// Indeks parametru po nazwie, -1 gdy nieznany
+int znajdz_parametr(const char* nazwa, size_t dlugosc);
+
+// Zmiana parametru w trakcie przebiegu (harmonogram z pliku scenariusza)
+struct ZmianaParametru {
+    int64_t czas_us;        // Czas symulacji od startu (w cyklu, gdy cykl > 0)
+    int parametr;
+    int wartosc;
+};
+
+// Zakres przeglądu jednego parametru: min, min+krok, ..., <= max
+struct ZakresParametru {
+    int parametr;
+    int min;
+    int max;
+    int krok;
+};
+
+struct OpcjeUruchomienia {
+    int scenariusz = 0;          // 0 = pytaj w menu
+    bool headless = false;
+    int tryb_zegara = ZEGAR_REALNY;
+    double predkosc = 1.0;
+    long long czas_symulacji_s = 3600;
+    int pula = 0;                // --pool=N
+    int fps = 10;                // Klatki ekranu (tryb z GUI)
+    bool benchmark = false;
+    int wynik_fd = -1;           // Wynik rurą zamiast raportu (benchmark, przegląd)
+    bool prywatne_ipc = false;   // IPC_PRIVATE zamiast SHM_KEY/SEM_KEY
+    bool ziarno_podane = false;
+    unsigned ziarno = 0;
+    std::string plik_sladu;      // --trace=PLIK, pusty = bez śladu
+    std::string plik_zapisu;     // --record=PLIK: ustawienia i skrót wyniku
+    std::string plik_odtworzenia;// --replay=PLIK
+    std::string plik_dziennika;  // --flight-log=PLIK, pusty = bez dziennika
+
+    // Nadpisania konfiguracji scenariusza (-1 = jak w scenariuszu)
+    int nadpisania[LICZBA_PARAMETROW];
+
+    // --- PLIK SCENARIUSZA (--scenario-file, scenariusze.cpp) ---
+    std::string plik_scenariusza;
+    std::string nazwa_scenariusza;     // Pusta = nazwa scenariusza wbudowanego
+    std::vector<ZmianaParametru> zmiany; // Posortowane po czasie
+    int64_t cykl_zmian_us = 0;         // Harmonogram powtarzany co tyle (0 = raz)
+
+    // --- PRZEGLĄD PARAMETRÓW (--sweep) ---
+    bool przeglad = false;
+    std::vector<ZakresParametru> zakresy;
+    int replikacje = 4;
+    int zadania = 0;             // Równoległe przebiegi, 0 = liczba rdzeni
+    std::string plik_csv;        // Pusty = stdout
+
+    // --- OPTYMALIZACJA (--optimize, optymalizacja.cpp; zakresy i replikacje jak w przeglądzie) ---
+    bool optymalizacja = false;
+    double cel_odloty_h = 0;     // --target-throughput, 0 = przyloty scenariusza
+    double cel_p99_s = 0;        // --target-p99, 0 = dwa razy obsługa bez czekania
+    int max_prob = 64;           // --max-trials: kandydaci do symulacji
+    std::vector<std::pair<int, int>> koszty; // --cost=P=C: (parametr, koszt jednostki)
+
+    // --- SIEĆ LOTNISK (--network, siec.h) ---
+    int lotniska = 0;            // 0 = jedno lotnisko bez sieci
+    int lotnisko = -1;           // Numer lotniska w procesie sieci, -1 = poza siecią
+    int czas_lotu_s = 900;       // --flight-time=S
+    int udzial_sieci = 50;       // --network-share=P
+
+    OpcjeUruchomienia() {
+        for (int i = 0; i < LICZBA_PARAMETROW; i++) nadpisania[i] = -1;
+    }
+};
+
+// Wynik pojedynczego przebiegu bez GUI (przesyłany rurą)
+struct WynikSymulacji {
+    Konfiguracja cfg;
+    unsigned ziarno;
+    double czas_sym_s;
+    double czas_real_s;
+    long long przyloty;
+    long long odrzucone;
+    long long odloty;
+    long long pelne;
+    long long pasazerowie_przybyli;
+    long long pasazerowie_zabrani;
+    long long bez_paliwa;                     // Tankowania, które czekały na dostawę
+    long long przekierowane;
+    long long zabite;                         // Samoloty zabite w trakcie obsługi (--kill-every)
+    long long odzyskane;                      // Zasoby odebrane zabitym
+    long long przyloty_sieci;                 // Z innych lotnisk sieci (--network)
+    long long odloty_sieci;                   // Do innych lotnisk sieci
+    long long w_locie_sieci;                  // Lecące tu na koniec przebiegu
+    double sredni_czas_obslugi_s;
+    double max_czas_obslugi_s;
+    double p99_czas_obslugi_s;                // Z histogramu HIST_OBSLUGA
+    double srednio_w_systemie;
+    int max_w_systemie;
+    double srednia_kolejka_pas;
+    int max_kolejka_pas;
+    double srednia_kolejka_bramka;
+    double srednio_w_powietrzu;               // Krążące nad lotniskiem
+    int max_w_powietrzu;
+    double srednio_na_kolowaniu;
+    double srednio_pasazerow_czeka;
+    double sredni_czas_czekania_pasazera_s;   // Z prawa Little'a
+    double zmierzone_czekanie_pasazera_s;     // Z rekordów (--pax-records), 0 bez nich
+    double p99_czekanie_pasazera_s;
+    double wykorzystanie_pasow;
+    double wykorzystanie_bramek;
+    long long ladowania;                      // Operacje na pasach (wieża)
+    long long starty;
+    double p99_czekanie_ladowanie_s;          // Z histogramów (histogram.h)
+    double p99_czekanie_start_s;
+    double p99_czekanie_bramka_s;
+    double p99_czekanie_cysterna_s;
+    double p99_czekanie_paliwo_s;
+    double paliwo_w_bramkach;                 // Czekanie na paliwo / zajęcie bramek
+    double niedobor_paliwa;                   // Część czasu, w której ktoś czekał na paliwo
+    uint64_t skrot_histogramow;               // Histogramy czasów symulacji (hist_skrot)
+};
+
+void ustaw_scenariusz(int wybor, Konfiguracja& cfg);
+int uruchom_symulacje(const OpcjeUruchomienia& opcje);
+
+// Uruchamia symulację w procesie potomnym; wynik do odczytu z *fd_wyniku
+pid_t uruchom_przebieg_w_tle(const OpcjeUruchomienia& opcje, int* fd_wyniku);
+bool odbierz_wynik(int fd, WynikSymulacji& wynik);
+
+// Liczba równoległych przebiegów (--jobs, domyślnie rdzenie)
+int liczba_zadan(const OpcjeUruchomienia& opcje);
+// Wszystkie przebiegi, najwyżej zadania naraz; gotowy(indeks, wynik albo nullptr)
+// w kolejności kończenia. false = nie udało się uruchomić przebiegu
+bool uruchom_rownolegle(const std::vector<OpcjeUruchomienia>& przebiegi, int zadania,
+                        const std::function<void(size_t, const WynikSymulacji*)>& gotowy);
+
+int przeglad_parametrow(const OpcjeUruchomienia& opcje);
+
+// --- OPTYMALIZACJA (optymalizacja.cpp): 0 = znaleziono, 2 = brak konfiguracji ---
+int optymalizuj(const OpcjeUruchomienia& opcje);
+
+// --- PLIK SCENARIUSZA (scenariusze.cpp) ---
+// Wartości z pliku trafiają do nadpisań niepodanych w linii poleceń;
+// false = błąd (komunikat z numerem wiersza na stderr)
+bool wczytaj_plik_scenariusza(const std::string& plik, OpcjeUruchomienia& o);
+
+// --- SIEĆ LOTNISK (siec.cpp): lotnisko na proces, wynik zbiorczy ---
+int siec_lotnisk(const OpcjeUruchomienia& opcje);
+
+// --- POMIARY (pomiary.cpp): prywatny segment SO2 bez procesów symulacji ---
+bool pomiary_przygotuj(int scenariusz);
+void pomiary_dodaj_log(int i);
+bool pomiary_ekran_init(int wiersze, int kolumny);
+void pomiary_klatka(bool pelna);
+void pomiary_ekran_koniec();
+
+// --- ZAPIS I ODTWORZENIE PRZEBIEGU (odtwarzanie.cpp) ---
+// Skrót wszystkiego, co wyznacza przebieg w zegarze wirtualnym (bez czasu rzeczywistego)
+uint64_t skrot_wyniku(const WynikSymulacji& w);
+bool zapisz_przebieg(const std::string& plik, int scenariusz, const OpcjeUruchomienia& opcje,
+                     const WynikSymulacji& w);
+// Powtarza zapisany przebieg; 0 = skrót zgodny
+int odtworz_przebieg(const OpcjeUruchomienia& opcje);
+
+#endif
@@ -0,0 +1,106 @@
+# Test obciążeniowy --kill-every (ctest): te same przebiegi przy stałym
+# ziarnie bez awarii i z awariami co KILL_EVERY s. Każdy musi zachować
+# bilans samolotów z raportu (przyleciały = odloty + przekierowane +
+# zabite + w systemie na koniec), a przebieg z awariami przepustowość
+# przebiegu bez nich z dokładnością do podanej tolerancji:
+#  - scenariusz 4 (wąskie gardło: pas) - odloty; w puli tylko 8 samolotów
+#    jest w obsłudze, więc awaria częściej trafia ten na pasie i marnuje
+#    jego czas (stąd szersza tolerancja),
+#  - scenariusz 2 (przyloty; bramki zajęte w połowie) - odloty i zabite
+#    razem: utracona jednostka bramki, cysterny czy miejsca kołowania
+#    zostawia samoloty w kolejce i to je obniża.
+# Scenariusz 2 idzie też na zegarze przyspieszonym (--speed), gdzie
+# awaria trafia proces w dowolnej chwili, nie tylko śpiący - raz z
+# --ground-ops i bramkami oraz cysternami zamykanymi pod obciążeniem
+# i otwieranymi z powrotem (plik scenariusza).
+#
+#   cmake -DSO2=<ścieżka do SO2> -P testy/awarie.cmake
+
+set(ZIARNO 3)
+set(KILL_EVERY 15)
+
+if(NOT SO2)
+    message(FATAL_ERROR "Brak -DSO2=<sciezka do SO2>")
+endif()
+
+# Liczba z pierwszego wiersza raportu pasującego do wzorca (grupa 1)
+function(liczba_z_raportu raport wzorzec wynik)
+    if(raport MATCHES "${wzorzec}")
+        set(${wynik} "${CMAKE_MATCH_1}" PARENT_SCOPE)
+    else()
+        set(${wynik} 0 PARENT_SCOPE)
+    endif()
+endfunction()
+
+# Przebieg bez GUI (argumenty po nazwie); w nazwa_* liczby z raportu
+function(przebieg nazwa)
+    execute_process(COMMAND "${SO2}" --headless --seed=${ZIARNO} ${ARGN}
+                    OUTPUT_VARIABLE raport ERROR_VARIABLE bledy RESULT_VARIABLE kod TIMEOUT 600)
+    if(NOT kod EQUAL 0)
+        message(FATAL_ERROR "${nazwa}: SO2 zakonczone kodem ${kod}\n${bledy}")
+    endif()
+    liczba_z_raportu("${raport}" "Samoloty przylecialy: +([0-9]+)" przyloty)
+    liczba_z_raportu("${raport}" "odrzucone: ([0-9]+)" odrzucone)
+    liczba_z_raportu("${raport}" "Odloty: +([0-9]+)" odloty)
+    liczba_z_raportu("${raport}" "W systemie na koniec: +([0-9]+)" w_systemie)
+    liczba_z_raportu("${raport}" "przekierowane ([0-9]+)" przekierowane)
+    liczba_z_raportu("${raport}" "Zabite w obsludze: +([0-9]+)" zabite)
+
+    math(EXPR suma "${odloty} + ${przekierowane} + ${zabite} + ${w_systemie}")
+    message(STATUS "${nazwa}: przylecialy ${przyloty} (odrzucone ${odrzucone}), odloty ${odloty}, "
+                   "przekierowane ${przekierowane}, zabite ${zabite}, w systemie ${w_systemie}")
+    if(przyloty EQUAL 0)
+        message(FATAL_ERROR "${nazwa}: brak przylotow w raporcie\n${raport}")
+    endif()
+    if(NOT suma EQUAL przyloty)
+        message(FATAL_ERROR "${nazwa}: bilans sie nie zgadza: ${odloty} + ${przekierowane} + ${zabite} + "
+                            "${w_systemie} = ${suma}, a przylecialo ${przyloty}")
+    endif()
+    set(${nazwa}_odrzucone ${odrzucone} PARENT_SCOPE)
+    set(${nazwa}_odloty ${odloty} PARENT_SCOPE)
+    set(${nazwa}_zabite ${zabite} PARENT_SCOPE)
+endfunction()
+
+# Przebiegi bez awarii i z awariami; odloty (z ZABITE: odloty i zabite)
+# z awariami najwyżej o tolerancja procent poniżej odlotów bez awarii.
+# Przebiegi trwają tyle samo, więc liczby porównują też odloty / h.
+function(porownaj nazwa tolerancja rodzaj)
+    przebieg(${nazwa}_bez_awarii ${ARGN})
+    przebieg(${nazwa} --kill-every=${KILL_EVERY} ${ARGN})
+    if(${nazwa}_zabite EQUAL 0)
+        message(FATAL_ERROR "${nazwa}: --kill-every=${KILL_EVERY} nikogo nie zabilo")
+    endif()
+    set(wzor ${${nazwa}_bez_awarii_odloty})
+    set(wynik ${${nazwa}_odloty})
+    if(rodzaj STREQUAL "ZABITE")
+        math(EXPR wynik "${wynik} + ${${nazwa}_zabite}")
+    endif()
+    math(EXPR spadek "(${wzor} - ${wynik}) * 100")
+    math(EXPR dopuszczalny "${wzor} * ${tolerancja}")
+    if(spadek GREATER dopuszczalny)
+        message(FATAL_ERROR "${nazwa}: z --kill-every=${KILL_EVERY} ${wynik} (${rodzaj}), bez awarii ${wzor} "
+                            "odlotow - spadek ponad ${tolerancja}%")
+    endif()
+    set(${nazwa}_odrzucone ${${nazwa}_odrzucone} PARENT_SCOPE)
+    set(${nazwa}_bez_awarii_odrzucone ${${nazwa}_bez_awarii_odrzucone} PARENT_SCOPE)
+endfunction()
+
+porownaj(pas 5 ODLOTY --max-speed --scenario=4)
+porownaj(pas_pula 15 ODLOTY --max-speed --scenario=4 --pool=8)
+porownaj(bramki 5 ZABITE --max-speed --scenario=2)
+porownaj(bramki_pula 5 ZABITE --max-speed --scenario=2 --pool=8)
+porownaj(bramki_speed 5 ZABITE --speed=100 --duration=1200 --scenario=2)
+
+set(zmiany "${CMAKE_CURRENT_BINARY_DIR}/awarie_zmiany.txt")
+file(WRITE "${zmiany}" "[00:05] gates=2 tankers=1\n[00:12] gates=6 tankers=3\n")
+porownaj(zmiany_speed 5 ZABITE --speed=100 --duration=1200 --scenario=2 --ground-ops=1
+         --max-gates=8 --max-tankers=4 --scenario-file=${zmiany})
+# Gęste awarie przy tych samych zmianach: sam bilans (bramka zabitego
+# wraca do puli przed slotem - gubiła samoloty dopiero co kilka sekund)
+przebieg(zmiany_gesto --kill-every=5 --speed=100 --duration=1200 --scenario=2
+         --max-gates=8 --max-tankers=4 --scenario-file=${zmiany})
+
+# Procesy samolotów nie mają limitu poniżej liczby przylotów (ustal_pojemnosc)
+if(NOT pas_bez_awarii_odrzucone EQUAL 0 OR NOT pas_odrzucone EQUAL 0)
+    message(FATAL_ERROR "Odrzucone przyloty bez puli: ${pas_bez_awarii_odrzucone} / ${pas_odrzucone}")
+endif()
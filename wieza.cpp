@@ -0,0 +1,262 @@
+#include "wieza.h"
+#include "zegar.h"
+
+#include <climits>
+#include <unistd.h>
+
+const char* const NAZWY_POLITYK[LICZBA_POLITYK] = {
+    "fcfs",
+    "najpierw ladowania",
+    "najpierw starty",
+    "krotsza operacja",
+    "naprzemiennie",
+};
+
+// =============================================================
+// =======  POLITYKA PRZYDZIAŁU  ===============================
+// =============================================================
+
+void polityka_pasow_init(StanPolitykiPasow* p, int polityka, int paczka, int64_t czas_ladowania_us,
+                         int64_t czas_startu_us) {
+    p->polityka = polityka;
+    p->paczka = (paczka > 0) ? paczka : 1;
+    p->czas_operacji_us[OP_LADOWANIE] = czas_ladowania_us;
+    p->czas_operacji_us[OP_START] = czas_startu_us;
+    p->ostatni_rodzaj = -1;
+    p->z_rzedu = 0;
+}
+
+int polityka_pasow_wybierz(const StanPolitykiPasow* p, long long numer_ladowania, long long numer_startu) {
+    if (numer_ladowania == -1 && numer_startu == -1) return -1;
+    if (numer_startu == -1) return OP_LADOWANIE;
+    if (numer_ladowania == -1) return OP_START;
+
+    switch (p->polityka) {
+        case POLITYKA_PRZYLOTY: return OP_LADOWANIE;
+        case POLITYKA_ODLOTY:   return OP_START;
+        case POLITYKA_KROTSZE:
+            if (p->czas_operacji_us[OP_LADOWANIE] != p->czas_operacji_us[OP_START]) {
+                return p->czas_operacji_us[OP_LADOWANIE] < p->czas_operacji_us[OP_START] ? OP_LADOWANIE : OP_START;
+            }
+            break;
+        case POLITYKA_NAPRZEMIENNIE:
+            if (p->ostatni_rodzaj >= 0) {
+                return (p->z_rzedu < p->paczka) ? p->ostatni_rodzaj : 1 - p->ostatni_rodzaj;
+            }
+            break;
+    }
+    return (numer_ladowania < numer_startu) ? OP_LADOWANIE : OP_START;
+}
+
+void polityka_pasow_zalicz(StanPolitykiPasow* p, int rodzaj) {
+    if (rodzaj == p->ostatni_rodzaj) {
+        p->z_rzedu++;
+    } else {
+        p->ostatni_rodzaj = rodzaj;
+        p->z_rzedu = 1;
+    }
+}
+
+// =============================================================
+// =======  KOLEJKA ZGŁOSZEŃ (pod blokadą wieży)  ==============
+// =============================================================
+
+static ZgloszeniePasa& zgloszenie(Wieza* w, int idx) {
+    return ((ZgloszeniePasa*)((char*)w + w->off_zgloszenia))[idx];
+}
+
+static void dopisz(Wieza* w, int idx) {
+    ZgloszeniePasa& z = zgloszenie(w, idx);
+    z.poprzedni = w->ogon[z.rodzaj];
+    z.nastepny = -1;
+    if (z.poprzedni == -1) w->glowa[z.rodzaj] = idx;
+    else zgloszenie(w, z.poprzedni).nastepny = idx;
+    w->ogon[z.rodzaj] = idx;
+}
+
+static void wypisz(Wieza* w, int idx) {
+    ZgloszeniePasa& z = zgloszenie(w, idx);
+    if (z.poprzedni == -1) w->glowa[z.rodzaj] = z.nastepny;
+    else zgloszenie(w, z.poprzedni).nastepny = z.nastepny;
+    if (z.nastepny == -1) w->ogon[z.rodzaj] = z.poprzedni;
+    else zgloszenie(w, z.nastepny).poprzedni = z.poprzedni;
+}
+
+// Zgłoszenie poza kolejką wraca na listę wolnych
+static void oddaj_zgloszenie(Wieza* w, int idx) {
+    ZgloszeniePasa& z = zgloszenie(w, idx);
+    z.wlasciciel = 0;
+    z.nastepny = w->wolne_zgloszenia;
+    w->wolne_zgloszenia = idx;
+}
+
+// Rodzaj operacji, która dostaje zwolniony pas (-1 = nikt nie czeka)
+static int wybierz_rodzaj(Wieza* w) {
+    int lad = w->glowa[OP_LADOWANIE];
+    int start = w->glowa[OP_START];
+    return polityka_pasow_wybierz(&w->polityka, lad == -1 ? -1 : zgloszenie(w, lad).numer,
+                                  start == -1 ? -1 : zgloszenie(w, start).numer);
+}
+
+// Pas wolny najdłużej (równomierne zużycie pasów)
+static int najdluzej_wolny(Wieza* w) {
+    int najlepszy = -1;
+    for (int p = 0; p < w->liczba_pasow; p++) {
+        if (w->pas_wolny[p] && (najlepszy == -1 || w->pas_zwolniony_us[p] < w->pas_zwolniony_us[najlepszy])) {
+            najlepszy = p;
+        }
+    }
+    return najlepszy;
+}
+
+// =============================================================
+// =======  API  ===============================================
+// =============================================================
+
+void wieza_init(Wieza* w, int polityka, int paczka, int pasy, int zainstalowane, int64_t czas_ladowania_us,
+                int64_t czas_startu_us, ZgloszeniePasa* zgloszenia, int max_zgloszen) {
+    blokada_init(&w->blokada);
+    polityka_pasow_init(&w->polityka, polityka, paczka, czas_ladowania_us, czas_startu_us);
+    w->liczba_pasow = (zainstalowane < SLOTY_MAX) ? zainstalowane : SLOTY_MAX;
+    w->czynne_pasy = (pasy < w->liczba_pasow) ? pasy : w->liczba_pasow;
+    w->wolne_pasy = w->czynne_pasy;
+    w->do_zamkniecia = 0;
+    w->nastepny_numer = 0;
+    for (int r = 0; r < LICZBA_OPERACJI; r++) {
+        w->glowa[r] = -1;
+        w->ogon[r] = -1;
+    }
+    for (int p = 0; p < SLOTY_MAX; p++) {
+        w->pas_wolny[p] = p < w->czynne_pasy;
+        w->pas_zamkniety[p] = p >= w->czynne_pasy && p < w->liczba_pasow;
+        w->pas_zwolniony_us[p] = 0;
+    }
+    w->off_zgloszenia = (char*)zgloszenia - (char*)w;
+    w->max_zgloszen = max_zgloszen;
+    w->wolne_zgloszenia = -1;
+    for (int i = max_zgloszen - 1; i >= 0; i--) oddaj_zgloszenie(w, i);
+}
+
+int wieza_wez_pas(Wieza* w, int rodzaj, int64_t termin_us) {
+    if (termin_us < 0) termin_us = INT64_MAX;
+
+    blokada_wez(&w->blokada);
+    // Wolny pas przy pustej kolejce (przy czekających pas nie stoi wolny)
+    if (w->wolne_pasy > 0) {
+        int pas = najdluzej_wolny(w);
+        w->pas_wolny[pas] = false;
+        w->wolne_pasy--;
+        polityka_pasow_zalicz(&w->polityka, rodzaj);
+        blokada_oddaj(&w->blokada);
+        return pas;
+    }
+    if (termin_us <= zegar_teraz_us()) {
+        blokada_oddaj(&w->blokada);
+        return -1;
+    }
+
+    int idx = w->wolne_zgloszenia;
+    ZgloszeniePasa& z = zgloszenie(w, idx);
+    w->wolne_zgloszenia = z.nastepny;
+    z.przydzielony.store(0, std::memory_order_relaxed);
+    z.pas = -1;
+    z.rodzaj = rodzaj;
+    z.slot_zegara = zegar_slot;
+    z.numer = w->nastepny_numer++;
+    z.wlasciciel = getpid();
+    dopisz(w, idx);
+    blokada_oddaj(&w->blokada);
+
+    zegar_czekaj_na(&z.przydzielony, termin_us);
+
+    // Po terminie pas mógł przyjść tuż przed wzięciem blokady - wtedy go bierzemy
+    blokada_wez(&w->blokada);
+    int pas = -1;
+    if (z.przydzielony.load(std::memory_order_acquire) != 0) pas = z.pas;
+    else wypisz(w, idx);
+    oddaj_zgloszenie(w, idx);
+    blokada_oddaj(&w->blokada);
+    return pas;
+}
+
+// Pas dla następnego zgłoszenia według polityki, bez zgłoszeń wolny (pod blokadą)
+static void przekaz_pas(Wieza* w, int pas) {
+    int rodzaj = wybierz_rodzaj(w);
+    if (rodzaj == -1) {
+        w->pas_wolny[pas] = true;
+        w->pas_zwolniony_us[pas] = zegar_teraz_us();
+        w->wolne_pasy++;
+    } else {
+        int idx = w->glowa[rodzaj];
+        ZgloszeniePasa& z = zgloszenie(w, idx);
+        wypisz(w, idx);
+        polityka_pasow_zalicz(&w->polityka, rodzaj);
+        z.pas = pas;
+        zegar_obudz(z.slot_zegara, &z.przydzielony);
+    }
+}
+
+// Zwolniony pas spłaca zamknięcie w toku albo idzie dalej (pod blokadą)
+static void zwolnij(Wieza* w, int pas) {
+    if (w->do_zamkniecia > 0) {
+        w->do_zamkniecia--;
+        w->pas_zamkniety[pas] = true;
+    } else {
+        przekaz_pas(w, pas);
+    }
+}
+
+void wieza_zwolnij_pas(Wieza* w, int pas) {
+    if (pas < 0) return;
+
+    blokada_wez(&w->blokada);
+    zwolnij(w, pas);
+    blokada_oddaj(&w->blokada);
+}
+
+int wieza_porzuc(Wieza* w, pid_t pid) {
+    int pasy = 0;
+    blokada_wez(&w->blokada);
+    for (int idx = 0; idx < w->max_zgloszen; idx++) {
+        ZgloszeniePasa& z = zgloszenie(w, idx);
+        if (z.wlasciciel != pid) continue;
+        if (z.przydzielony.load(std::memory_order_acquire) != 0) {
+            zwolnij(w, z.pas);
+            pasy++;
+        } else {
+            wypisz(w, idx);
+        }
+        oddaj_zgloszenie(w, idx);
+    }
+    blokada_oddaj(&w->blokada);
+    return pasy;
+}
+
+void wieza_zmien_pasy(Wieza* w, int pasy) {
+    if (pasy < 1) pasy = 1;
+    if (pasy > w->liczba_pasow) pasy = w->liczba_pasow;
+
+    blokada_wez(&w->blokada);
+    for (; w->czynne_pasy > pasy; w->czynne_pasy--) {
+        int pas = najdluzej_wolny(w);
+        if (pas == -1) {
+            w->do_zamkniecia++;
+            continue;
+        }
+        w->pas_wolny[pas] = false;
+        w->pas_zamkniety[pas] = true;
+        w->wolne_pasy--;
+    }
+    // Otwarcie najpierw odwołuje zamknięcia, które jeszcze czekają
+    for (; w->czynne_pasy < pasy; w->czynne_pasy++) {
+        if (w->do_zamkniecia > 0) {
+            w->do_zamkniecia--;
+            continue;
+        }
+        int pas = 0;
+        while (!w->pas_zamkniety[pas]) pas++;
+        w->pas_zamkniety[pas] = false;
+        przekaz_pas(w, pas);
+    }
+    blokada_oddaj(&w->blokada);
+}
@@ -0,0 +1,120 @@
+#ifndef WIEZA_H
+#define WIEZA_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+#include "blokady.h"
+#include "sloty.h"
+
+// =============================================================
+// =======  WIEŻA: PRZYDZIAŁ PASÓW  ============================
+// =============================================================
+//
+// Lądowania i starty czekają na pas w jawnej kolejce w pamięci
+// współdzielonej, a nie na semaforze SysV (kolejność budzenia przez
+// semop jest nieokreślona). Każde zgłoszenie dostaje kolejny numer
+// (bilet). Zwalniający pas wybiera według polityki następne zgłoszenie
+// i przekazuje mu ten pas wprost; wolny pas dla nowego zgłoszenia to
+// ten, który stoi wolny najdłużej.
+//
+// Czekający śpi na fladze swojego zgłoszenia (zegar_czekaj_na: futex
+// w zegarze realnym i przyspieszonym, kolejka zegara w wirtualnym).
+//
+// Liczbę czynnych pasów można zmienić w biegu (wieza_zmien_pasy): pas
+// zamykany jest od razu, gdy stoi wolny, a inaczej zamyka go najbliższe
+// zwolnienie - samolot na pasie zawsze kończy operację.
+//
+// Zgłoszeń jest tyle, ile procesów może naraz czekać na pas (wieza_init);
+// proces ma najwyżej jedno, więc wolne zgłoszenie zawsze jest.
+
+enum PolitykaPasow {
+    POLITYKA_FCFS = 0,          // Kolejność zgłoszeń
+    POLITYKA_PRZYLOTY,          // Najpierw lądowania
+    POLITYKA_ODLOTY,            // Najpierw starty
+    POLITYKA_KROTSZE,           // Krótsza operacja na pasie, remis: FCFS
+    POLITYKA_NAPRZEMIENNIE,     // Paczki po N jednego rodzaju, potem zmiana
+    LICZBA_POLITYK
+};
+
+enum RodzajOperacji {
+    OP_LADOWANIE = 0,
+    OP_START,
+    LICZBA_OPERACJI
+};
+
+extern const char* const NAZWY_POLITYK[LICZBA_POLITYK];
+
+// Stan polityki przydziału pasów; osobno, bo używa go też silnik zdarzeń
+// (main.cpp), który prowadzi własne kolejki do pasów bez blokad i zegara
+struct StanPolitykiPasow {
+    int polityka;
+    int paczka;                          // POLITYKA_NAPRZEMIENNIE
+    int64_t czas_operacji_us[LICZBA_OPERACJI];
+    int ostatni_rodzaj;                  // Ostatnio przydzielony i ile razy z rzędu
+    int z_rzedu;
+};
+
+struct alignas(64) ZgloszeniePasa {
+    std::atomic<uint32_t> przydzielony;  // 1 = pas przekazany
+    int pas;
+    int rodzaj;
+    int poprzedni;                       // Lista zgłoszeń tego rodzaju
+    int nastepny;
+    int slot_zegara;                     // Kogo budzić w trybie wirtualnym
+    long long numer;                     // Bilet
+    pid_t wlasciciel;                    // Czekający proces, 0 = zgłoszenie wolne
+};
+
+struct Wieza {
+    Blokada blokada;                     // Chroni wszystko poniżej
+    StanPolitykiPasow polityka;
+    int liczba_pasow;                    // Zainstalowane
+    int czynne_pasy;                     // Docelowo czynne (po zamknięciach w toku)
+    int wolne_pasy;
+    int do_zamkniecia;                   // Zamknięcia czekające na zwolnienie pasa
+
+    long long nastepny_numer;
+    int glowa[LICZBA_OPERACJI];
+    int ogon[LICZBA_OPERACJI];
+
+    bool pas_wolny[SLOTY_MAX];
+    bool pas_zamkniety[SLOTY_MAX];       // Odczyt ekranu bez blokady
+    int64_t pas_zwolniony_us[SLOTY_MAX];
+
+    int wolne_zgloszenia;                // Lista wolnych przez nastepny (-1 = koniec)
+    int max_zgloszen;
+    size_t off_zgloszenia;               // Tablica zgłoszeń (od początku Wieza)
+};
+
+// pasy czynnych z zainstalowanych (reszta zamknięta do wieza_zmien_pasy);
+// zgloszenia: max_zgloszen miejsc w tym samym segmencie co w, po jednym
+// na proces, który może czekać na pas
+void wieza_init(Wieza* w, int polityka, int paczka, int pasy, int zainstalowane, int64_t czas_ladowania_us,
+                int64_t czas_startu_us, ZgloszeniePasa* zgloszenia, int max_zgloszen);
+
+// Numer przydzielonego pasa; -1 gdy minął termin (termin_us < 0: bez terminu)
+int wieza_wez_pas(Wieza* w, int rodzaj, int64_t termin_us);
+void wieza_zwolnij_pas(Wieza* w, int pas);
+
+// Zgłoszenie zabitego procesu: wyjęcie z kolejki, a pas już mu
+// przekazany idzie dalej jak przy zwolnieniu. Zwraca liczbę takich pasów.
+int wieza_porzuc(Wieza* w, pid_t pid);
+
+// Nowa liczba czynnych pasów (1..liczba_pasow); otwierany pas od razu
+// dostaje czekające zgłoszenie
+void wieza_zmien_pasy(Wieza* w, int pasy);
+
+void polityka_pasow_init(StanPolitykiPasow* p, int polityka, int paczka, int64_t czas_ladowania_us,
+                         int64_t czas_startu_us);
+
+// Rodzaj operacji, która dostaje zwolniony pas; numer_* to bilet
+// pierwszego czekającego danego rodzaju (-1 = nikt), wynik -1 = nikt nie czeka
+int polityka_pasow_wybierz(const StanPolitykiPasow* p, long long numer_ladowania, long long numer_startu);
+
+// Odnotowanie przydziału pasa operacji danego rodzaju
+void polityka_pasow_zalicz(StanPolitykiPasow* p, int rodzaj);
+
+#endif
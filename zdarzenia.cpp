@@ -0,0 +1,103 @@
+#include "zdarzenia.h"
+
+#include <climits>
+
+const char* const NAZWY_SILNIKOW[LICZBA_SILNIKOW] = {
+    "procesy",
+    "zdarzenia",
+};
+
+// =============================================================
+// =======  KOLEJKA ZDARZEŃ (kopiec binarny)  ==================
+// =============================================================
+
+static bool wczesniej(const Zdarzenie& a, const Zdarzenie& b) {
+    if (a.czas_us != b.czas_us) return a.czas_us < b.czas_us;
+    return a.numer < b.numer;
+}
+
+void zdarzenia_init(KolejkaZdarzen* k) {
+    k->kopiec.clear();
+    k->nastepny_numer = 0;
+}
+
+void zdarzenia_dodaj(KolejkaZdarzen* k, int64_t czas_us, int uczestnik, uint32_t epoka) {
+    std::vector<Zdarzenie>& h = k->kopiec;
+    Zdarzenie z = { czas_us, k->nastepny_numer++, uczestnik, epoka };
+    size_t i = h.size();
+    h.push_back(z);
+    while (i > 0) {
+        size_t rodzic = (i - 1) / 2;
+        if (!wczesniej(z, h[rodzic])) break;
+        h[i] = h[rodzic];
+        i = rodzic;
+    }
+    h[i] = z;
+}
+
+int64_t zdarzenia_najblizsze_us(const KolejkaZdarzen* k) {
+    return k->kopiec.empty() ? INT64_MAX : k->kopiec[0].czas_us;
+}
+
+bool zdarzenia_zdejmij(KolejkaZdarzen* k, Zdarzenie* z) {
+    std::vector<Zdarzenie>& h = k->kopiec;
+    if (h.empty()) return false;
+    *z = h[0];
+    Zdarzenie ostatni = h.back();
+    h.pop_back();
+    size_t n = h.size();
+    if (n == 0) return true;
+
+    // Dziura od korzenia w dół, na koniec ostatni element w jej miejsce
+    size_t i = 0;
+    while (true) {
+        size_t dziecko = 2 * i + 1;
+        if (dziecko >= n) break;
+        if (dziecko + 1 < n && wczesniej(h[dziecko + 1], h[dziecko])) dziecko++;
+        if (!wczesniej(h[dziecko], ostatni)) break;
+        h[i] = h[dziecko];
+        i = dziecko;
+    }
+    h[i] = ostatni;
+    return true;
+}
+
+// =============================================================
+// =======  LISTY CZEKAJĄCYCH  =================================
+// =============================================================
+
+void lista_init(ListaCzekajacych* l) {
+    l->glowa = -1;
+    l->ogon = -1;
+    l->dlugosc = 0;
+}
+
+void lista_dopisz(ListaCzekajacych* l, WezelCzekania* wezly, int idx, int64_t priorytet) {
+    WezelCzekania& w = wezly[idx];
+    w.priorytet = priorytet;
+    int za = l->ogon;
+    while (za != -1 && wezly[za].priorytet > priorytet) za = wezly[za].poprzedni;
+
+    w.poprzedni = za;
+    w.nastepny = (za == -1) ? l->glowa : wezly[za].nastepny;
+    if (za == -1) l->glowa = idx;
+    else wezly[za].nastepny = idx;
+    if (w.nastepny == -1) l->ogon = idx;
+    else wezly[w.nastepny].poprzedni = idx;
+    l->dlugosc++;
+}
+
+void lista_wypisz(ListaCzekajacych* l, WezelCzekania* wezly, int idx) {
+    WezelCzekania& w = wezly[idx];
+    if (w.poprzedni == -1) l->glowa = w.nastepny;
+    else wezly[w.poprzedni].nastepny = w.nastepny;
+    if (w.nastepny == -1) l->ogon = w.poprzedni;
+    else wezly[w.nastepny].poprzedni = w.poprzedni;
+    l->dlugosc--;
+}
+
+int lista_zdejmij(ListaCzekajacych* l, WezelCzekania* wezly) {
+    int idx = l->glowa;
+    if (idx != -1) lista_wypisz(l, wezly, idx);
+    return idx;
+}
@@ -0,0 +1,74 @@
+#ifndef ZDARZENIA_H
+#define ZDARZENIA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// =============================================================
+// =======  SILNIK ZDARZEŃ DYSKRETNYCH (--engine=1)  ===========
+// =============================================================
+//
+// Cała symulacja w jednym procesie i jednym wątku: samolot to maszyna
+// stanów (fazy jak w obsluz_samolot), wznawiana zdarzeniem z kolejki
+// priorytetowej - kopca binarnego po czasie symulacji. Remis czasu
+// rozstrzyga kolejność dodania, jak FIFO gotowych w zegarze wirtualnym.
+//
+// Czekanie na zasób to wpis na liście czekających; węzły list leżą
+// w tablicy równoległej do uczestników, więc czekanie niczego nie
+// alokuje. Termin czekania to osobne zdarzenie - unieważnia je epoka
+// uczestnika, podbijana przy każdym nowym zaplanowaniu.
+
+enum SilnikSymulacji {
+    SILNIK_PROCESY = 0,         // Proces na samolot (albo pula), zegar z zegar.h
+    SILNIK_ZDARZENIA,           // Maszyny stanów w jednym procesie
+    LICZBA_SILNIKOW
+};
+
+extern const char* const NAZWY_SILNIKOW[LICZBA_SILNIKOW];
+
+struct Zdarzenie {
+    int64_t czas_us;
+    uint64_t numer;             // Kolejność dodania (remis czasu)
+    int uczestnik;
+    uint32_t epoka;             // Nieaktualne, gdy uczestnik ma już nowszą
+};
+
+struct KolejkaZdarzen {
+    std::vector<Zdarzenie> kopiec;
+    uint64_t nastepny_numer;
+};
+
+void zdarzenia_init(KolejkaZdarzen* k);
+void zdarzenia_dodaj(KolejkaZdarzen* k, int64_t czas_us, int uczestnik, uint32_t epoka);
+
+// Czas najwcześniejszego zdarzenia; INT64_MAX = kolejka pusta
+int64_t zdarzenia_najblizsze_us(const KolejkaZdarzen* k);
+
+// Najwcześniejsze zdarzenie; false = kolejka pusta
+bool zdarzenia_zdejmij(KolejkaZdarzen* k, Zdarzenie* z);
+
+// --- LISTY CZEKAJĄCYCH (węzeł uczestnika idx to wezly[idx]) ---
+struct WezelCzekania {
+    int poprzedni;
+    int nastepny;
+    int64_t priorytet;          // Mniejszy pierwszy, remis: FIFO
+};
+
+struct ListaCzekajacych {
+    int glowa;
+    int ogon;
+    int dlugosc;
+};
+
+void lista_init(ListaCzekajacych* l);
+
+// Za ostatnim o priorytecie <= priorytet; przy samych INT64_MAX (FIFO)
+// zawsze dopisanie na koniec, jak wstaw_do_kolejki w zegarze
+void lista_dopisz(ListaCzekajacych* l, WezelCzekania* wezly, int idx, int64_t priorytet);
+void lista_wypisz(ListaCzekajacych* l, WezelCzekania* wezly, int idx);
+
+// Zdejmuje pierwszego; -1 = lista pusta
+int lista_zdejmij(ListaCzekajacych* l, WezelCzekania* wezly);
+
+#endif
@@ -0,0 +1,527 @@
+#include "zegar.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <ctime>
+#include <functional>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+int zegar_slot = -1;
+static ZegarWirtualny* zegar = nullptr;
+static ZegarUczestnik* uczestnicy = nullptr;
+static int* pobudki = nullptr;       // Kopiec slotów (zegar.h)
+static int* wolne = nullptr;
+
+// =============================================================
+// =======  NARZĘDZIA  =========================================
+// =============================================================
+
+static int64_t real_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000LL + ts.tv_nsec / 1000;
+}
+
+static void futex_czekaj(uint32_t* adres) {
+    while (__atomic_load_n(adres, __ATOMIC_ACQUIRE) == 0) {
+        syscall(SYS_futex, adres, FUTEX_WAIT, 0, nullptr, nullptr, 0);
+    }
+}
+
+static void futex_obudz(uint32_t* adres) {
+    __atomic_store_n(adres, 1, __ATOMIC_RELEASE);
+    syscall(SYS_futex, adres, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+// Blokada zegara jest odporna (PTHREAD_MUTEX_ROBUST): proces zabity
+// w środku sekcji nie zatrzymuje zegara na zawsze
+static void wez_blokade() {
+    if (pthread_mutex_lock(&zegar->blokada) == EOWNERDEAD) pthread_mutex_consistent(&zegar->blokada);
+}
+
+// Tablice za ZegarWirtualny: uczestnicy, kopiec pobudek, wolne sloty
+static void ustaw_tablice(void* tablice, int liczba) {
+    uczestnicy = (ZegarUczestnik*)tablice;
+    pobudki = (int*)(uczestnicy + liczba);
+    wolne = pobudki + liczba;
+}
+
+// =============================================================
+// =======  KOPIEC POBUDEK  ====================================
+// =============================================================
+//
+// Najbliższa pobudka na wierzchu bez przeglądania slotów. Przy równych
+// czasach wcześniej niższy slot - tę samą kolejność dawało przeglądanie.
+
+static bool wczesniej(int a, int b) {
+    int64_t pa = uczestnicy[a].pobudka_us;
+    int64_t pb = uczestnicy[b].pobudka_us;
+    return pa < pb || (pa == pb && a < b);
+}
+
+static void pobudka_na(int poz, int slot) {
+    pobudki[poz] = slot;
+    uczestnicy[slot].poz_pobudki = poz;
+}
+
+static void pobudka_w_gore(int poz) {
+    int slot = pobudki[poz];
+    while (poz > 0) {
+        int rodzic = (poz - 1) / 2;
+        if (!wczesniej(slot, pobudki[rodzic])) break;
+        pobudka_na(poz, pobudki[rodzic]);
+        poz = rodzic;
+    }
+    pobudka_na(poz, slot);
+}
+
+static void pobudka_w_dol(int poz) {
+    int slot = pobudki[poz];
+    int n = zegar->ile_pobudek;
+    while (true) {
+        int dziecko = 2 * poz + 1;
+        if (dziecko >= n) break;
+        if (dziecko + 1 < n && wczesniej(pobudki[dziecko + 1], pobudki[dziecko])) dziecko++;
+        if (!wczesniej(pobudki[dziecko], slot)) break;
+        pobudka_na(poz, pobudki[dziecko]);
+        poz = dziecko;
+    }
+    pobudka_na(poz, slot);
+}
+
+// Uczestnik z terminem (INT64_MAX = bez: nie trafia do kopca)
+static void dodaj_pobudke(int slot) {
+    if (uczestnicy[slot].pobudka_us == INT64_MAX) return;
+    int poz = zegar->ile_pobudek++;
+    pobudka_na(poz, slot);
+    pobudka_w_gore(poz);
+}
+
+static void usun_pobudke(int slot) {
+    int poz = uczestnicy[slot].poz_pobudki;
+    if (poz < 0) return;
+    uczestnicy[slot].poz_pobudki = -1;
+    int ostatni = pobudki[--zegar->ile_pobudek];
+    if (ostatni == slot) return;
+    pobudka_na(poz, ostatni);
+    pobudka_w_gore(poz);
+    pobudka_w_dol(uczestnicy[ostatni].poz_pobudki);
+}
+
+// Wyjęcie z kolejki semafora uczestnika, któremu minął termin
+static void usun_z_kolejki(int slot) {
+    int sem_num = uczestnicy[slot].sem_num;
+    int poprzedni = -1;
+    int i = zegar->sem_glowa[sem_num];
+    while (i != -1 && i != slot) {
+        poprzedni = i;
+        i = uczestnicy[i].nastepny;
+    }
+    if (i == -1) return;
+    int nastepny = uczestnicy[slot].nastepny;
+    if (poprzedni == -1) zegar->sem_glowa[sem_num] = nastepny;
+    else uczestnicy[poprzedni].nastepny = nastepny;
+    if (zegar->sem_ogon[sem_num] == slot) zegar->sem_ogon[sem_num] = poprzedni;
+}
+
+// Obudzony nie rusza od razu - staje na końcu kolejki gotowych
+static void obudz_uczestnika(int slot) {
+    ZegarUczestnik& u = uczestnicy[slot];
+    usun_pobudke(slot);
+    u.stan = UCZ_GOTOWY;
+    u.nastepny = -1;
+    if (zegar->gotowi_ogon == -1) zegar->gotowi_glowa = slot;
+    else uczestnicy[zegar->gotowi_ogon].nastepny = slot;
+    zegar->gotowi_ogon = slot;
+}
+
+static void uruchom_gotowego() {
+    int slot = zegar->gotowi_glowa;
+    ZegarUczestnik& u = uczestnicy[slot];
+    zegar->gotowi_glowa = u.nastepny;
+    if (zegar->gotowi_glowa == -1) zegar->gotowi_ogon = -1;
+    u.stan = UCZ_AKTYWNY;
+    zegar->aktywni++;
+    futex_obudz(&u.futex);
+}
+
+// Wywoływane pod blokadą, gdy nikt już nie pracuje: następny gotowy,
+// a bez gotowych przeskok do najbliższej pobudki (albo terminu czekania
+// na semaforze) i obudzenie wszystkich, którzy na nią czekają - w
+// kolejności slotów (kopiec pobudek), żeby przebieg był powtarzalny.
+static void przeskocz_czas() {
+    if (zegar->aktywni > 0) return;
+    if (zegar->gotowi_glowa != -1) {
+        uruchom_gotowego();
+        return;
+    }
+
+    // Nikt nie śpi - wszyscy czekają na semaforach (zakleszczenie) albo koniec
+    if (zegar->ile_pobudek == 0) return;
+
+    int64_t najblizsza = uczestnicy[pobudki[0]].pobudka_us;
+    if (najblizsza > zegar->teraz_us.load()) {
+        zegar->teraz_us.store(najblizsza);
+        zegar->przeskoki++;
+    }
+
+    while (zegar->ile_pobudek > 0 && uczestnicy[pobudki[0]].pobudka_us == najblizsza) {
+        int i = pobudki[0];
+        ZegarUczestnik& u = uczestnicy[i];
+        if (u.stan == UCZ_CZEKA) {
+            if (u.sem_num >= 0) usun_z_kolejki(i);
+            u.wynik = 0;
+        }
+        obudz_uczestnika(i);
+    }
+    if (zegar->gotowi_glowa != -1) uruchom_gotowego();
+}
+
+// Slot wraca do kopca wolnych (pod blokadą)
+static void zwolnij_slot(int slot) {
+    uczestnicy[slot].stan = UCZ_WOLNY;
+    wolne[zegar->ile_wolnych++] = slot;
+    std::push_heap(wolne, wolne + zegar->ile_wolnych, std::greater<int>());
+}
+
+// =============================================================
+// =======  API  ===============================================
+// =============================================================
+
+size_t zegar_rozmiar_tablic(int liczba) {
+    return (sizeof(ZegarUczestnik) + 2 * sizeof(int)) * liczba;
+}
+
+void zegar_init(ZegarWirtualny* z, int tryb, double predkosc, void* tablice, int liczba) {
+    zegar = z;
+    ustaw_tablice(tablice, liczba);
+    z->liczba_uczestnikow = liczba;
+    z->off_tablic = (char*)tablice - (char*)z;
+    z->tryb = tryb;
+    z->predkosc = (predkosc > 0) ? predkosc : 1.0;
+    z->start_real_us = real_us();
+    z->teraz_us.store(0);
+    z->przeskoki = 0;
+    z->aktywni = 0;
+    z->gotowi_glowa = -1;
+    z->gotowi_ogon = -1;
+
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_setpshared(&attr, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&attr, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&z->blokada, &attr);
+    pthread_mutexattr_destroy(&attr);
+
+    for (int i = 0; i < ZEGAR_MAX_SEMAFOROW; i++) {
+        z->sem_wartosc[i] = 0;
+        z->sem_glowa[i] = -1;
+        z->sem_ogon[i] = -1;
+    }
+    // Rosnące sloty to gotowy kopiec wolnych
+    for (int i = 0; i < liczba; i++) {
+        uczestnicy[i].stan = UCZ_WOLNY;
+        uczestnicy[i].nastepny = -1;
+        uczestnicy[i].futex = 0;
+        uczestnicy[i].poz_pobudki = -1;
+        wolne[i] = i;
+    }
+    z->ile_pobudek = 0;
+    z->ile_wolnych = liczba;
+}
+
+void zegar_podlacz(ZegarWirtualny* z) {
+    zegar = z;
+    ustaw_tablice((char*)z + z->off_tablic, z->liczba_uczestnikow);
+}
+
+bool zegar_wirtualny() {
+    return zegar != nullptr && zegar->tryb == ZEGAR_WIRTUALNY;
+}
+
+int64_t zegar_teraz_us() {
+    if (zegar == nullptr) return real_us();
+    if (zegar->tryb == ZEGAR_WIRTUALNY) return zegar->teraz_us.load();
+    return (int64_t)((real_us() - zegar->start_real_us) * zegar->predkosc);
+}
+
+void zegar_przestaw_us(int64_t teraz_us) {
+    zegar->teraz_us.store(teraz_us, std::memory_order_relaxed);
+}
+
+int zegar_zarejestruj() {
+    if (!zegar_wirtualny()) return 0;
+
+    int slot = -1;
+    wez_blokade();
+    if (zegar->ile_wolnych > 0) {
+        slot = wolne[0];
+        std::pop_heap(wolne, wolne + zegar->ile_wolnych--, std::greater<int>());
+        uczestnicy[slot].futex = 0;
+        uczestnicy[slot].sem_num = -1;
+        uczestnicy[slot].wynik = 0;
+        obudz_uczestnika(slot);
+        // Pierwszy (nadzorca) rusza od razu, kolejni po zaśnięciu bieżącego
+        przeskocz_czas();
+    }
+    pthread_mutex_unlock(&zegar->blokada);
+    return slot;
+}
+
+void zegar_start() {
+    if (!zegar_wirtualny() || zegar_slot < 0) return;
+    futex_czekaj(&uczestnicy[zegar_slot].futex);
+}
+
+void zegar_wyrejestruj(int slot) {
+    if (!zegar_wirtualny() || slot < 0) return;
+
+    wez_blokade();
+    if (uczestnicy[slot].stan == UCZ_AKTYWNY) zegar->aktywni--;
+    zwolnij_slot(slot);
+    przeskocz_czas();
+    pthread_mutex_unlock(&zegar->blokada);
+}
+
+int64_t zegar_realne_us(int64_t us_symulacji) {
+    double skala = (zegar != nullptr) ? zegar->predkosc : 1.0;
+    return (int64_t)(us_symulacji / skala);
+}
+
+void zegar_spij_us(int64_t us) {
+    if (us <= 0) return;
+
+    if (!zegar_wirtualny()) {
+        int64_t real = zegar_realne_us(us);
+        struct timespec ts = { (time_t)(real / 1000000), (long)(real % 1000000) * 1000 };
+        while (nanosleep(&ts, &ts) == -1 && errno == EINTR) {}
+        return;
+    }
+
+    ZegarUczestnik& ja = uczestnicy[zegar_slot];
+    wez_blokade();
+    ja.pobudka_us = zegar->teraz_us.load() + us;
+    ja.futex = 0;
+    ja.stan = UCZ_SPI;
+    ja.sem_num = -1;
+    dodaj_pobudke(zegar_slot);
+    zegar->aktywni--;
+    przeskocz_czas();
+    pthread_mutex_unlock(&zegar->blokada);
+
+    futex_czekaj(&ja.futex);
+}
+
+// =============================================================
+// =======  SEMAFORY WIRTUALNE (FIFO, przekazanie jednostki)  ==
+// =============================================================
+
+// Za ostatnim o priorytecie <= naszemu; przy samych FIFO (INT64_MAX)
+// to zawsze dopisanie na koniec, bez przeglądania kolejki
+static void wstaw_do_kolejki(int slot) {
+    ZegarUczestnik& ja = uczestnicy[slot];
+    int sem_num = ja.sem_num;
+    int ogon = zegar->sem_ogon[sem_num];
+    if (ogon == -1 || uczestnicy[ogon].priorytet <= ja.priorytet) {
+        ja.nastepny = -1;
+        if (ogon == -1) zegar->sem_glowa[sem_num] = slot;
+        else uczestnicy[ogon].nastepny = slot;
+        zegar->sem_ogon[sem_num] = slot;
+        return;
+    }
+    int poprzedni = -1;
+    int i = zegar->sem_glowa[sem_num];
+    while (uczestnicy[i].priorytet <= ja.priorytet) {
+        poprzedni = i;
+        i = uczestnicy[i].nastepny;
+    }
+    ja.nastepny = i;
+    if (poprzedni == -1) zegar->sem_glowa[sem_num] = slot;
+    else uczestnicy[poprzedni].nastepny = slot;
+}
+
+void zegar_sem_init(int sem_num, int wartosc) {
+    zegar->sem_wartosc[sem_num] = wartosc;
+    zegar->sem_glowa[sem_num] = -1;
+    zegar->sem_ogon[sem_num] = -1;
+}
+
+static bool sem_czekaj(int sem_num, int64_t termin_us, int64_t priorytet) {
+    ZegarUczestnik& ja = uczestnicy[zegar_slot];
+
+    wez_blokade();
+    if (zegar->sem_wartosc[sem_num] > 0) {
+        zegar->sem_wartosc[sem_num]--;
+        pthread_mutex_unlock(&zegar->blokada);
+        return true;
+    }
+    if (termin_us <= zegar->teraz_us.load()) {
+        pthread_mutex_unlock(&zegar->blokada);
+        return false;
+    }
+
+    // Wstawienie do kolejki; jednostkę przekaże nam sem_v,
+    // a jeśli wcześniej minie termin - przeskocz_czas wyjmie nas z kolejki
+    ja.futex = 0;
+    ja.stan = UCZ_CZEKA;
+    ja.sem_num = sem_num;
+    ja.pobudka_us = termin_us;
+    ja.priorytet = priorytet;
+    ja.wynik = 0;
+    wstaw_do_kolejki(zegar_slot);
+    dodaj_pobudke(zegar_slot);
+
+    zegar->aktywni--;
+    przeskocz_czas();
+    pthread_mutex_unlock(&zegar->blokada);
+
+    futex_czekaj(&ja.futex);
+    return ja.wynik == 1;
+}
+
+void zegar_sem_p(int sem_num) {
+    zegar_sem_p_do(sem_num, INT64_MAX);
+}
+
+bool zegar_sem_p_do(int sem_num, int64_t termin_us) {
+    return sem_czekaj(sem_num, termin_us, INT64_MAX);
+}
+
+void zegar_sem_p_prio(int sem_num, int64_t priorytet) {
+    sem_czekaj(sem_num, INT64_MAX, priorytet);
+}
+
+// Pod blokadą: jednostka dla pierwszego w kolejce albo z powrotem do puli
+static void oddaj_jednostke(int sem_num) {
+    int glowa = zegar->sem_glowa[sem_num];
+    if (glowa == -1) {
+        zegar->sem_wartosc[sem_num]++;
+    } else {
+        zegar->sem_glowa[sem_num] = uczestnicy[glowa].nastepny;
+        if (zegar->sem_glowa[sem_num] == -1) zegar->sem_ogon[sem_num] = -1;
+        uczestnicy[glowa].wynik = 1;
+        obudz_uczestnika(glowa);
+    }
+}
+
+void zegar_sem_v(int sem_num) {
+    wez_blokade();
+    oddaj_jednostke(sem_num);
+    pthread_mutex_unlock(&zegar->blokada);
+}
+
+bool zegar_sem_sprobuj(int sem_num) {
+    wez_blokade();
+    bool jest = zegar->sem_wartosc[sem_num] > 0;
+    if (jest) zegar->sem_wartosc[sem_num]--;
+    pthread_mutex_unlock(&zegar->blokada);
+    return jest;
+}
+
+// Wyjęcie z kolejki gotowych (uczestnik mógł już do niej trafić)
+static void usun_z_gotowych(int slot) {
+    int poprzedni = -1;
+    int i = zegar->gotowi_glowa;
+    while (i != -1 && i != slot) {
+        poprzedni = i;
+        i = uczestnicy[i].nastepny;
+    }
+    if (i == -1) return;
+    int nastepny = uczestnicy[slot].nastepny;
+    if (poprzedni == -1) zegar->gotowi_glowa = nastepny;
+    else uczestnicy[poprzedni].nastepny = nastepny;
+    if (zegar->gotowi_ogon == slot) zegar->gotowi_ogon = poprzedni;
+}
+
+void zegar_usun(int slot) {
+    if (!zegar_wirtualny() || slot < 0) return;
+
+    wez_blokade();
+    ZegarUczestnik& u = uczestnicy[slot];
+    // Zabity już po zegar_wyrejestruj
+    if (u.stan == UCZ_WOLNY) {
+        pthread_mutex_unlock(&zegar->blokada);
+        return;
+    }
+    usun_pobudke(slot);
+    if (u.stan == UCZ_AKTYWNY) {
+        zegar->aktywni--;
+    } else if (u.stan == UCZ_CZEKA) {
+        if (u.sem_num >= 0) usun_z_kolejki(slot);
+    } else if (u.stan == UCZ_GOTOWY) {
+        usun_z_gotowych(slot);
+        // Przekazanej jednostki nikt już nie odbierze
+        if (u.sem_num >= 0 && u.wynik == 1) oddaj_jednostke(u.sem_num);
+    }
+    zwolnij_slot(slot);
+    przeskocz_czas();
+    pthread_mutex_unlock(&zegar->blokada);
+}
+
+// =============================================================
+// =======  CZEKANIE NA FLAGĘ (kolejki poza zegarem)  ==========
+// =============================================================
+
+static bool futex_czekaj_na(std::atomic<uint32_t>* flaga, int64_t termin_us) {
+    while (flaga->load(std::memory_order_acquire) == 0) {
+        if (termin_us == INT64_MAX) {
+            syscall(SYS_futex, flaga, FUTEX_WAIT, 0, nullptr, nullptr, 0);
+            continue;
+        }
+        int64_t zostalo = zegar_realne_us(termin_us - zegar_teraz_us());
+        if (zostalo <= 0) return false;
+        struct timespec ts = { (time_t)(zostalo / 1000000), (long)(zostalo % 1000000) * 1000 };
+        syscall(SYS_futex, flaga, FUTEX_WAIT, 0, &ts, nullptr, 0);
+    }
+    return true;
+}
+
+// Wirtualny: flaga sprawdzana i ustawiana pod blokadą zegara - pobudka nie zginie
+bool zegar_czekaj_na(std::atomic<uint32_t>* flaga, int64_t termin_us) {
+    if (!zegar_wirtualny()) return futex_czekaj_na(flaga, termin_us);
+
+    ZegarUczestnik& ja = uczestnicy[zegar_slot];
+
+    wez_blokade();
+    if (flaga->load() != 0) {
+        pthread_mutex_unlock(&zegar->blokada);
+        return true;
+    }
+    if (termin_us <= zegar->teraz_us.load()) {
+        pthread_mutex_unlock(&zegar->blokada);
+        return false;
+    }
+    ja.futex = 0;
+    ja.stan = UCZ_CZEKA;
+    ja.sem_num = -1;
+    ja.pobudka_us = termin_us;
+    ja.wynik = 0;
+    dodaj_pobudke(zegar_slot);
+
+    zegar->aktywni--;
+    przeskocz_czas();
+    pthread_mutex_unlock(&zegar->blokada);
+
+    futex_czekaj(&ja.futex);
+    return flaga->load() != 0;
+}
+
+void zegar_obudz(int slot, std::atomic<uint32_t>* flaga) {
+    if (!zegar_wirtualny()) {
+        flaga->store(1, std::memory_order_release);
+        syscall(SYS_futex, flaga, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+        return;
+    }
+
+    wez_blokade();
+    flaga->store(1);
+    ZegarUczestnik& u = uczestnicy[slot];
+    if (u.stan == UCZ_CZEKA && u.sem_num == -1) {
+        u.wynik = 1;
+        obudz_uczestnika(slot);
+    }
+    pthread_mutex_unlock(&zegar->blokada);
+}
@@ -0,0 +1,138 @@
+#ifndef ZEGAR_H
+#define ZEGAR_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <pthread.h>
+
+// =============================================================
+// =======  ZEGAR SYMULACJI (REALNY / PRZYSPIESZONY / WIRTUALNY)
+// =============================================================
+//
+// Wszystkie opóźnienia w symulacji (lądowanie, tankowanie, boarding,
+// dostawa paliwa, takt pętli głównej) przechodzą przez zegar_spij_us().
+//
+//  - ZEGAR_REALNY        : zwykły sen, czas ścienny (tryb z GUI).
+//  - ZEGAR_PRZYSPIESZONY : sen skrócony N razy (--speed=N).
+//  - ZEGAR_WIRTUALNY     : brak snu; gdy żaden proces nie jest gotowy do
+//                          działania, zegar przeskakuje do najbliższej
+//                          pobudki (--max-speed).
+//
+// W trybie wirtualnym zegar musi wiedzieć, czy ktokolwiek jeszcze
+// "pracuje", dlatego semafory zasobów (gate, cysterna, kołowanie) są
+// wtedy obsługiwane tutaj, a nie przez semop. Kolejki prowadzone poza
+// zegarem (wieża, wieza.h) usypiają czekającego przez zegar_czekaj_na.
+//
+// Tryb wirtualny jest deterministyczny: naraz działa jeden uczestnik.
+// Obudzeni (pobudka, przekazana jednostka semafora, nowy proces) stają
+// w kolejce gotowych i ruszają po kolei, gdy bieżący zaśnie. Przy tym
+// samym ziarnie (losowanie.h) przebieg powtarza się co do bitu.
+
+// Tablica uczestników leży poza ZegarWirtualny (zegar_init), o długości
+// z konfiguracji; tu tylko górna granica - więcej procesów i tak nie
+// powstanie przy domyślnym pid_max
+#define ZEGAR_MAX_UCZESTNIKOW 32768
+#define ZEGAR_MAX_SEMAFOROW 8
+
+enum TrybZegara {
+    ZEGAR_REALNY = 0,
+    ZEGAR_PRZYSPIESZONY = 1,
+    ZEGAR_WIRTUALNY = 2
+};
+
+enum StanUczestnika {
+    UCZ_WOLNY = 0,   // Slot nieużywany
+    UCZ_AKTYWNY,     // Proces działa
+    UCZ_SPI,         // Czeka na pobudkę o czasie pobudka_us
+    UCZ_CZEKA,       // Czeka w kolejce semafora
+    UCZ_GOTOWY       // Obudzony, czeka na swoją kolej (kolejka gotowych)
+};
+
+struct ZegarUczestnik {
+    int stan;
+    int64_t pobudka_us;      // UCZ_CZEKA: termin rezygnacji (INT64_MAX = bez)
+    int nastepny;            // Następny w kolejce semafora albo gotowych (-1 = koniec)
+    int sem_num;             // Semafor, w którego kolejce stoi (-1 = zegar_czekaj_na)
+    int wynik;               // 1 = dostał jednostkę, 0 = minął termin
+    int64_t priorytet;       // Miejsce w kolejce: mniejszy wcześniej, równe FIFO
+    uint32_t futex;          // 0 = śpij, 1 = obudzony
+    int poz_pobudki;         // Miejsce w kopcu pobudek (-1 = poza nim)
+};
+
+struct ZegarWirtualny {
+    int tryb;
+    double predkosc;
+    int64_t start_real_us;
+
+    std::atomic<int64_t> teraz_us;   // Czas symulacji
+    long long przeskoki;             // Ile razy zegar przeskoczył
+
+    pthread_mutex_t blokada;         // Chroni wszystko poniżej
+    int aktywni;                     // Procesy w stanie UCZ_AKTYWNY (wirtualny: 0 albo 1)
+    int gotowi_glowa;                // Kolejka UCZ_GOTOWY (FIFO)
+    int gotowi_ogon;
+
+    int sem_wartosc[ZEGAR_MAX_SEMAFOROW];
+    int sem_glowa[ZEGAR_MAX_SEMAFOROW];
+    int sem_ogon[ZEGAR_MAX_SEMAFOROW];
+
+    // Kopiec pobudek: śpiący i czekający z terminem według (pobudka_us,
+    // slot); kopiec wolnych slotów: najniższy pierwszy
+    int ile_pobudek;
+    int ile_wolnych;
+
+    int liczba_uczestnikow;
+    size_t off_tablic;               // Tablice uczestników i kopce (od początku ZegarWirtualny)
+};
+
+// Slot zegara bieżącego procesu (dziedziczony przez fork, nadpisywany w dziecku)
+extern int zegar_slot;
+
+// Miejsce na tablice dla liczba uczestników (zegar_init)
+size_t zegar_rozmiar_tablic(int liczba);
+// tablice: zegar_rozmiar_tablic(liczba) bajtów w tym samym segmencie co z
+void zegar_init(ZegarWirtualny* z, int tryb, double predkosc, void* tablice, int liczba);
+void zegar_podlacz(ZegarWirtualny* z);
+
+int64_t zegar_teraz_us();
+bool zegar_wirtualny();
+
+// Czas wirtualny ustawiany z zewnątrz - silnik zdarzeń (zdarzenia.h)
+// sam wybiera następną chwilę, bez uczestników zegara
+void zegar_przestaw_us(int64_t teraz_us);
+
+// Rejestracja przed fork(): nowy proces od razu liczy się jako aktywny
+// albo gotowy. Zwraca -1, gdy brak wolnych slotów (tylko tryb wirtualny;
+// nadzorca nie dopuszcza do tego, ustal_pojemnosc w main.cpp).
+int zegar_zarejestruj();
+// Pierwsze wywołanie w dziecku po fork(): czeka na swoją kolej
+void zegar_start();
+void zegar_wyrejestruj(int slot);
+// Wyrejestrowanie za proces zabity w dowolnym miejscu (woła nadzorca):
+// wyjmuje slot z kolejek, a jednostkę semafora przekazaną, lecz
+// nieodebraną, oddaje następnemu
+void zegar_usun(int slot);
+
+void zegar_spij_us(int64_t us);
+
+// Czas symulacji -> czas rzeczywisty (tryby inne niż wirtualny)
+int64_t zegar_realne_us(int64_t us_symulacji);
+
+void zegar_sem_init(int sem_num, int wartosc);
+void zegar_sem_p(int sem_num);
+// Jak zegar_sem_p, ale rezygnuje o czasie termin_us; false = nie dostał
+bool zegar_sem_p_do(int sem_num, int64_t termin_us);
+// Kolejka według priorytetu zamiast przybycia (mniejszy dostaje pierwszy)
+void zegar_sem_p_prio(int sem_num, int64_t priorytet);
+void zegar_sem_v(int sem_num);
+// Jednostka bez czekania; false = brak wolnej
+bool zegar_sem_sprobuj(int sem_num);
+
+// Czekanie na flagę ustawianą przez zegar_obudz() innego procesu albo
+// do terminu (INT64_MAX = bez); false = minął termin, a flagi nikt nie
+// ustawił. W zegarze wirtualnym przez kolejkę zegara, w pozostałych futex.
+bool zegar_czekaj_na(std::atomic<uint32_t>* flaga, int64_t termin_us);
+void zegar_obudz(int slot, std::atomic<uint32_t>* flaga);
+
+#endif